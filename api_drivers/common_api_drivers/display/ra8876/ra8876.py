@@ -6,6 +6,7 @@ import machine  # NOQA
 
 import lvgl as lv
 import lcd_bus  # NOQA
+import lcd_utils  # NOQA
 import display_driver_framework
 
 
@@ -180,17 +181,43 @@ class RA8876(display_driver_framework.DisplayDriver):
         color_byte_order=BYTE_ORDER_RGB,
         rgb565_byte_swap=False,
         wait_pin=None,
-        wait_state=STATE_HIGH
+        wait_state=STATE_HIGH,
+        wait_irq=False
     ):
 
         if not isinstance(data_bus, lcd_bus.I80Bus):
             raise RuntimeError('Only the I8080 bus is supported by the driver')
 
-        if wait_pin is None:
+        if wait_pin in (None, -1):
+            if wait_irq:
+                raise RuntimeError('wait_irq needs the wait pin')
+
             self._wait_pin = None
+            self._waiter = None
         else:
-            self._wait_pin = machine.Pin(wait_pin, machine.Pin.IN)
+            if not isinstance(wait_pin, int):
+                self._wait_pin = wait_pin
+            else:
+                self._wait_pin = machine.Pin(wait_pin, machine.Pin.IN)
+
+            self._waiter = lcd_utils.WaitPin(self._wait_pin, wait_state)
+
+            if wait_irq:
+                # the edge only wakes up _wait, the pin level is what gets
+                # checked
+                pin = self._wait_pin
+                trigger = pin.IRQ_RISING if wait_state else pin.IRQ_FALLING
+
+                try:
+                    pin.irq(handler=self._waiter.irq, trigger=trigger, hard=True)
+                except TypeError:
+                    # io expander pins and ports that don't have hard interrupts
+                    pin.irq(self._waiter.irq, trigger)
+
         self._wait_state = wait_state
+        self._wait_irq = wait_irq
+        self._pending_flush = None
+        self._flushing = False
 
         super().__init__(
             data_bus=data_bus,
@@ -211,6 +238,9 @@ class RA8876(display_driver_framework.DisplayDriver):
             rgb565_byte_swap=rgb565_byte_swap
         )
 
+        if wait_irq:
+            self._disp_drv.set_flush_wait_cb(self._flush_wait_cb)
+
     def set_invert_colors(self, value):
         raise NotImplementedError
 
@@ -223,14 +253,30 @@ class RA8876(display_driver_framework.DisplayDriver):
         raise NotImplementedError
 
     def _wait(self):
-        if self._wait_pin is not None:
-            start_time = time.ticks_ms()  # NOQA
-
-            while (
-                self._wait_pin.value() != self._wait_state and
-                time.ticks_diff(time.ticks_ms(), start_time) < self.WAIT_TIMEOUT  # NOQA
-            ):
-                time.sleep_ms(1)  # NOQA
+        # the wait is done in C and pending callbacks keep running while it
+        # waits, with wait_irq the wait pin's edge ends the wait right away
+        if self._waiter is not None:
+            self._waiter.wait(self.WAIT_TIMEOUT)
+
+    def _flush_wait_cb(self, _):
+        # LVGL calls this in place of spinning on its flushing flag and it
+        # clears the flag once this returns. A flush that _flush_cb held back
+        # gets sent as soon as the controller is ready, then this spins until
+        # the bus has let go of the buffer the same way LVGL would have.
+        args = self._pending_flush
+
+        if args is not None:
+            self._pending_flush = None
+            self._wait()
+            self._data_bus.tx_color(*args)
+
+        while self._flushing:
+            pass
+
+    def _flush_ready_cb(self, *_):
+        # this can get called from the bus driver's interrupt
+        self._flushing = False
+        self._disp_drv.flush_ready()
 
     def reset(self):
         if self._reset_pin is None:
@@ -549,8 +595,6 @@ class RA8876(display_driver_framework.DisplayDriver):
         display_driver_framework.DisplayDriver.init(self)
 
     def _set_memory_location(self, x_start, y_start, x_end, y_end):
-
-        print(x_start, y_start, x_end, y_end)
         buf = self._param_buf
         mv = self._param_mv[:1]
 
@@ -585,3 +629,44 @@ class RA8876(display_driver_framework.DisplayDriver):
         self.set_params(_CURV1, mv)
 
         return _MRWDP
+
+    def _flush_cb(self, _, area, color_p):
+        x1 = area.x1 + self._offset_x
+        x2 = area.x2 + self._offset_x
+
+        y1 = area.y1 + self._offset_y
+        y2 = area.y2 + self._offset_y
+
+        size = (
+            (x2 - x1 + 1) *
+            (y2 - y1 + 1) *
+            lv.color_format_get_size(self._color_space)
+        )
+
+        # the window gets set up first, only the pixel data has to wait
+        # for the controller to finish with the last block
+        cmd = self._set_memory_location(x1, y1, x2, y2)
+
+        # we have to use the __dereference__ method because this method is
+        # what converts from the C_Array object the binding passes into a
+        # memoryview object that can be passed to the bus drivers
+        data_view = color_p.__dereference__(size)
+
+        args = (cmd, data_view, x1, y1, x2, y2, self._rotation,
+                self._disp_drv.flush_is_last())
+
+        self._flushing = True
+
+        if (
+            self._wait_irq and
+            not args[-1] and
+            not self._waiter.ready()
+        ):
+            # the controller is still busy, LVGL goes on rendering the next
+            # area and the pixel data gets sent from _flush_wait_cb. The last
+            # area of a refresh is never held back so nothing is left over
+            # once the refresh is done.
+            self._pending_flush = args
+        else:
+            self._wait()
+            self._data_bus.tx_color(*args)
@@ -21,6 +21,12 @@
 
     #define MP_MACHINE_I2C_FLAG_WRITE2   (0x08)
 
+    // segment flags for Device.transaction
+    #define I2C_SEGMENT_WRITE   (0x00)
+    #define I2C_SEGMENT_READ    (0x01)
+    #define I2C_SEGMENT_STOP    (0x02)
+    #define I2C_MAX_SEGMENTS    (8)
+
     #if CONFIG_IDF_TARGET_ESP32C3 || CONFIG_IDF_TARGET_ESP32C6 || CONFIG_IDF_TARGET_ESP32S3
         #define SCLK_I2C_FREQ XTAL_CLK_FREQ
     #elif CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
@@ -194,6 +200,72 @@
     }
 
 
+    /* Runs a list of write and read segments as a single command link, so the
+     * bus lock is taken once and the driver gets called once. A START and the
+     * address byte are only sent when the direction changes or after a
+     * segment that has I2C_SEGMENT_STOP set, back to back segments in the same
+     * direction continue the same message. There is always a STOP at the end.
+     */
+    static int i2c_bus_transfer_segments(mp_machine_hw_i2c_bus_obj_t *self, uint16_t addr, size_t n,
+                                         mp_machine_i2c_buf_t *bufs, const uint8_t *seg_flags)
+    {
+        if (self->active == 0) return -MP_ENODEV;
+
+        if (self->use_locks == 1) I2C_BUS_LOCK_ACQUIRE(self);
+
+        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+        int data_len = 0;
+        int last_dir = -1;
+
+        for (size_t i = 0; i < n; i++) {
+            int dir = seg_flags[i] & I2C_SEGMENT_READ;
+            bool stop = (i == n - 1) || (seg_flags[i] & I2C_SEGMENT_STOP);
+
+            if (dir != last_dir) {
+                i2c_master_start(cmd);
+                i2c_master_write_byte(cmd, addr << 1 | dir, true);
+            }
+
+            if (bufs[i].len != 0) {
+                if (dir) {
+                    // the last byte of a read gets a NACK unless the next
+                    // segment keeps reading in the same message
+                    bool more = !stop && (seg_flags[i + 1] & I2C_SEGMENT_READ);
+                    i2c_master_read(cmd, bufs[i].buf, bufs[i].len,
+                                    more ? I2C_MASTER_ACK : I2C_MASTER_LAST_NACK);
+                } else {
+                    i2c_master_write(cmd, bufs[i].buf, bufs[i].len, true);
+                }
+            }
+
+            data_len += bufs[i].len;
+
+            if (stop) {
+                i2c_master_stop(cmd);
+                last_dir = -1;
+            } else {
+                last_dir = dir;
+            }
+        }
+
+        esp_err_t err = i2c_master_cmd_begin(self->port, cmd,
+                                100 * (1 + data_len) / portTICK_PERIOD_MS);
+        i2c_cmd_link_delete(cmd);
+
+        if (self->use_locks == 1) I2C_BUS_LOCK_RELEASE(self);
+
+        if (err == ESP_FAIL) {
+            return -MP_ENODEV;
+        } else if (err == ESP_ERR_TIMEOUT) {
+            return -MP_ETIMEDOUT;
+        } else if (err != ESP_OK) {
+            return -abs(err);
+        }
+
+        return data_len;
+    }
+
+
     static void i2c_bus_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
     {
         mp_machine_hw_i2c_bus_obj_t *self = MP_OBJ_TO_PTR(self_in);
@@ -527,6 +599,51 @@
     static MP_DEFINE_CONST_FUN_OBJ_KW(i2c_device_write_mem_obj, 3, i2c_device_write_mem);
 
 
+    // transaction([(flags, buf), ...])
+    // The buffers are used as they are, nothing gets allocated so the segment
+    // list can be built once and reused for every read.
+    static mp_obj_t i2c_device_transaction(mp_obj_t self_in, mp_obj_t segments_in)
+    {
+        mp_machine_hw_i2c_device_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+        size_t n;
+        mp_obj_t *segments;
+        mp_obj_get_array(segments_in, &n, &segments);
+
+        if (n == 0) return mp_const_none;
+
+        if (n > I2C_MAX_SEGMENTS) {
+            RAISE_VALUE_ERROR("a maximum of %d segments is supported", I2C_MAX_SEGMENTS);
+        }
+
+        mp_machine_i2c_buf_t bufs[I2C_MAX_SEGMENTS];
+        uint8_t seg_flags[I2C_MAX_SEGMENTS];
+
+        for (size_t i = 0; i < n; i++) {
+            mp_obj_t *segment;
+            mp_obj_get_array_fixed_n(segments[i], 2, &segment);
+
+            seg_flags[i] = (uint8_t)mp_obj_get_int(segment[0]);
+
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(segment[1], &bufinfo,
+                    (seg_flags[i] & I2C_SEGMENT_READ) ? MP_BUFFER_WRITE : MP_BUFFER_READ);
+
+            bufs[i].buf = (uint8_t *)bufinfo.buf;
+            bufs[i].len = bufinfo.len;
+        }
+
+        if (self->bus == NULL) mp_raise_OSError(1);
+
+        int ret = i2c_bus_transfer_segments(self->bus, self->device_id, n, bufs, seg_flags);
+
+        if (ret < 0) mp_raise_OSError(-ret);
+        return mp_const_none;
+    }
+
+    static MP_DEFINE_CONST_FUN_OBJ_2(i2c_device_transaction_obj, i2c_device_transaction);
+
+
     static mp_obj_t i2c_device_read(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
     {
         enum { ARG_self, ARG_num_bytes, ARG_buf };
@@ -641,6 +758,10 @@
         { MP_ROM_QSTR(MP_QSTR_write_mem),      MP_ROM_PTR(&i2c_device_write_mem_obj)      },
         { MP_ROM_QSTR(MP_QSTR_read),           MP_ROM_PTR(&i2c_device_read_obj)           },
         { MP_ROM_QSTR(MP_QSTR_write),          MP_ROM_PTR(&i2c_device_write_obj)          },
+        { MP_ROM_QSTR(MP_QSTR_transaction),    MP_ROM_PTR(&i2c_device_transaction_obj)    },
+        { MP_ROM_QSTR(MP_QSTR_WRITE),          MP_ROM_INT(I2C_SEGMENT_WRITE)              },
+        { MP_ROM_QSTR(MP_QSTR_READ),           MP_ROM_INT(I2C_SEGMENT_READ)               },
+        { MP_ROM_QSTR(MP_QSTR_STOP),           MP_ROM_INT(I2C_SEGMENT_STOP)               },
         { MP_ROM_QSTR(MP_QSTR___del__),        MP_ROM_PTR(&i2c_device_deinit_obj)         }
     };
 
@@ -1,30 +1,40 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
 import lvgl as lv
+import fusion
 
 
 class AutoRotation:
 
-    def __init__(self, device, delay, lock_rotation=False, adjustment=0.0):
+    # hysteresis is how many degrees past the 45 degree boundary the device
+    # has to be tilted and dwell is how many milliseconds it has to stay there
+    # before the display gets rotated.
+    def __init__(self, device, delay, lock_rotation=False, adjustment=0.0,
+                 hysteresis=15.0, dwell=300):
 
         if adjustment > 180 or adjustment < -180:
             raise ValueError('adjustment range is -180.0 to +180.0')
 
-        scrn = lv.screen_active()
-        disp = scrn.get_display()
+        disp = lv.screen_active().get_display()
 
         self._device = device
+        self._disp = disp
 
-        self._timer = lv.timer_create(self._timer_cb, delay)
-        self._timer.set_repeat_count(-1)
-
-        self._fusion = fusion.Fusion()
         self._lock_rotation = lock_rotation
 
         self._last_rotation = disp.get_rotation()
         self._last_free_rotation = 0
         self._adjustment = adjustment
 
+        # the quadrant selection runs in C and only calls back into Python
+        # once a new rotation has been confirmed
+        self._tracker = fusion.OrientationTracker(
+            callback=self._on_rotation, hysteresis=hysteresis, dwell=dwell,
+            adjustment=adjustment, rotation=self._last_rotation)
+
+        self._timer = lv.timer_create(self._timer_cb, delay)
+        self._timer.set_repeat_count(-1)
+
     @property
     def adjustment(self):
         return self._adjustment
@@ -32,6 +42,7 @@ class AutoRotation:
     @adjustment.setter
     def adjustment(self, value):
         self._adjustment = value
+        self._tracker.set_adjustment(value)
         self._timer_cb(None)
 
     @property
@@ -47,9 +58,17 @@ class AutoRotation:
         if self._timer is not None:
             self._timer.delete()
 
+    def _on_rotation(self, rotation):
+        self._last_rotation = rotation
+        self._disp.set_rotation(rotation)
+
     def _timer_cb(self, _):
         roll, pitch, yaw = self._device.read()
 
+        if self._lock_rotation:
+            self._tracker.update(roll)
+            return
+
         roll += self._adjustment
 
         if roll > 180.00:
@@ -61,59 +80,44 @@ class AutoRotation:
         if roll < 0.0:
             roll += 360.0
 
-        scrn = lv.screen_active()
-        disp = scrn.get_display()
-
-        if self._lock_rotation:
-
-            if 45 <= roll < 135:
-                new_rotation = lv.DISPLAY_ROTATION._90
-
-            elif 135 <= roll < 225:
-                new_rotation = lv.DISPLAY_ROTATION._180
-
-            elif 225 <= roll < 315:
-                new_rotation = lv.DISPLAY_ROTATION._270
-
-            else:
-                new_rotation = lv.DISPLAY_ROTATION._0
-
-            if new_rotation != self._last_rotation:
-                self._last_rotation = new_rotation
-                disp.set_rotation(new_rotation)
-        else:
-            roll = int(roll * 10.0)
-
-            if self._last_rotation != lv.DISPLAY_ROTATION._0:
-                self._last_rotation = lv.DISPLAY_ROTATION._0
-                disp.set_rotation(lv.DISPLAY_ROTATION._0)
-
-            if roll != self._last_free_rotation:
-                self._last_free_rotation = roll
-                top_layer = disp.get_layer_top()
-                sys_layer = disp.get_layer_sys()
-                bottom_layer = disp.get_layer_bottom()
-
-                top_layer_pivot_x = int(top_layer.get_width() / 2)
-                top_layer_pivot_y = int(top_layer.get_height() / 2)
-                top_layer.set_style_transform_pivot_x(top_layer_pivot_x, lv.PART.ANY)
-                top_layer.set_style_transform_pivot_y(top_layer_pivot_y, lv.PART.ANY)
-                top_layer.set_style_transform_rotation(roll, lv.PART.ANY)
-
-                sys_layer_pivot_x = int(sys_layer.get_width() / 2)
-                sys_layer_pivot_y = int(sys_layer.get_height() / 2)
-                sys_layer.set_style_transform_pivot_x(sys_layer_pivot_x, lv.PART.ANY)
-                sys_layer.set_style_transform_pivot_y(sys_layer_pivot_y, lv.PART.ANY)
-                sys_layer.set_style_transform_rotation(roll, lv.PART.ANY)
-
-                bottom_layer_pivot_x = int(bottom_layer.get_width() / 2)
-                bottom_layer_pivot_y = int(bottom_layer.get_height() / 2)
-                bottom_layer.set_style_transform_pivot_x(bottom_layer_pivot_x, lv.PART.ANY)
-                bottom_layer.set_style_transform_pivot_y(bottom_layer_pivot_y, lv.PART.ANY)
-                bottom_layer.set_style_transform_rotation(roll, lv.PART.ANY)
-
-                scrn_pivot_x = int(scrn.get_width() / 2)
-                scrn_pivot_y = int(scrn.get_height() / 2)
-                scrn.set_style_transform_pivot_x(scrn_pivot_x, lv.PART.ANY)
-                scrn.set_style_transform_pivot_y(scrn_pivot_y, lv.PART.ANY)
-                scrn.set_style_transform_rotation(roll, lv.PART.ANY)
+        disp = self._disp
+        # not kept between ticks, a screen that has been loaded since the
+        # last one has to be the one that gets rotated
+        scrn = disp.get_screen_active()
+
+        roll = int(roll * 10.0)
+
+        if self._last_rotation != lv.DISPLAY_ROTATION._0:
+            self._last_rotation = lv.DISPLAY_ROTATION._0
+            self._tracker.set_rotation(lv.DISPLAY_ROTATION._0)
+            disp.set_rotation(lv.DISPLAY_ROTATION._0)
+
+        if roll != self._last_free_rotation:
+            self._last_free_rotation = roll
+            top_layer = disp.get_layer_top()
+            sys_layer = disp.get_layer_sys()
+            bottom_layer = disp.get_layer_bottom()
+
+            top_layer_pivot_x = int(top_layer.get_width() / 2)
+            top_layer_pivot_y = int(top_layer.get_height() / 2)
+            top_layer.set_style_transform_pivot_x(top_layer_pivot_x, lv.PART.ANY)
+            top_layer.set_style_transform_pivot_y(top_layer_pivot_y, lv.PART.ANY)
+            top_layer.set_style_transform_rotation(roll, lv.PART.ANY)
+
+            sys_layer_pivot_x = int(sys_layer.get_width() / 2)
+            sys_layer_pivot_y = int(sys_layer.get_height() / 2)
+            sys_layer.set_style_transform_pivot_x(sys_layer_pivot_x, lv.PART.ANY)
+            sys_layer.set_style_transform_pivot_y(sys_layer_pivot_y, lv.PART.ANY)
+            sys_layer.set_style_transform_rotation(roll, lv.PART.ANY)
+
+            bottom_layer_pivot_x = int(bottom_layer.get_width() / 2)
+            bottom_layer_pivot_y = int(bottom_layer.get_height() / 2)
+            bottom_layer.set_style_transform_pivot_x(bottom_layer_pivot_x, lv.PART.ANY)
+            bottom_layer.set_style_transform_pivot_y(bottom_layer_pivot_y, lv.PART.ANY)
+            bottom_layer.set_style_transform_rotation(roll, lv.PART.ANY)
+
+            scrn_pivot_x = int(scrn.get_width() / 2)
+            scrn_pivot_y = int(scrn.get_height() / 2)
+            scrn.set_style_transform_pivot_x(scrn_pivot_x, lv.PART.ANY)
+            scrn.set_style_transform_pivot_y(scrn_pivot_y, lv.PART.ANY)
+            scrn.set_style_transform_rotation(roll, lv.PART.ANY)
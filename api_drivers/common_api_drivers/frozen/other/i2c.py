@@ -82,6 +82,10 @@ class I2C(object):
             self._bus.writeto_mem(addr, memaddr, buf, addrsize=addrsize)
 
     class Device(object):
+        # segment flags for transaction()
+        WRITE = 0x00
+        READ = 0x01
+        STOP = 0x02
 
         def __init__(self, bus, dev_id, reg_bits=8):
             self._bus = bus
@@ -132,3 +136,23 @@ class I2C(object):
 
         def write(self, buf):
             self._bus.writeto(self.dev_id, buf)
+
+        def transaction(self, segments):
+            # segments is a sequence of (flags, buf) that gets run with the
+            # bus lock held the whole time. Every segment is its own message,
+            # a repeated start is used between them unless STOP is set in the
+            # flags. The last segment always ends with a stop. READ segments
+            # are read into the buffer that is passed.
+            bus = self._bus._bus  # NOQA
+            dev_id = self.dev_id
+            last = len(segments) - 1
+
+            with self._bus:
+                for i in range(last + 1):
+                    flags, buf = segments[i]
+                    stop = i == last or bool(flags & self.STOP)
+
+                    if flags & self.READ:
+                        bus.readfrom_into(dev_id, buf, stop)
+                    else:
+                        bus.writeto(dev_id, buf, stop)
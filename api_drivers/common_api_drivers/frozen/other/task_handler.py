@@ -36,7 +36,9 @@ class TaskHandler(object):
         duration=33,
         timer_id=_default_timer_id,
         max_scheduled=2,
-        exception_hook=_default_exception_hook
+        exception_hook=_default_exception_hook,
+        boost_period=10,
+        boost_hold=250
     ):
         if TaskHandler._current_instance is not None:
             self.__dict__.update(TaskHandler._current_instance.__dict__)
@@ -51,6 +53,12 @@ class TaskHandler(object):
             self.duration = duration
             self.exception_hook = exception_hook
 
+            # see boost()
+            self._period = duration
+            self._boost_period = min(boost_period, duration)
+            self._boost_hold = boost_hold
+            self._boost_until = 0
+
             self._timer = Timer(timer_id)
 
             # Allocation occurs here
@@ -87,7 +95,66 @@ class TaskHandler(object):
                 self._callbacks.remove((cb,evt,data))
                 break
 
+    def set_boost(self, period=10, hold=250):
+        # period: the shortest refresh/read period in milliseconds while
+        #         boosted. It is never longer than duration.
+        # hold: milliseconds the boost is held after the last call to boost()
+        #       before it starts to decay back to duration.
+        self._boost_period = min(period, self.duration)
+        self._boost_hold = hold
+
+    def boost(self):
+        # Called by the input drivers while there is input. The task handler,
+        # the display refresh timers and the indev read timers are sped up to
+        # the boost period. Once the hold time runs out the period doubles on
+        # every run of the task handler until it is back to duration.
+        self._boost_until = time.ticks_add(time.ticks_ms(), self._boost_hold)  # NOQA
+
+        if self._period != self._boost_period:
+            self._set_period(self._boost_period)
+
+    @property
+    def is_boosted(self):
+        return self._period != self.duration
+
+    def _set_period(self, period):
+        # the display and indev timers keep the periods they had before the
+        # boost and never get slower than those. Once the boost has decayed
+        # back to duration they get passed None which puts those periods
+        # back.
+        self._period = period
+        self._timer.init(
+            mode=Timer.PERIODIC,
+            period=period,
+            callback=self._timer_cb
+        )
+
+        if period == self.duration:
+            period = None
+
+        import display_driver_framework  # NOQA
+
+        for display in display_driver_framework.DisplayDriver.get_displays():
+            display._set_refresh_period(period)  # NOQA
+
+        try:
+            import _indev_base  # NOQA
+        except ImportError:
+            pass
+        else:
+            for indev in _indev_base.IndevBase._indevs:  # NOQA
+                indev._set_read_period(period)  # NOQA
+
+    def _decay_boost(self):
+        if time.ticks_diff(time.ticks_ms(), self._boost_until) < 0:  # NOQA
+            return
+
+        self._set_period(min(self._period * 2, self.duration))
+
     def deinit(self):
+        if self._period != self.duration:
+            self._set_period(self.duration)
+
         self._timer.deinit()
         TaskHandler._current_instance = None
 
@@ -155,6 +222,9 @@ class TaskHandler(object):
                     ticks_diff = time.ticks_diff(stop_time, start_time)  # NOQA
                     lv.tick_inc(ticks_diff)
 
+                if self._period != self.duration:
+                    self._decay_boost()
+
                 self._running = False
 
         except Exception as e:
@@ -164,7 +234,7 @@ class TaskHandler(object):
                 self.exception_hook(e)
 
     def _timer_cb(self, _):
-        lv.tick_inc(self.duration)
+        lv.tick_inc(self._period)
         if self._running:
             return
 
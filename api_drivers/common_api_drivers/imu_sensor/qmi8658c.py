@@ -1,5 +1,8 @@
 from micropython import const  # NOQA
 import imu_sensor_framework  # NOQA
+import fusion  # NOQA
+import struct
+import time
 
 
 _VERSION_REG = const(0x0)
@@ -19,18 +22,40 @@ _ACCEL_SETTING_REG = const(0x03)
 _GYRO_SETTING_REG = const(0x04)
 _ENABLE_REG = const(0x08)
 
+_CTRL9_REG = const(0x0A)
+_FIFO_WTM_TH_REG = const(0x13)
+_FIFO_CTRL_REG = const(0x14)
+_FIFO_SMPL_CNT_REG = const(0x15)
+_FIFO_STATUS_REG = const(0x16)
+_FIFO_DATA_REG = const(0x17)
+_STATUSINT_REG = const(0x2D)
+
+_CTRL_CMD_ACK = const(0x00)
+_CTRL_CMD_RST_FIFO = const(0x04)
+_CTRL_CMD_REQ_FIFO = const(0x05)
+
+_CMD_DONE_FLAG = const(0x80)
+_INT2_ENABLE_FLAG = const(0x10)
+
+_FIFO_MODE_STREAM = const(0x02)
+_FIFO_SIZE_128 = const(0x0C)
+_FIFO_SAMPLES = const(128)
+# accel x, y, z + gyro x, y, z, 16 bits each
+_FIFO_SAMPLE_SIZE = const(12)
+
 # STANDARD_GRAVITY = 9.80665
 
 
+# the range constants are already shifted into bits 4 - 6
 def _decode_settings(value):
-    rnge = value >> 4
+    rnge = value & 0x70
     rate = value & 0xF
 
     return rnge, rate
 
 
 def _encode_setting(rnge, rate):
-    return ((rnge & 0x7) << 4) | (rate & 0xF)
+    return (rnge & 0x70) | (rate & 0xF)
 
 
 ACCEL_RANGE_2 = const(0)  # +/- 2g
@@ -79,7 +104,7 @@ BITS = 8
 class QMI8658C(imu_sensor_framework.IMUSensorFramework):
 
     def _read_reg(self, reg):
-        self._device.read_mem(reg, self._rx_mv[:1])
+        self._device.read_mem(reg, buf=self._rx_mv[:1])
         return self._rx_buf[0]
 
     def _write_reg(self, reg, data):
@@ -104,7 +129,12 @@ class QMI8658C(imu_sensor_framework.IMUSensorFramework):
         self._gyro_range = GYRO_RANGE_256
         self._gyro_rate = GYRO_RATE_125_HZ
 
-        self._write_reg(_CONFIG2_REG, 0x60)
+        self._fifo_ctrl = 0
+        self._fifo_watermark = 0
+
+        # address auto increment and big endian data
+        self._ctrl1 = 0x60
+        self._write_reg(_CONFIG2_REG, self._ctrl1)
         self._write_reg(_ACCEL_SETTING_REG, _encode_setting(ACCEL_RANGE_8, ACCEL_RATE_125_HZ))
         self._write_reg(_GYRO_SETTING_REG, _encode_setting(GYRO_RANGE_256, GYRO_RATE_125_HZ))
 
@@ -113,6 +143,79 @@ class QMI8658C(imu_sensor_framework.IMUSensorFramework):
         self._write_reg(_CONFIG7_REG, 0x00)  # Disables Motion on Demand.
         self._write_reg(_ENABLE_REG, 0x03)  # enable accel and gyro
 
+        self._update_scales()
+
+    def _update_scales(self):
+        # full scale is +/- (2 << n) g and +/- (16 << n) deg/s
+        self._accel_scale = (2 << (self._accel_range >> 4)) / 32768
+        self._gyro_scale = (16 << (self._gyro_range >> 4)) / 32768
+
+    def _ctrl9(self, cmd):
+        self._write_reg(_CTRL9_REG, cmd)
+
+        for _ in range(100):
+            if self._read_reg(_STATUSINT_REG) & _CMD_DONE_FLAG:
+                break
+            time.sleep_us(10)
+        else:
+            raise RuntimeError('QMI8658C command timed out')
+
+        self._write_reg(_CTRL9_REG, _CTRL_CMD_ACK)
+
+    def _enable_fifo(self, watermark):
+        watermark = max(1, min(watermark, _FIFO_SAMPLES))
+        self._fifo_watermark = watermark
+
+        # stream mode drops the oldest samples if the FIFO is allowed to
+        # fill up instead of stopping the sensor
+        self._fifo_ctrl = _FIFO_SIZE_128 | _FIFO_MODE_STREAM
+
+        self._write_reg(_FIFO_WTM_TH_REG, watermark)
+        self._write_reg(_FIFO_CTRL_REG, self._fifo_ctrl)
+        self._ctrl9(_CTRL_CMD_RST_FIFO)
+
+        # the FIFO watermark interrupt is on INT2
+        self._ctrl1 |= _INT2_ENABLE_FLAG
+        self._write_reg(_CONFIG2_REG, self._ctrl1)
+
+        # both sensors fill the FIFO at the gyro data rate
+        dt = (1 << self._gyro_rate) / 8000
+
+        return _FIFO_SAMPLES * _FIFO_SAMPLE_SIZE, dt
+
+    def _disable_fifo(self):
+        self._ctrl1 &= ~_INT2_ENABLE_FLAG & 0xFF
+        self._write_reg(_CONFIG2_REG, self._ctrl1)
+
+        self._fifo_ctrl = 0
+        self._write_reg(_FIFO_CTRL_REG, 0x00)
+
+    def _read_fifo(self, buf):
+        # FIFO_SMPL_CNT holds the low 8 bits and FIFO_STATUS the high 2 bits
+        # of the number of 16 bit words waiting
+        self._device.read_mem(_FIFO_SMPL_CNT_REG, buf=self._rx_mv[:2])
+        words = ((self._rx_buf[1] & 0x03) << 8) | self._rx_buf[0]
+
+        count = min((words * 2) // _FIFO_SAMPLE_SIZE, len(buf) // _FIFO_SAMPLE_SIZE)
+
+        if self._int_pin is None:
+            if count < self._fifo_watermark:
+                return 0
+        elif not count:
+            return 0
+
+        size = count * _FIFO_SAMPLE_SIZE
+
+        self._ctrl9(_CTRL_CMD_REQ_FIFO)
+        # FIFO_DATA doesn't auto increment so the whole burst comes out of
+        # the one register
+        self._device.read_mem(_FIFO_DATA_REG, buf=buf[:size])
+        # clears FIFO_rd_mode which hands the FIFO back to the sensor
+        self._write_reg(_FIFO_CTRL_REG, self._fifo_ctrl)
+
+        fusion.unpack_i16(buf, True, count=size // 2)
+        return count
+
     @property
     def accel_range(self):
         return self._accel_range
@@ -121,6 +224,7 @@ class QMI8658C(imu_sensor_framework.IMUSensorFramework):
     def accel_range(self, value):
         self._accel_range = value
         self._write_reg(_ACCEL_SETTING_REG, _encode_setting(value, self._accel_rate))
+        self._update_scales()
 
     @property
     def accel_rate(self):
@@ -138,7 +242,8 @@ class QMI8658C(imu_sensor_framework.IMUSensorFramework):
     @gyro_range.setter
     def gyro_range(self, value):
         self._gyro_range = value
-        self._write_reg(_ACCEL_SETTING_REG, _encode_setting(value, self._gyro_rate))
+        self._write_reg(_GYRO_SETTING_REG, _encode_setting(value, self._gyro_rate))
+        self._update_scales()
 
     @property
     def gyro_rate(self):
@@ -147,40 +252,33 @@ class QMI8658C(imu_sensor_framework.IMUSensorFramework):
     @gyro_rate.setter
     def gyro_rate(self, value):
         self._gyro_rate = value
-        self._write_reg(_ACCEL_SETTING_REG, _encode_setting(self._gyro_range, value))
+        self._write_reg(_GYRO_SETTING_REG, _encode_setting(self._gyro_range, value))
 
     @property
     def timestamp(self) -> int:
-        self._device.read_mem(_TIME_REG, self._rx_mv[:3])
+        self._device.read_mem(_TIME_REG, buf=self._rx_mv[:3])
         return self._rx_buf[0] + (self._rx_buf[1] << 8) + (self._rx_buf[2] << 16)
 
     @property
     def temperature(self) -> float:
         """Chip temperature"""
-        self._device.read_mem(_TEMP_REG, self._rx_mv[:2])
+        self._device.read_mem(_TEMP_REG, buf=self._rx_mv[:2])
         temp = self._rx_buf[0] / 256 + self._rx_buf[1]
         return temp
 
     def _get_accelerometer(self):
-        self._device.read_mem(_ACCEL_REG, self._rx_mv[:6])
+        self._device.read_mem(_ACCEL_REG, buf=self._rx_mv[:6])
+        x, y, z = struct.unpack('>hhh', self._rx_buf)
+        scale = self._accel_scale
 
-        buf = self._rx_buf
-
-        x = buf[0] << 8 | buf[1]
-        y = buf[2] << 8 | buf[3]
-        z = buf[4] << 8 | buf[5]
-
-        return x, y, z
+        return x * scale, y * scale, z * scale
 
     def _get_gyrometer(self):
-        self._device.read_mem(_GYRO_REG, self._rx_mv[:6])
-        buf = self._rx_buf
-
-        x = buf[0] << 8 | buf[1]
-        y = buf[2] << 8 | buf[3]
-        z = buf[4] << 8 | buf[5]
+        self._device.read_mem(_GYRO_REG, buf=self._rx_mv[:6])
+        x, y, z = struct.unpack('>hhh', self._rx_buf)
+        scale = self._gyro_scale
 
-        return x, y, z
+        return x * scale, y * scale, z * scale
 
     def _get_magnetometer(self):  # NOQA
         return None
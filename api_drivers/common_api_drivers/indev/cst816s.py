@@ -180,6 +180,10 @@ class CST816S(pointer_framework.PointerDriver):
         self._rx_buf = bytearray(1)
         self._rx_mv = memoryview(self._rx_buf)
 
+        # FingerNum through YposL are read in one transfer
+        self._points_buf = bytearray(5)
+        self._points_mv = memoryview(self._points_buf)
+
         self._device = device
 
         if not isinstance(reset_pin, int):
@@ -290,18 +294,14 @@ class CST816S(pointer_framework.PointerDriver):
         time.sleep_ms(50)  # NOQA
 
     def _get_coords(self):
-        self._read_reg(_FingerNum)
-        if self._rx_buf[0] == 0:
-            return None
+        self._tx_buf[0] = _FingerNum
+        self._device.write_readinto(self._tx_mv[:1], self._points_mv)
 
-        self._read_reg(_XposH)
-        x = (self._rx_buf[0] & 0x0F) << 8
-        self._read_reg(_XposL)
-        x |= self._rx_buf[0]
+        points = self._points_buf
+        if points[0] == 0:
+            return None
 
-        self._read_reg(_YposH)
-        y = (self._rx_buf[0] & 0x0F) << 8
-        self._read_reg(_YposL)
-        y |= self._rx_buf[0]
+        x = ((points[1] & 0x0F) << 8) | points[2]
+        y = ((points[3] & 0x0F) << 8) | points[4]
 
         return self.PRESSED, x, y
@@ -1,14 +1,54 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
-import struct
-import select
+# LVGL button driver for evdev keys (unix port)
+#
+# `codes` is a list of evdev key codes, the index of a pressed code is the
+# button id that gets mapped to the points set with set_button_points.
+
+import evdev
 import button_framework
 import lvgl as lv  # NOQA
 
 
+class EvdevButtonDriver(button_framework.ButtonDriver):
 
+    def __init__(self, codes, device='/dev/input/event0', reader=None,
+                 grab=False):
+        if reader is None:
+            reader = evdev.Reader()
 
+        self._reader = reader
+        self._device = reader.open(device, grab=grab)
+        self._codes = list(codes)
+        self._pressed = []
 
-class EvdevButtonDriver(button_framework.ButtonDriver):
-    pass
+        super().__init__()
+
+    def _get_button(self):
+        self._reader.poll()
+
+        while True:
+            event = self._reader.key(self._device)
+            if event is None:
+                break
+
+            code, value = event
+            if code not in self._codes:
+                continue
+
+            button = self._codes.index(code)
+
+            if value == 0:
+                if button in self._pressed:
+                    self._pressed.remove(button)
+            elif button not in self._pressed:
+                self._pressed.append(button)
+
+        if self._pressed:
+            return self._pressed[-1]
+
+        return None
 
+    def delete(self):
+        self._reader.close(self._device)
+        self._indev_drv.enable(False)
@@ -1,15 +1,30 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
-import struct
-import select
-import keypad_framework
-import lvgl as lv  # NOQA
-
+# LVGL keypad driver for evdev gamepads (unix port)
+#
+# The d-pad (buttons or hat) moves the focus, the south button is enter and
+# the east button is escape.
 
+import keyboard
+import lvgl as lv  # NOQA
 
 
+class EvdevJoystickDriver(keyboard.EvdevKeyboardDriver):
 
-class EvdevJoystickDriver(keypad_framework.KeypadDriver):
-    pass
+    def __init__(self, device='/dev/input/event0', reader=None, grab=False):
+        super().__init__(device, reader, grab)
 
+        self._keys.update({
+            0x130: lv.KEY.ENTER,  # BTN_SOUTH  # NOQA
+            0x131: lv.KEY.ESC,  # BTN_EAST  # NOQA
+            0x13A: lv.KEY.PREV,  # BTN_SELECT  # NOQA
+            0x13B: lv.KEY.NEXT,  # BTN_START  # NOQA
+            0x220: lv.KEY.UP,  # BTN_DPAD_UP  # NOQA
+            0x221: lv.KEY.DOWN,  # BTN_DPAD_DOWN  # NOQA
+            0x222: lv.KEY.LEFT,  # BTN_DPAD_LEFT  # NOQA
+            0x223: lv.KEY.RIGHT  # BTN_DPAD_RIGHT  # NOQA
+        })
 
+    def _map_key(self, code):
+        # only the navigation keys, no text
+        return self._keys.get(code, None)
@@ -1,11 +1,80 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
-import struct
-import select
+# LVGL keypad driver for evdev keyboards (unix port)
+
+import evdev
 import keypad_framework
 import lvgl as lv  # NOQA
 
+_KEY_LEFTSHIFT = 42
+_KEY_RIGHTSHIFT = 54
+
+# evdev key codes for the printable keys, (normal, shifted)
+_CHARS = {
+    2: '1!', 3: '2@', 4: '3#', 5: '4$', 6: '5%', 7: '6^', 8: '7&', 9: '8*',
+    10: '9(', 11: '0)', 12: '-_', 13: '=+', 16: 'qQ', 17: 'wW', 18: 'eE',
+    19: 'rR', 20: 'tT', 21: 'yY', 22: 'uU', 23: 'iI', 24: 'oO', 25: 'pP',
+    26: '[{', 27: ']}', 30: 'aA', 31: 'sS', 32: 'dD', 33: 'fF', 34: 'gG',
+    35: 'hH', 36: 'jJ', 37: 'kK', 38: 'lL', 39: ';:', 40: '\'"', 41: '`~',
+    43: '\\|', 44: 'zZ', 45: 'xX', 46: 'cC', 47: 'vV', 48: 'bB', 49: 'nN',
+    50: 'mM', 51: ',<', 52: '.>', 53: '/?', 57: '  '
+}
 
 
 class EvdevKeyboardDriver(keypad_framework.KeypadDriver):
-    pass
+
+    def __init__(self, device='/dev/input/event0', reader=None, grab=False):
+        if reader is None:
+            reader = evdev.Reader()
+
+        self._reader = reader
+        self._device = reader.open(device, grab=grab)
+        self._shift = False
+
+        self._keys = {
+            1: lv.KEY.ESC,  # NOQA
+            14: lv.KEY.BACKSPACE,  # NOQA
+            15: lv.KEY.NEXT,  # NOQA
+            28: lv.KEY.ENTER,  # NOQA
+            96: lv.KEY.ENTER,  # NOQA
+            102: lv.KEY.HOME,  # NOQA
+            103: lv.KEY.UP,  # NOQA
+            105: lv.KEY.LEFT,  # NOQA
+            106: lv.KEY.RIGHT,  # NOQA
+            107: lv.KEY.END,  # NOQA
+            108: lv.KEY.DOWN,  # NOQA
+            111: lv.KEY.DEL  # NOQA
+        }
+
+        super().__init__()
+
+    def _map_key(self, code):
+        if code in self._keys:
+            return self._keys[code]
+
+        if code in _CHARS:
+            return ord(_CHARS[code][int(self._shift)])
+
+        return None
+
+    def _get_key(self):
+        self._reader.poll()
+
+        while True:
+            event = self._reader.key(self._device)
+            if event is None:
+                return None
+
+            code, value = event
+
+            if code in (_KEY_LEFTSHIFT, _KEY_RIGHTSHIFT):
+                self._shift = bool(value)
+                continue
+
+            key = self._map_key(code)
+            if key is not None:
+                return (self.RELEASED if value == 0 else self.PRESSED), key
+
+    def delete(self):
+        self._reader.close(self._device)
+        self._indev_drv.enable(False)
@@ -1,11 +1,42 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
-import struct
-import select
+# LVGL encoder driver for the scroll wheel of an evdev mouse (unix port)
+
+import evdev
 import encoder_framework
 import lvgl as lv  # NOQA
 
+# BTN_MIDDLE is bit 2 of the evdev button mask
+_BTN_MIDDLE_MASK = 0x04
+
 
 class EvdevMouseWheelDriver(encoder_framework.EncoderDriver):
-    pass
 
+    def __init__(self, device='/dev/input/event0', reader=None, grab=False):
+        if reader is None:
+            reader = evdev.Reader()
+
+        self._reader = reader
+        self._device = reader.open(device, grab=grab)
+
+        super().__init__()
+
+    def _get_enc(self):
+        self._reader.poll()
+        steps, buttons = self._reader.wheel(self._device)
+
+        if buttons & _BTN_MIDDLE_MASK:
+            key = lv.KEY.ENTER  # NOQA
+        else:
+            key = None
+
+        if not steps and key is None:
+            return None
+
+        # wheel up is a positive step, LVGL moves the focus back on a
+        # negative diff
+        return -steps, key
+
+    def delete(self):
+        self._reader.close(self._device)
+        self._indev_drv.enable(False)
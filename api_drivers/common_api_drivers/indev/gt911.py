@@ -8,6 +8,7 @@
 
 from micropython import const  # NOQA
 import pointer_framework
+import lcd_utils
 import machine  # NOQA
 import time
 
@@ -21,6 +22,9 @@ _ESD_CHECK_REG = const(0x8041)
 _STATUS_REG = const(0x814E)
 _POINT_1_REG = const(0x8150)
 
+_MAX_POINTS = const(5)
+_POINT_SIZE = const(8)  # track id, x, y, size, reserved
+
 _PRODUCT_ID_REG = const(0x8140)
 _FIRMWARE_VERSION_REG = const(0x8144)
 _VENDOR_ID_REG = const(0x814A)
@@ -65,6 +69,24 @@ class GT911(pointer_framework.PointerDriver):
         self._rx_buf = bytearray(6)
         self._rx_mv = memoryview(self._rx_buf)
 
+        # the status register is followed by the point records so all of
+        # it gets read in a single transfer
+        self._points_buf = bytearray(1 + (_MAX_POINTS * _POINT_SIZE))
+        self._points_mv = memoryview(self._points_buf)
+
+        # status and points get read in a single bus transaction. The status
+        # only gets cleared when the controller has flagged new data
+        self._status_reg_buf = bytearray(
+            [_STATUS_REG >> 8, _STATUS_REG & 0xFF]
+        )
+        self._status_clear_buf = bytearray(
+            [_STATUS_REG >> 8, _STATUS_REG & 0xFF, 0x00]
+        )
+        self._poll_segments = (
+            (device.WRITE, self._status_reg_buf),
+            (device.READ | device.STOP, self._points_mv)
+        )
+
         self._device = device
 
         self.__x = 0
@@ -85,6 +107,10 @@ class GT911(pointer_framework.PointerDriver):
             touch_cal=touch_cal, startup_rotation=startup_rotation, debug=debug
         )
 
+        self._init_multi_touch(
+            _MAX_POINTS, lcd_utils.TouchTracker.FORMAT_GT911
+        )
+
     def hw_reset(self):
         if self._interrupt_pin and self._reset_pin:
             self._interrupt_pin.init(self._interrupt_pin.OUT)
@@ -147,26 +173,19 @@ class GT911(pointer_framework.PointerDriver):
         return gt911_extension.GT911Extension(self, self._device)
 
     def _get_coords(self):
-        self._read_reg(_STATUS_REG, 1)
-        touch_cnt = self._rx_buf[0] & 0x0F
-        status = self._rx_buf[0] & 0x80
-
-        if status:
-            if touch_cnt == 1:
-                self._read_reg(_POINT_1_REG, 6)
-
-                x = self._rx_buf[0] + (self._rx_buf[1] << 8)
-                y = self._rx_buf[2] + (self._rx_buf[3] << 8)
-
-                self._write_reg(_STATUS_REG, 0x00)
+        self._device.transaction(self._poll_segments)
+        status = self._points_buf[0]
 
-                self.__x = x
-                self.__y = y
-                self.__last_state = self.PRESSED
+        if status & 0x80:
+            self._device.write(self._status_clear_buf)
+            touch_cnt = status & 0x0F
 
-            elif touch_cnt == 0:
-                self.__last_state = self.RELEASED
+            if touch_cnt <= _MAX_POINTS:
+                coords = self._update_contacts(self._points_mv[1:], touch_cnt)
 
-            self._write_reg(_STATUS_REG, 0x00)
+                if coords is None:
+                    self.__last_state = self.RELEASED
+                else:
+                    self.__last_state, self.__x, self.__y = coords
 
         return self.__last_state, self.__x, self.__y
@@ -4,6 +4,7 @@ from micropython import const  # NOQA
 
 import i2c
 import pointer_framework
+import lcd_utils
 import time
 
 
@@ -45,9 +46,15 @@ _FIFO_STA_RESET = const(0x01)
 
 _TSC_I_DRIVE_50MA = const(0x01)
 
+_TSC_DATA_REG = const(0xD7)  # non auto increment, reading streams the FIFO
+_MAX_SAMPLES = const(32)  # lcd_utils.TouchFilter.MAX_SAMPLES
+
 
 class STMPE610(pointer_framework.PointerDriver):
 
+    margin = 50
+    smoothing = 0  # 0 - 255, weight given to the previous point
+
     def _read_reg(self, reg, num_bytes):
         self._tx_buf[0] = reg
 
@@ -76,6 +83,20 @@ class STMPE610(pointer_framework.PointerDriver):
         self._rx_buf = bytearray(4)
         self._rx_mv = memoryview(self._rx_buf)
 
+        # every sample in the FIFO gets read and the filter turns them into
+        # a single point
+        self._sample_buf = bytearray(_MAX_SAMPLES * 4)
+        self._sample_mv = memoryview(self._sample_buf)
+        self._is_i2c = isinstance(device, i2c.I2C.Device)
+
+        self._filter = lcd_utils.TouchFilter(
+            margin=self.margin,
+            trim=1,
+            smoothing=self.smoothing,
+            max_raw=4096,
+            format=lcd_utils.TouchFilter.FORMAT_STMPE610
+        )
+
         if isinstance(device, i2c.I2C.Device):
             _TSC_FRACTION_Z_REG = 0x56
             _TSC_I_DRIVE_REG = 0x58
@@ -109,20 +130,37 @@ class STMPE610(pointer_framework.PointerDriver):
             touch_cal=touch_cal, startup_rotation=startup_rotation, debug=debug
         )
 
+    def _read_samples(self, count):
+        sample_mv = self._sample_mv
+
+        if self._is_i2c:
+            self._device.read_mem(_TSC_DATA_REG, buf=sample_mv[:count * 4])
+        else:
+            for i in range(count):
+                self._read_reg(_TSC_DATA_REG, 4)
+                sample_mv[i * 4:(i + 1) * 4] = self._rx_mv
+
     def _get_coords(self):
         self._read_reg(self._FIFO_SIZE_REG, 1)
         touch_count = self._rx_buf[0]
 
         if not touch_count:
+            self._filter.reset()
             return None
 
-        while touch_count:
-            self._read_reg(0xD7, 4)
-            touch_count -= 1
-
-        x = self._rx_buf[0] << 4 | self._rx_buf[1] >> 4
-        y = (self._rx_buf[1] & 0xF) << 8 | self._rx_buf[2]
+        # only the newest samples get used, anything past what the
+        # filter is able to take gets read out of the FIFO and dropped
+        while touch_count > _MAX_SAMPLES:
+            count = min(touch_count - _MAX_SAMPLES, _MAX_SAMPLES)
+            self._read_samples(count)
+            touch_count -= count
 
+        self._read_samples(touch_count)
         self._write_reg(_INT_STA_REG, 0xFF)
 
-        return self.PRESSED, x, y
+        point = self._filter.process(self._sample_mv[:touch_count * 4])
+
+        if point is None:
+            return None
+
+        return self.PRESSED, point[0], point[1]
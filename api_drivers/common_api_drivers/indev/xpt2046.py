@@ -4,7 +4,7 @@ from micropython import const  # NOQA
 import micropython  # NOQA
 import machine  # NOQA
 import pointer_framework
-import time
+import lcd_utils
 
 
 _CMD_X_READ = const(0xD0)  # 12 bit resolution
@@ -20,6 +20,7 @@ class XPT2046(pointer_framework.PointerDriver):
     touch_threshold = 400
     confidence = 5
     margin = 50
+    smoothing = 0  # 0 - 255, weight given to the previous point
 
     def _read_reg(self, reg, num_bytes):
         self._tx_buf[0] = reg
@@ -50,56 +51,56 @@ class XPT2046(pointer_framework.PointerDriver):
         self._rx_buf = bytearray(3)
         self._rx_mv = memoryview(self._rx_buf)
 
-        self.__confidence = max(min(self.confidence, 25), 3)
-        self.__points = [[0, 0] for _ in range(self.__confidence)]
+        confidence = max(min(self.confidence, 25), 3)
 
-        margin = max(min(self.margin, 100), 1)
-        self.__margin = margin * margin
+        # Z1 and Z2 get read in a single transfer and so do all of the X/Y
+        # samples. The samples are then handed off as a whole to the filter.
+        self._z_tx_buf = bytearray([_CMD_Z1_READ, 0, 0, _CMD_Z2_READ, 0, 0])
+        self._z_rx_buf = bytearray(6)
+
+        self._sample_tx_buf = bytearray(
+            [_CMD_X_READ, 0, 0, _CMD_Y_READ, 0, 0] * confidence
+        )
+        self._sample_rx_buf = bytearray(len(self._sample_tx_buf))
+
+        self.__filter = lcd_utils.TouchFilter(
+            margin=max(min(self.margin, 100), 1),
+            trim=confidence // 4,
+            smoothing=self.smoothing,
+            min_raw=_MIN_RAW_COORD,
+            max_raw=_MAX_RAW_COORD,
+            format=lcd_utils.TouchFilter.FORMAT_XPT2046
+        )
 
         super().__init__(
             touch_cal=touch_cal, startup_rotation=startup_rotation, debug=debug
         )
 
     def _get_coords(self):
-        z1 = self._read_reg(_CMD_Z1_READ, 3)
-        z2 = self._read_reg(_CMD_Z2_READ, 3)
+        z_rx_buf = self._z_rx_buf
+        self._device.write_readinto(self._z_tx_buf, z_rx_buf)
+
+        z1 = ((z_rx_buf[1] << 8) | z_rx_buf[2]) >> 3
+        z2 = ((z_rx_buf[4] << 8) | z_rx_buf[5]) >> 3
         z = z1 + ((_MAX_RAW_COORD + 6) - z2)
 
+        # the pressure gets checked here and not by the filter so the X/Y
+        # samples aren't read when nothing is touching the panel
         if z < self.touch_threshold:
+            self.__filter.reset()
             return None
 
-        points = self.__points
-        count = 0
-        timeout = 5000
-        start_time = time.ticks_us()  # NOQA
-        while timeout > 0:
-            if count == self.__confidence:
-                break
-
-            sample = self._get_raw()  # get a touch
-            if sample is not None:
-                points[count][0], points[count][1] = sample  # put in buff
-                count += 1
-
-            end_time = time.ticks_us()  # NOQA
-            timeout -= time.ticks_diff(end_time, start_time)  # NOQA
-            start_time = end_time
-
-        if count:
-            meanx = sum([points[i][0] for i in range(count)]) // count
-            meany = sum([points[i][1] for i in range(count)]) // count
-            dev = sum([
-                (points[i][0] - meanx) ** 2 + (points[i][1] - meany) ** 2
-                for i in range(count)
-            ]) / count
-
-            if dev <= self.__margin:
-                x, y = self._normalize(meanx, meany)
-                if self._debug:
-                    print(f'{self.__class__.__name__}_TP_DATA(x={meanx}, y={meany}, z={z})')  # NOQA
-                return self.PRESSED, x, y
-
-        return None
+        self._device.write_readinto(self._sample_tx_buf, self._sample_rx_buf)
+        point = self.__filter.process(self._sample_rx_buf)
+
+        if point is None:
+            return None
+
+        if self._debug:
+            print(f'{self.__class__.__name__}_TP_DATA(x={point[0]}, y={point[1]}, z={z})')  # NOQA
+
+        x, y = self._normalize(*point)
+        return self.PRESSED, x, y
 
     def _normalize(self, x, y):
         x = pointer_framework.remap(
@@ -102,8 +102,8 @@ class Pin(io_expander_framework.Pin):
 
             # Write to reg only when different */
             if states != Pin._output_states:
-                self._write_reg(_REG_OUTPUT, states)
                 Pin._output_states = states
+                self._commit(_REG_OUTPUT)
 
     def _get_level(self):
         if self._mode == self.IN:
@@ -115,6 +115,17 @@ class Pin(io_expander_framework.Pin):
 
         return int(bool(states & self.__bit))
 
+    def _flush_reg(self, reg):
+        if reg == _REG_OUTPUT:
+            self._write_reg(_REG_OUTPUT, Pin._output_states)
+
+    @property
+    def _irq_bit(self):
+        return self.__bit
+
+    def _read_inputs(self):
+        return ~self._read_reg(_REG_INPUT) & 0xFF
+
     def _set_irq(self, handler, trigger):
         pass
 
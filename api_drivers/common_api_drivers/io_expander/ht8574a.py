@@ -49,19 +49,30 @@ class Pin(io_expander_framework.Pin):
 
             # 0nly set if there is an actual change
             if states != Pin._output_states:
-                self.__write_reg(Pin._output_states)
                 Pin._output_states = states
+                self._commit(0)
 
     def _get_level(self):
         if self._mode == self.IN:
             states = self.__read_reg()
-        elif self.mode == self.OUT:
+        elif self._mode == self.OUT:
             states = Pin._output_states
         else:
             raise ValueError('Unsupported pin mode')
 
         return int(bool(states & self.__bit))
 
+    def _flush_reg(self, _):
+        # there is only the one port register
+        self.__write_reg(Pin._output_states)
+
+    @property
+    def _irq_bit(self):
+        return self.__bit
+
+    def _read_inputs(self):
+        return self.__read_reg()
+
     def _set_irq(self, handler, trigger):
         pass
 
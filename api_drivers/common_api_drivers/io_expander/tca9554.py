@@ -57,7 +57,7 @@ class Pin(io_expander_framework.Pin):
         else:
             raise ValueError('OPEN_DRAIN is not supported')
 
-        self.__write_reg(_CONFIGURATION_REG, Pin._config_settings)
+        self._commit(_CONFIGURATION_REG)
 
     def _set_level(self, level):
         if self._mode == self.OUT:
@@ -68,8 +68,8 @@ class Pin(io_expander_framework.Pin):
 
             # 0nly set if there is an actual change
             if states != Pin._output_states:
-                self.__write_reg(_OUTPUT_PORT_REG, Pin._output_states)
                 Pin._output_states = states
+                self._commit(_OUTPUT_PORT_REG)
 
     def _get_level(self):
         if self._mode == self.IN:
@@ -81,6 +81,19 @@ class Pin(io_expander_framework.Pin):
 
         return int(bool(states & self.__bit))
 
+    def _flush_reg(self, reg):
+        if reg == _OUTPUT_PORT_REG:
+            self.__write_reg(_OUTPUT_PORT_REG, Pin._output_states)
+        elif reg == _CONFIGURATION_REG:
+            self.__write_reg(_CONFIGURATION_REG, Pin._config_settings)
+
+    @property
+    def _irq_bit(self):
+        return self.__bit
+
+    def _read_inputs(self):
+        return self.__read_reg(_INPUT_PORT_REG)
+
     def _set_irq(self, handler, trigger):
         pass
 
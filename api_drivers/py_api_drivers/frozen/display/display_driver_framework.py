@@ -27,6 +27,14 @@ _CASET = const(0x2A)
 _RAMWR = const(0x2C)
 _MADCTL = const(0x36)
 
+# binary init sequence opcodes, see builder/init_seq_compiler.py
+_SEQ_END = const(0x00)
+_SEQ_CMD8 = const(0x01)
+_SEQ_CMD16 = const(0x02)
+_SEQ_CMD32 = const(0x03)
+_SEQ_DELAY = const(0x04)
+_SEQ_REPEAT = const(0x05)
+
 
 _MADCTL_MH = const(0x04)  # Refresh 0=Left to Right, 1=Right to Left
 _MADCTL_BGR = const(0x08)  # BGR color order
@@ -54,6 +62,9 @@ class DisplayDriver:
 
     _displays = []
 
+    # refresh period from before a boost, see _set_refresh_period
+    _refr_period = None
+
     @staticmethod
     def get_default():
         disp = lv.display_get_default()  # NOQA
@@ -118,6 +129,13 @@ class DisplayDriver:
         self._param_buf = bytearray(4)
         self._param_mv = memoryview(self._param_buf)
 
+        # CASET and RASET packed as tx_params records so setting the memory
+        # location is a single call into the bus
+        self._window_buf = bytearray([
+            _SEQ_CMD8, _CASET, 4, 0, 0, 0, 0,
+            _SEQ_CMD8, _RASET, 4, 0, 0, 0, 0
+        ])
+
         self._color_byte_order = color_byte_order
         self._color_space = color_space
 
@@ -408,6 +426,26 @@ class DisplayDriver:
     def delete_refr_timer(self):
         self._disp_drv.delete_refr_timer()
 
+    def _set_refresh_period(self, period):
+        # used by the task handler to speed up the refreshes while there
+        # is input, see TaskHandler.boost. The period the timer had before
+        # the boost is kept, it is never made slower than that and passing
+        # None puts it back.
+        timer = self._disp_drv.get_refr_timer()
+        if timer is None:
+            return
+
+        if self._refr_period is None:
+            if period is None:
+                return
+            self._refr_period = timer.period
+
+        if period is None:
+            timer.set_period(self._refr_period)
+            self._refr_period = None
+        else:
+            timer.set_period(min(period, self._refr_period))
+
     def set_color_inversion(self, value):
         # If your white is showing up as black and your black
         # is showing up as white try setting this either True or False
@@ -486,6 +524,61 @@ class DisplayDriver:
     def set_params(self, cmd, params=None):
         self._data_bus.tx_param(cmd, params)
 
+    def _send_init_seq(self, seq):
+        # seq is a binary init sequence made by the builder from the
+        # initialization modules (builder/init_seq_compiler.py).
+        # If set_params has not been overridden the data bus plays the whole
+        # sequence back in C, otherwise it gets walked here so the override
+        # still sees every command.
+        if type(self).set_params is DisplayDriver.set_params:
+            self._data_bus.tx_init_seq(seq)
+            return
+
+        self._walk_init_seq(memoryview(seq), 0, len(seq))
+
+    def _walk_init_seq(self, mv, pos, end):
+        while pos < end:
+            op = mv[pos]
+
+            if op == _SEQ_END:
+                break
+            elif op == _SEQ_CMD8:
+                cmd = mv[pos + 1]
+                size = mv[pos + 2]
+                pos += 3
+            elif op == _SEQ_CMD16:
+                cmd = mv[pos + 1] | (mv[pos + 2] << 8)
+                size = mv[pos + 3]
+                pos += 4
+            elif op == _SEQ_CMD32:
+                cmd = (
+                    mv[pos + 1] | (mv[pos + 2] << 8) |
+                    (mv[pos + 3] << 16) | (mv[pos + 4] << 24)
+                )
+                size = mv[pos + 5] | (mv[pos + 6] << 8)
+                pos += 7
+            elif op == _SEQ_DELAY:
+                time.sleep_ms(mv[pos + 1] | (mv[pos + 2] << 8))
+                pos += 3
+                continue
+            elif op == _SEQ_REPEAT:
+                count = mv[pos + 1]
+                size = mv[pos + 2] | (mv[pos + 3] << 8)
+                pos += 4
+                for _ in range(count):
+                    self._walk_init_seq(mv, pos, pos + size)
+                pos += size
+                continue
+            else:
+                raise ValueError('invalid init sequence')
+
+            if size:
+                self.set_params(cmd, mv[pos:pos + size])
+            else:
+                self.set_params(cmd)
+
+            pos += size
+
     def get_params(self, cmd, params):
         self._data_bus.rx_param(cmd, params)
 
@@ -557,23 +650,21 @@ class DisplayDriver:
         return _RAMWR
 
     def _set_memory_location(self, x1, y1, x2, y2):
-        # Column addresses
-        param_buf = self._param_buf  # NOQA
+        window_buf = self._window_buf  # NOQA
 
-        param_buf[0] = (x1 >> 8) & 0xFF
-        param_buf[1] = x1 & 0xFF
-        param_buf[2] = (x2 >> 8) & 0xFF
-        param_buf[3] = x2 & 0xFF
-
-        self._data_bus.tx_param(_CASET, self._param_mv)
+        # Column addresses
+        window_buf[3] = (x1 >> 8) & 0xFF
+        window_buf[4] = x1 & 0xFF
+        window_buf[5] = (x2 >> 8) & 0xFF
+        window_buf[6] = x2 & 0xFF
 
         # Page addresses
-        param_buf[0] = (y1 >> 8) & 0xFF
-        param_buf[1] = y1 & 0xFF
-        param_buf[2] = (y2 >> 8) & 0xFF
-        param_buf[3] = y2 & 0xFF
+        window_buf[10] = (y1 >> 8) & 0xFF
+        window_buf[11] = y1 & 0xFF
+        window_buf[12] = (y2 >> 8) & 0xFF
+        window_buf[13] = y2 & 0xFF
 
-        self._data_bus.tx_param(_RASET, self._param_mv)
+        self._data_bus.tx_params(window_buf)
 
         return _RAMWR
 
@@ -1,5 +1,6 @@
 import fusion
 import time
+import micropython  # NOQA
 
 
 class IMUSensorFramework:
@@ -13,6 +14,15 @@ class IMUSensorFramework:
         self._pitch = 0.0
         self._yaw = 0.0
 
+        # multipliers that turn the raw FIFO values into g and degrees/second
+        self._accel_scale = 1.0
+        self._gyro_scale = 1.0
+
+        self._fifo_buf = None
+        self._fifo_mv = None
+        self._fifo_dt = None
+        self._int_pin = None
+
     @property
     def roll(self):
         return self._roll
@@ -34,6 +44,76 @@ class IMUSensorFramework:
     def _get_magnetometer(self):
         raise NotImplementedError
 
+    def _enable_fifo(self, watermark):
+        # turns on the sensor FIFO and returns (buffer size in bytes, seconds
+        # between samples)
+        raise NotImplementedError
+
+    def _disable_fifo(self):
+        raise NotImplementedError
+
+    def _read_fifo(self, buf):
+        # burst reads the FIFO into buf and returns the number of samples.
+        # The samples need to be native int16 in the
+        # fusion.Fusion.LAYOUT_AG_I16 layout. Return 0 if the watermark
+        # hasn't been reached yet.
+        raise NotImplementedError
+
+    def enable_fifo(self, watermark=32, int_pin=None):
+        """
+        Reads the sensor through its FIFO.
+
+        The samples collect in the sensor until there are `watermark` of them
+        and then get read in a single burst and run through the filter in C.
+
+        If `int_pin` (a `machine.Pin`) is given the burst is done when the
+        watermark interrupt fires and `read` only returns the last
+        orientation. Otherwise `read` checks the FIFO level and only reads the
+        data once the watermark is reached.
+        """
+        size, self._fifo_dt = self._enable_fifo(watermark)
+        self._fifo_buf = bytearray(size)
+        self._fifo_mv = memoryview(self._fifo_buf)
+
+        if int_pin is not None:
+            self._int_pin = int_pin
+            int_pin.irq(handler=self._on_fifo_irq, trigger=int_pin.IRQ_RISING)
+
+    def disable_fifo(self):
+        if self._fifo_buf is None:
+            return
+
+        if self._int_pin is not None:
+            self._int_pin.irq(handler=None)
+            self._int_pin = None
+
+        self._disable_fifo()
+        self._fifo_buf = None
+        self._fifo_mv = None
+        self._fifo_dt = None
+
+    def _on_fifo_irq(self, _):
+        micropython.schedule(self._fifo_sched_cb, None)
+
+    def _fifo_sched_cb(self, _):
+        if self._fifo_buf is not None:
+            self._update_from_fifo()
+
+    def _update_from_fifo(self):
+        count = self._read_fifo(self._fifo_mv)
+        if not count:
+            return
+
+        roll, pitch, yaw = self._fusion.update_batch(
+            self._fifo_mv, fusion.Fusion.LAYOUT_AG_I16, self._fifo_dt,
+            count=count, accel_scale=self._accel_scale,
+            gyro_scale=self._gyro_scale)
+
+        if roll is not None:
+            self._roll = roll
+            self._pitch = pitch
+            self._yaw = yaw
+
     def calibrate(self, sample_count=5):
         ts = [time.ticks_ns()]
         count = [0]
@@ -54,7 +134,37 @@ class IMUSensorFramework:
 
         self._fusion.calibrate(self._get_magnetometer, _stop_func)
 
+    def start_calibration(self, samples=500, gyro=True, mag=False):
+        """
+        Calibrates from the next `samples` readings without blocking.
+
+        `read` has to keep getting called (the auto rotation timer or the
+        FIFO interrupt do that). Poll `calibration_progress` and collect the
+        values from `calibration_result` when it reaches 1.0.
+        """
+        self._fusion.start_calibration(samples, gyro=gyro, mag=mag)
+
+    def cancel_calibration(self):
+        self._fusion.cancel_calibration()
+
+    @property
+    def calibration_progress(self):
+        return self._fusion.calibration_progress()
+
+    @property
+    def calibration_result(self):
+        return self._fusion.calibration_result()
+
+    def set_calibration(self, gyro_bias=None, mag_bias=None, mag_scale=None):
+        self._fusion.set_calibration(gyro_bias, mag_bias, mag_scale)
+
     def read(self):
+        if self._fifo_buf is not None:
+            if self._int_pin is None:
+                self._update_from_fifo()
+
+            return self._roll, self._pitch, self._yaw
+
         accel = self._get_accelerometer()
         gyro = self._get_gyrometer()
 
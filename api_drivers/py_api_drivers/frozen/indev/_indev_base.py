@@ -8,6 +8,9 @@ class IndevBase:
     _instance_counter = 1
     _indevs = []
 
+    # read period from before a boost, see _set_read_period
+    _read_period = None
+
     PRESSED = lv.INDEV_STATE.PRESSED  # NOQA
     RELEASED = lv.INDEV_STATE.RELEASED  # NOQA
 
@@ -105,6 +108,26 @@ class IndevBase:
     def get_read_timer(self):
         return self._indev_drv.get_read_timer()  # NOQA
 
+    def _set_read_period(self, period):
+        # used by the task handler while it is boosted, there is no read
+        # timer when the indev is in event mode. Same as
+        # DisplayDriver._set_refresh_period, None restores the period the
+        # timer had before the boost
+        timer = self._indev_drv.get_read_timer()  # NOQA
+        if timer is None:
+            return
+
+        if self._read_period is None:
+            if period is None:
+                return
+            self._read_period = timer.period
+
+        if period is None:
+            timer.set_period(self._read_period)
+            self._read_period = None
+        else:
+            timer.set_period(min(period, self._read_period))
+
     def get_active_obj(self):
         return self._indev_drv.get_active_obj()  # NOQA
 
@@ -3,6 +3,8 @@
 import lvgl as lv  # NOQA
 import _indev_base
 
+from lcd_utils import EncoderAccumulator as _EncoderAccumulator  # NOQA
+
 
 class EncoderDriver(_indev_base.IndevBase):
     _instance_counter = 1
@@ -39,6 +41,8 @@ class EncoderDriver(_indev_base.IndevBase):
         self._last_enc_diff = 0
         self._last_key = 0
         self._current_state = lv.INDEV_STATE.RELEASED  # NOQA
+        self._accumulator = None
+        self._enc_pins = None
 
         indev_drv = lv.indev_create()
         indev_drv.set_type(lv.INDEV_TYPE.ENCODER)  # NOQA
@@ -57,7 +61,76 @@ class EncoderDriver(_indev_base.IndevBase):
         # or None if no key event has occured
         raise NotImplementedError
 
+    def _get_enc_key(self):
+        # used in place of _get_enc once enable_accumulator has been called.
+        # returns the keycode of the pressed button or None if not pressed
+        return None
+
+    def enable_accumulator(self, pin_a=None, pin_b=None, steps_per_detent=4,
+                           curve=None):
+        # The edges of the encoder get counted in C between reads. With
+        # pin_a and pin_b given both pins get an interrupt on either edge,
+        # otherwise the counts have to be fed in from a hardware counter
+        # (accumulator.add) or an io expander handler (accumulator.feed).
+        #
+        # curve is a list of (detents_per_second, multiplier) points, turning
+        # the encoder faster moves further per detent.
+        self.disable_accumulator()
+
+        acc = _EncoderAccumulator(
+            pin_a, pin_b, steps_per_detent=steps_per_detent, curve=curve)
+
+        if pin_a is not None:
+            trigger = pin_a.IRQ_RISING | pin_a.IRQ_FALLING
+            for pin in (pin_a, pin_b):
+                try:
+                    pin.irq(handler=acc.irq, trigger=trigger, hard=True)
+                except TypeError:
+                    # io expander pins and ports that don't have hard interrupts
+                    pin.irq(acc.irq, trigger)
+
+            self._enc_pins = (pin_a, pin_b)
+
+        self._accumulator = acc
+        return acc
+
+    def disable_accumulator(self):
+        if self._accumulator is None:
+            return
+
+        if self._enc_pins is not None:
+            for pin in self._enc_pins:
+                pin.irq(None)
+
+            self._enc_pins = None
+
+        self._accumulator = None
+
+    def set_acceleration(self, curve):
+        if self._accumulator is None:
+            raise RuntimeError('enable_accumulator needs to be called first')
+
+        self._accumulator.set_curve(curve)
+
+    def _read_accumulator(self, data):
+        key = self._get_enc_key()
+
+        if key is None:
+            self._current_state = lv.INDEV_STATE.RELEASED  # NOQA
+        else:
+            self._current_state = lv.INDEV_STATE.PRESSED  # NOQA
+            self._last_key = key
+
+        data.key = self._last_key
+        data.enc_diff = self._accumulator.read()
+        data.state = self._current_state
+        data.continue_reading = False
+
     def _read(self, drv, data):  # NOQA
+        if self._accumulator is not None:
+            self._read_accumulator(data)
+            return True
+
         dta = self._get_enc()
 
         if dta is None:  # ignore no touch & multi touch
@@ -3,11 +3,14 @@
 import lvgl as lv  # NOQA
 import _indev_base
 
+from lcd_utils import KeyMatrix as _KeyMatrix  # NOQA
+
 
 class KeypadDriver(_indev_base.IndevBase):
 
     def __init__(self):  # NOQA
         self._last_key = ord(' ')
+        self._matrix = None
 
         super().__init__()
         self._set_type(lv.INDEV_TYPE.KEYPAD)  # NOQA
@@ -19,11 +22,65 @@ class KeypadDriver(_indev_base.IndevBase):
         # or None if no key event has occured
         raise NotImplementedError
 
+    def enable_matrix(self, rows, cols, keymap=None, debounce=20,
+                      repeat_delay=0, repeat_period=100, diodes=False,
+                      active_low=True, settle=0):
+        # Scans a key matrix in C, _get_key doesn't need to be overridden
+        # when this is used.
+        #
+        # rows and cols are pins, cols need pull ups (pull downs if
+        # active_low is False). A row is switched to output only while it
+        # gets scanned and is an input the rest of the time. keymap is a
+        # flat list of rows * cols key codes (ints or single characters) in
+        # row order. LVGL already repeats held keys so repeat_delay is 0
+        # (off) by default. Set diodes to True if every key has a diode,
+        # that turns off the ghost key check and allows any number of keys
+        # to be held.
+        #
+        # When every column is on the same io expander they get read all at
+        # once from its input register instead of one pin at a time.
+        read = None
+
+        if all(
+            hasattr(col, '_read_inputs') and
+            type(col) is type(cols[0]) and
+            col._device is cols[0]._device  # NOQA
+            for col in cols
+        ):
+            read = cols[0]._read_inputs  # NOQA
+            cols = [col._irq_bit for col in cols]  # NOQA
+
+        self._matrix = _KeyMatrix(
+            rows,
+            cols,
+            keymap,
+            read=read,
+            debounce=debounce,
+            repeat_delay=repeat_delay,
+            repeat_period=repeat_period,
+            diodes=diodes,
+            active_low=active_low,
+            settle=settle
+        )
+
+        return self._matrix
+
     def _read(self, drv, data):  # NOQA
-        key = self._get_key()
+        if self._matrix is not None:
+            key = self._matrix.read()
+            data.continue_reading = self._matrix.pending() > 0
+        else:
+            key = self._get_key()
+
+        if key is None:
+            if self._matrix is not None:
+                # the matrix only queues changes, a key that is still held
+                # has to keep reading as pressed for LVGL's long press and
+                # repeat to work
+                state = self._current_state
+            else:  # ignore no key
+                state = self.RELEASED
 
-        if key is None:  # ignore no key
-            state = self.RELEASED
             key = self._last_key
         else:
             state, key = key
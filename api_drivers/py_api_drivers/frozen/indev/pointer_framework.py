@@ -3,7 +3,11 @@
 import lvgl as lv  # NOQA
 import _indev_base
 import micropython  # NOQA
+import task_handler
 from lcd_utils import remap as _remap  # NOQA
+from lcd_utils import TouchTransform as _TouchTransform  # NOQA
+from lcd_utils import TouchTracker as _TouchTracker  # NOQA
+from lcd_utils import TouchRing as _TouchRing  # NOQA
 
 remap = _remap
 
@@ -29,33 +33,199 @@ class PointerDriver(_indev_base.IndevBase):
         self._set_type(lv.INDEV_TYPE.POINTER)  # NOQA
         self._startup_rotation = startup_rotation
 
+        # calibration and startup rotation are applied in C, the transform
+        # is rebuilt only when the calibration changes
+        self._transform = _TouchTransform(
+            self._orig_width, self._orig_height, startup_rotation
+        )
+        self._update_transform()
+
+        # see enable_input_priority
+        self._input_priority = False
+
+        # only used by controllers that report more than a single point,
+        # see _init_multi_touch
+        self._tracker = None
+        self._gesture_cb = None
+        self._last_gesture = None
+
+        # only used when the driver is running from the controller's
+        # interrupt pin, see enable_interrupt
+        self._ring = None
+        self._int_pin = None
+        self._int_timer = None
+        self._int_last = (self.RELEASED, -1, -1)
+        self._last_ticks = None
+
         self._indev_drv.enable(True)
 
-    def enable_input_priority(self):
-        self._indev_drv.set_mode(lv.INDEV_MODE.EVENT)  # NOQA
-        self.__timer = lv.timer_create(self.__ip_callback, 33, None)  # NOQA
-        self.__timer.set_repeat_count(-1)  # NOQA
+    def enable_input_priority(self, period=None, hold=None):
+        # While the pointer is pressed the task handler gets boosted, that
+        # shortens the refresh and read periods down to `period` and they
+        # decay back to the task handler's duration `hold` milliseconds after
+        # the release. See TaskHandler.boost.
+        self._input_priority = True
+
+        if period is not None or hold is not None:
+            th = task_handler.TaskHandler._current_instance  # NOQA
+            if th is None:
+                raise RuntimeError('the task handler is not running')
+
+            th.set_boost(
+                th._boost_period if period is None else period,  # NOQA
+                th._boost_hold if hold is None else hold  # NOQA
+            )
+
+    def disable_input_priority(self):
+        self._input_priority = False
+
+    def _boost(self):
+        th = task_handler.TaskHandler._current_instance  # NOQA
+        if th is not None:
+            th.boost()
+
+    def _set_read_period(self, period):
+        super()._set_read_period(period)
+
+        if self._int_timer is None:
+            return
+
+        if period is None:
+            period = self._int_period
+        else:
+            period = min(period, self._int_period)
+
+        self._int_timer.set_period(period)  # NOQA
+
+    def enable_interrupt(self, int_pin, trigger=None, ring_size=16, period=33):
+        # int_pin can be a machine.Pin or an io_expander_framework.Pin.
+        #
+        # The interrupt only stamps the time and schedules a read of the
+        # controller. The samples get queued into a ring buffer and LVGL is
+        # put into event mode so it only reads when there is something in
+        # the ring. While the touch is held the controller is polled every
+        # `period` milliseconds so movement and the release get picked up
+        # from controllers that don't keep pulsing the interrupt pin.
+        if self._ring is not None:
+            self.disable_interrupt()
+
+        if trigger is None:
+            trigger = int_pin.IRQ_FALLING
+
+        self._ring = _TouchRing(self._on_touch_irq, size=ring_size)
+        self._int_last = (self.RELEASED, self._last_x, self._last_y)
+
+        self._int_period = period
+        self._int_timer = lv.timer_create(self._on_touch_poll, period, None)  # NOQA
+        self._int_timer.pause()  # NOQA
+
+        self._set_mode_event()
+
+        handler = self._ring.irq
+
+        try:
+            int_pin.irq(handler=handler, trigger=trigger, hard=True)
+        except TypeError:
+            # io expander pins and ports that don't have hard interrupts
+            int_pin.irq(handler, trigger)
+
+        self._int_pin = int_pin
+
+    def disable_interrupt(self):
+        if self._ring is None:
+            return
+
+        self._int_pin.irq(None)
+        self._int_pin = None
+
+        self._int_timer.delete()  # NOQA
+        self._int_timer = None
+
+        self._ring.clear()
+        self._ring = None
+
+        self._indev_drv.set_mode(lv.INDEV_MODE.TIMER)  # NOQA
+
+    def get_last_ticks_us(self):
+        # time.ticks_us() of the interrupt edge that produced the last
+        # point handed to LVGL, None when not running from the interrupt
+        return self._last_ticks
+
+    def _on_touch_irq(self, ring):
+        # scheduled from the interrupt handler
+        ticks = ring.edge()
+        if ticks is None:
+            return
+
+        self._queue_touch(ticks)
+
+    def _on_touch_poll(self, _):
+        self._queue_touch(None)
+
+    def _queue_touch(self, ticks):
+        coords = self._get_coords()
+
+        if coords is None:
+            state = self.RELEASED
+            x, y = self._int_last[1:]
+        else:
+            state, x, y = coords
+            if None in (x, y):
+                x, y = self._int_last[1:]
+
+        # a release is only queued once, the controllers that pulse the
+        # interrupt pin after the release don't flood the ring
+        if state == self.RELEASED and self._int_last[0] == self.RELEASED:
+            return
+
+        self._int_last = (state, x, y)
+        self._ring.put(state, x, y, ticks)
+
+        if state == self.PRESSED:
+            self._int_timer.resume()  # NOQA
+        else:
+            self._int_timer.pause()  # NOQA
 
-    def __ip_callback(self, _):
         self.read()
-        last_state = self._last_state
 
-        while self._last_state == self.PRESSED:
-            lv.refr_now(self._disp_drv)
-            self.read()
+    def _get_ring_coords(self, data):
+        event = self._ring.get()
+
+        if event is None:
+            return self._last_state, self._last_x, self._last_y
 
-        if last_state == self.PRESSED:
-            lv.refr_now(self._disp_drv)
+        state, x, y, self._last_ticks = event
+        data.continue_reading = bool(self._ring)
+
+        return state, x, y
 
     def calibrate(self):
         import touch_calibrate
 
         if touch_calibrate.calibrate(self, self._cal):  # NOQA
             self._cal.save()
+            self._update_transform()
             return True
 
         return False
 
+    def _update_transform(self):
+        cal = self._cal
+
+        if self.is_calibrated:
+            self._transform.set_calibration(
+                cal.alphaX,
+                cal.betaX,
+                cal.deltaX,
+                cal.alphaY,
+                cal.betaY,
+                cal.deltaY,
+                cal.mirrorX,
+                cal.mirrorY
+            )
+        else:
+            self._transform.clear_calibration()
+
     @property
     def is_calibrated(self):
         cal = self._cal
@@ -71,6 +241,55 @@ class PointerDriver(_indev_base.IndevBase):
             cal.mirrorY
         )
 
+    def _init_multi_touch(self, max_contacts, point_format):
+        # The tracker keeps the contacts matched up by their tracking id and
+        # works out the two finger gestures. The primary (first down) contact
+        # is what gets passed to LVGL.
+        self._tracker = _TouchTracker(
+            max_contacts=max_contacts,
+            format=point_format,
+            transform=self._transform
+        )
+
+    def _update_contacts(self, points, count):
+        # returns (state, x, y) of the primary contact or None if there are
+        # no contacts, to be used as the return value from _get_coords
+        point = self._tracker.update(points, count)
+
+        if self._gesture_cb is not None:
+            gesture = self._tracker.gesture()
+            if gesture is not None or self._last_gesture is not None:
+                self._gesture_cb(gesture)
+
+            self._last_gesture = gesture
+
+        if point is None:
+            return None
+
+        return self.PRESSED, point[0], point[1]
+
+    def get_contacts(self):
+        if self._tracker is None:
+            return ()
+
+        return tuple(
+            (id_,) + self._calc_coords(x, y)
+            for id_, x, y in self._tracker.contacts()
+        )
+
+    def get_touch_gesture(self):
+        # (gesture, scale, rotation, pan_x, pan_y) or None
+        if self._tracker is None:
+            return None
+
+        return self._tracker.gesture()
+
+    def set_touch_gesture_cb(self, callback):
+        # callback(gesture) gets called on every read while there is a two
+        # finger gesture and once with None after it ends
+        self._gesture_cb = callback
+        self._last_gesture = None
+
     def _get_coords(self):
         # this method needs to be overridden.
         # the returned value from this method is going to be a tuple
@@ -78,38 +297,16 @@ class PointerDriver(_indev_base.IndevBase):
         raise NotImplementedError
 
     def _calc_coords(self, x, y):
-        if self.is_calibrated:  
-            cal = self._cal
-
-            # save original x value for use in y calculation
-            xt = x
-            x = int(round(x * cal.alphaX + y * cal.betaX + cal.deltaX))
-            y = int(round(xt * cal.alphaY + y * cal.betaY + cal.deltaY))
-
-            if cal.mirrorX:
-                x = self._orig_width - x - 1
-            if cal.mirrorY:
-                y = self._orig_height - y - 1
-        else:
-            if (
-                self._startup_rotation == lv.DISPLAY_ROTATION._180 or  # NOQA
-                self._startup_rotation == lv.DISPLAY_ROTATION._270  # NOQA
-            ):
-                x = self._orig_width - x - 1
-                y = self._orig_height - y - 1
-
-            if (
-                self._startup_rotation == lv.DISPLAY_ROTATION._90 or  # NOQA
-                self._startup_rotation == lv.DISPLAY_ROTATION._270  # NOQA
-            ):
-                x, y = self._orig_height - y - 1, x
-
-        return x, y
+        return self._transform.map(x, y)
 
     def _read(self, drv, data):  # NOQA
-        coords = self._get_coords()
         data.continue_reading = False
 
+        if self._ring is None:
+            coords = self._get_coords()
+        else:
+            coords = self._get_ring_coords(data)
+
         if coords is None:
             state = self.RELEASED
             x, y = self._last_x, self._last_y
@@ -125,6 +322,9 @@ class PointerDriver(_indev_base.IndevBase):
 
         data.state = state
 
+        if state == self.PRESSED and self._input_priority:
+            self._boost()
+
         if (
             self._debug and
             (x != self._last_x or
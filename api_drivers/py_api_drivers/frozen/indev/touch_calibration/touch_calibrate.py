@@ -5,6 +5,7 @@ import time
 
 import task_handler
 import lcd_bus
+import lcd_utils
 
 
 style = lv.style_t()
@@ -45,23 +46,21 @@ def calibrate(indev, cal_data):
     width = indev._orig_width  # NOQA
     height = indev._orig_height  # NOQA
 
-    coords = [
-        [20, 20],  # upper left
-        [width - 40, 20],  # upper right
-        [20, height - 40]  # lower left
-    ]
-
+    # the solver does a least squares fit so more than the 3 points an
+    # affine transform needs get collected. A bad point only stands out
+    # from a fit of the other points when there are enough of them, so a
+    # 3 x 3 grid gets used.
     target_points = [
-        dict(x=30, y=30),  # upper left
-        dict(x=width - 30, y=30),  # upper right
-        dict(x=30, y=height - 30),  # lower left
+        dict(x=x, y=y)
+        for y in (30, height // 2, height - 30)
+        for x in (30, width // 2, width - 30)
     ]
 
-    captured_points = [
-        dict(x=[], y=[]),
-        dict(x=[], y=[]),
-        dict(x=[], y=[])
-    ]
+    # position of the 20 x 20 target so it is centered on the target point
+    coords = [[point['x'] - 10, point['y'] - 10] for point in target_points]
+
+    captured_points = [dict(x=[], y=[]) for _ in target_points]
+    num_points = len(target_points)
 
     old_scrn = lv.screen_active()  # NOQA
 
@@ -110,10 +109,10 @@ def calibrate(indev, cal_data):
     target.remove_flag(lv.obj.FLAG.SCROLLABLE)  # NOQA
 
     instruction_text = 'Press and hold\n  red square'
-    for i in range(3):
-        print('point', i + 1, 'of 3')
+    for i in range(num_points):
+        print('point', i + 1, 'of', num_points)
 
-        label.set_text(f'Point {i + 1} of 3')
+        label.set_text(f'Point {i + 1} of {num_points}')
         label.center()
 
         target.set_pos(*coords[i])
@@ -186,7 +185,7 @@ def calibrate(indev, cal_data):
         points['x'] = int(sum(points['x']) / 6)
         points['y'] = int(sum(points['y']) / 6)
 
-        print('  point', i + 1, 'of 3:', (points['x'], points['y']))
+        print('  point', i + 1, f'of {num_points}:', (points['x'], points['y']))
         label.set_text(
             f'Averaged trimmed point {i + 1}\n'
             f'x: {points["x"]}\n'
@@ -210,7 +209,8 @@ def calibrate(indev, cal_data):
     # else:
     #     mirror_y = False
 
-    # The 3 point method uses an affine transformation so mirroring should not be needed.
+    # The points get a least squares affine fit, mirroring and swapped axes
+    # are part of that fit so they don't need to be detected here.
     mirror_x = False
     mirror_y = False
 
@@ -218,47 +218,29 @@ def calibrate(indev, cal_data):
     print('  mirrored x:', mirror_x)
     print('  mirrored y:', mirror_y)
 
-    tp1, tp2, tp3 = captured_points
-    sp1, sp2, sp3 = target_points
     print()
     print('calibration values')
     try:
-        divisor = float(
-            tp1['x'] * (tp3['y'] - tp2['y']) - tp2['x'] * tp3['y'] +
-            tp2['y'] * tp3['x'] + tp1['y'] * (tp2['x'] - tp3['x'])
+        (
+            alphaX, betaX, deltaX, alphaY, betaY, deltaY, rms, residuals, rejected
+        ) = lcd_utils.solve_touch_cal(
+            [(point['x'], point['y']) for point in captured_points],
+            [(point['x'], point['y']) for point in target_points]
         )
-        alphaX = float(
-            sp1['x'] * (tp3['y'] - tp2['y']) - sp2['x'] * tp3['y'] +
-            sp3['x'] * tp2['y'] + (sp2['x'] - sp3['x']) * tp1['y']
-        ) / divisor
+
         print('  alphaX:', alphaX)
-        betaX = -float(
-            sp1['x'] * (tp3['x'] - tp2['x']) - sp2['x'] * tp3['x'] +
-            sp3['x'] * tp2['x'] + (sp2['x'] - sp3['x']) * tp1['x']
-        ) / divisor
         print('  betaX:', betaX)
-        deltaX = float(
-            sp1['x'] * (tp2['y'] * tp3['x'] - tp2['x'] * tp3['y']) +
-            tp1['x'] * (sp2['x'] * tp3['y'] - sp3['x'] * tp2['y']) +
-            tp1['y'] * (sp3['x'] * tp2['x'] - sp2['x'] * tp3['x'])
-        ) / divisor
         print('  deltaX:', deltaX)
-        alphaY = float(
-            sp1['y'] * (tp3['y'] - tp2['y']) - sp2['y'] * tp3['y'] +
-            sp3['y'] * tp2['y'] + (sp2['y'] - sp3['y']) * tp1['y']
-        ) / divisor
         print('  alphaY:', alphaY)
-        betaY = -float(
-            sp1['y'] * (tp3['x'] - tp2['x']) - sp2['y'] * tp3['x'] +
-            sp3['y'] * tp2['x'] + (sp2['y'] - sp3['y']) * tp1['x']
-        ) / divisor
         print('  betaY:', betaY)
-        deltaY = float(
-            sp1['y'] * (tp2['y'] * tp3['x'] - tp2['x'] * tp3['y']) +
-            tp1['x'] * (sp2['y'] * tp3['y'] - sp3['y'] * tp2['y']) +
-            tp1['y'] * (sp3['y'] * tp2['x'] - sp2['y'] * tp3['x'])
-        ) / divisor
         print('  deltaY:', deltaY)
+        print('  rms error:', rms)
+
+        for i, residual in enumerate(residuals):
+            print(
+                '  point', i + 1, 'error:', residual,
+                '(rejected)' if i in rejected else ''
+            )
 
         cal_data.alphaX = alphaX
         cal_data.betaX = betaX
@@ -275,16 +257,17 @@ def calibrate(indev, cal_data):
             f'alphaX: {round(alphaX, 6)}\n'
             f'betaX: {round(betaX, 6)}\n'
             f'deltaX: {round(deltaX, 6)}\n'
-            f'alphaY: {round(betaX, 6)}\n'
-            f'betaY: {round(alphaX, 6)}\n'
-            f'deltaY: {round(betaX, 6)}'
+            f'alphaY: {round(alphaY, 6)}\n'
+            f'betaY: {round(betaY, 6)}\n'
+            f'deltaY: {round(deltaY, 6)}\n'
+            f'error: {round(rms, 2)}px'
         )
         label.center()
         lcd_bus._pump_main_thread()  # NOQA
         time.sleep_ms(5000)  # NOQA
 
-    except ZeroDivisionError:
-        print('Error in calculation please try again.')
+    except ValueError as err:
+        print('Error in calculation please try again.', err)
         res = False
         label.set_text('ERROR')
         label.center()
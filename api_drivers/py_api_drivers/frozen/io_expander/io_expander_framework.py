@@ -1,6 +1,37 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 import machine
 import lcd_utils
+import sys
+
+
+# task_handler.TaskHandler uses timer 0 by default
+_default_timer_id = 1
+
+if sys.platform in ('pyboard', 'rp2'):
+    _default_timer_id = -1
+
+
+class _Batch(object):
+
+    def __init__(self, pin_cls):
+        self._pin_cls = pin_cls
+
+    def __enter__(self):
+        self._pin_cls._batch_depth += 1
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        cls = self._pin_cls
+        cls._batch_depth -= 1
+
+        # the registers get written even if there was an exception so the
+        # expander doesn't end up out of step with the shadow
+        if cls._batch_depth == 0 and cls._dirty_regs:
+            dirty_regs = cls._dirty_regs
+            cls._dirty_regs = {}
+
+            for reg, pin in dirty_regs.items():
+                pin._flush_reg(reg)  # NOQA
 
 
 class Pin(object):
@@ -16,44 +47,56 @@ class Pin(object):
 
     _int_pin = None
     _reg_int_pins = []
+    _demux = None
+    _debounce_timer = None
 
     _device = None
 
+    # The drivers keep a shadow of the output and direction registers as
+    # class attributes, a pin change only updates the shadow and then calls
+    # _commit. Inside of a batch() the register write is held back until the
+    # batch ends so changes to several pins go out as a single write.
+    _batch_depth = 0
+    _dirty_regs = None
+
     @classmethod
     def _int_cb(cls, _):
-        for ext_pin in cls._reg_int_pins:
-            ext_pin._interrupt_cb()  # NOQA
-
-    def _interrupt_cb(self):
-        if self._irq is None:
-            # sanity check
-            return
-
-        value = self.value()
-        if value == self._irq_input_state:
-            return
-
-        self._irq_input_state = value
-
-        handler, trigger = self._irq
+        # The input register gets read once and the demux in lcd_utils
+        # works out which pins changed, does the edge filtering and the
+        # debouncing and then calls only the handlers of those pins.
+        cls._demux.process()
+
+        # A change inside of the debounce time gets dropped. Reading the
+        # input register clears the expander's interrupt, so if the pin
+        # stays at the new level there is no other interrupt for it and the
+        # register has to be read again once the debounce time is up.
+        delay = cls._demux.pending()
+        if delay != -1:
+            cls._debounce_timer.init(
+                mode=machine.Timer.ONE_SHOT,
+                period=max(delay, 1),
+                callback=cls._int_cb
+            )
 
-        if value and trigger & self.IRQ_RISING:
-            handler(self)
+    @classmethod
+    def _read_int_states(cls):
+        if not cls._reg_int_pins:
+            return 0
 
-        elif not value and trigger & self.IRQ_FALLING:
-            handler(self)
+        return cls._reg_int_pins[0]._read_inputs()  # NOQA
 
     @classmethod
-    def set_int_pin(cls, pin_num, pull=-1):
+    def set_int_pin(cls, pin_num, pull=-1, debounce=0, timer_id=_default_timer_id):
+        # debounce is in milliseconds, timer_id is the machine.Timer that is
+        # used to read the pins again when the debounce time is up. It only
+        # gets used if debounce is set.
         if cls._int_pin is not None:
             raise ValueError('Interrupt pin has already been set')
 
-        try:
-            cls._int_cb(None)
-        except NotImplementedError:
-            raise NotImplementedError
-        except:  # NOQA
-            pass
+        cls._demux = lcd_utils.PinDemux(cls._read_int_states, debounce=debounce)
+
+        if debounce > 0:
+            cls._debounce_timer = machine.Timer(timer_id)
 
         if pull == -1:
             int_pin = machine.Pin(pin_num, machine.Pin.IN)
@@ -66,6 +109,26 @@ class Pin(object):
         )
         cls._int_pin = int_pin
 
+    @classmethod
+    def batch(cls):
+        # with Pin.batch():
+        #     reset_pin.value(1)
+        #     backlight_pin.value(1)
+        #     power_pin.value(1)
+        if cls._dirty_regs is None:
+            cls._dirty_regs = {}
+
+        return _Batch(cls)
+
+    def _commit(self, reg):
+        cls = self.__class__
+
+        if cls._batch_depth:
+            if reg not in cls._dirty_regs:
+                cls._dirty_regs[reg] = self
+        else:
+            self._flush_reg(reg)
+
     @classmethod
     def set_device(cls, device):
         if cls._device is not None:
@@ -111,8 +174,12 @@ class Pin(object):
             self._irq_input_state = self.value()
             self._set_irq(handler, trigger=trigger)
 
+            demux = self.__class__._demux
+
             if handler is None:
                 self._irq = None
+                demux.unregister(self._irq_bit)
+
                 if self in self.__class__._reg_int_pins:
                     self.__class__._reg_int_pins.remove(self)
             else:
@@ -120,6 +187,13 @@ class Pin(object):
                     self.__class__._reg_int_pins.append(self)
 
                 self._irq = (handler, trigger)
+                demux.register(
+                    self._irq_bit,
+                    handler,
+                    trigger,
+                    self,
+                    self._irq_input_state
+                )
 
     def value(self, x=-1):
         if x != -1:
@@ -151,6 +225,20 @@ class Pin(object):
 
         self.init(mode=mode)
 
+    def _flush_reg(self, reg):
+        # writes the shadow of reg to the expander
+        raise NotImplementedError
+
+    @property
+    def _irq_bit(self):
+        # the bit for this pin in the value returned from _read_inputs
+        raise NotImplementedError
+
+    def _read_inputs(self):
+        # reads the input register(s) of the expander, reading the input
+        # register is also what clears the interrupt
+        raise NotImplementedError
+
     def _set_irq(self, handler, trigger):
         raise NotImplementedError
 
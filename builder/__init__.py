@@ -8,6 +8,8 @@ import threading
 import random
 import queue
 
+from . import init_seq_compiler
+
 _windows_env = None
 
 
@@ -228,6 +230,9 @@ def generate_manifest(
     if not os.path.exists('build'):
         os.mkdir('build')
 
+    if os.path.exists('build/display_init'):
+        shutil.rmtree('build/display_init')
+
     manifest_files = [
         f"include('{os.path.abspath(manifest_path)}')"
     ]
@@ -448,9 +453,18 @@ def generate_manifest(
                 if not file_name.endswith('.py'):
                     continue
 
-                print(os.path.join(tmp_file, file_name))
+                # the initialization modules get compiled into binary
+                # init sequences, see init_seq_compiler.py
+                src_file = os.path.join(tmp_file, file_name)
+                frozen_file = init_seq_compiler.compile_file(
+                    src_file,
+                    os.path.join('build', 'display_init', file.lower())
+                )
+
+                print(frozen_file)
 
-                entry = f"freeze('{tmp_file}', '{file_name}')"
+                frozen_path = os.path.abspath(os.path.dirname(frozen_file))
+                entry = f"freeze('{frozen_path}', '{file_name}')"
                 if entry not in manifest_files:
                     manifest_files.append(entry)
         else:
@@ -468,6 +482,196 @@ def generate_manifest(
     return display_paths
 
 
+LV_USAGE_FILE = 'build/lv_usage.json'
+
+
+def _scan_lv_usage_file(file, names):
+    import ast
+
+    with open(file, 'r', encoding='utf-8') as f:
+        try:
+            tree = ast.parse(f.read(), file)
+        except SyntaxError:
+            # not all frozen files are CPython compatible (viper, asm_thumb)
+            # so when a file cannot be parsed fall back to grabbing anything
+            # that looks like an identifier.
+            import re
+
+            f.seek(0)
+            names.update(re.findall(r'[A-Za-z_][A-Za-z0-9_]*', f.read()))
+            return
+
+    for node in ast.walk(tree):
+        if isinstance(node, ast.Attribute):
+            names.add(node.attr)
+        elif isinstance(node, ast.ImportFrom) and node.module == 'lvgl':
+            names.update(alias.name for alias in node.names)
+        elif (
+            isinstance(node, ast.Constant) and
+            isinstance(node.value, str) and
+            node.value.isidentifier()
+        ):
+            # getattr(lv, 'some_name')
+            names.add(node.value)
+
+
+def _scan_lv_usage_manifest(manifest_path, names, scanned):
+    manifest_path = os.path.abspath(manifest_path)
+
+    if manifest_path in scanned:
+        return
+
+    scanned.add(manifest_path)
+    manifest_dir = os.path.dirname(manifest_path)
+
+    def _resolve(path):
+        # paths that use the MicroPython path variables point into the
+        # MicroPython source tree which never uses lvgl.
+        if '$(' in path:
+            return None
+
+        if not os.path.isabs(path):
+            path = os.path.join(manifest_dir, path)
+
+        return os.path.abspath(path)
+
+    def _scan_path(path, files=None):
+        if path is None or not os.path.exists(path):
+            return
+
+        if os.path.isfile(path):
+            if path.endswith('.py'):
+                _scan_lv_usage_file(path, names)
+            return
+
+        if files is None:
+            for root, _, file_names in os.walk(path):
+                for file_name in file_names:
+                    if file_name.endswith('.py'):
+                        _scan_lv_usage_file(os.path.join(root, file_name), names)
+            return
+
+        if isinstance(files, str):
+            files = [files]
+
+        for file_name in files:
+            _scan_path(os.path.join(path, file_name))
+
+    def include(path, **_):
+        path = _resolve(path)
+        if path is None:
+            return
+
+        if os.path.isdir(path):
+            path = os.path.join(path, 'manifest.py')
+
+        if os.path.exists(path):
+            _scan_lv_usage_manifest(path, names, scanned)
+
+    def freeze(path, script=None, **_):
+        _scan_path(_resolve(path), script)
+
+    def module(module_path, base_path='.', **_):
+        base_path = _resolve(base_path)
+        if base_path is not None:
+            _scan_path(os.path.join(base_path, module_path))
+
+    def package(package_path, files=None, base_path='.', **_):
+        base_path = _resolve(base_path)
+        if base_path is not None:
+            _scan_path(os.path.join(base_path, package_path), files)
+
+    def _noop(*_, **__):
+        pass
+
+    with open(manifest_path, 'r') as f:
+        code = f.read()
+
+    exec(code, {  # NOQA
+        'include': include,
+        'freeze': freeze,
+        'freeze_as_str': freeze,
+        'freeze_as_mpy': freeze,
+        'freeze_mpy': freeze,
+        'module': module,
+        'package': package,
+        'require': _noop,
+        'options': type('options', (), {'__getattr__': lambda *_: None})(),
+        'metadata': _noop,
+        'add_library': _noop
+    })
+
+
+def generate_lv_usage(lv_usage):
+    """
+    Writes the list of LVGL names the firmware uses so the binding generator
+    is able to leave out everything else. The file is always written, the
+    names are null when `lv_usage` is empty. The make based ports rebuild the
+    bindings when it changes so going back to the full API doesn't leave the
+    reduced bindings in place.
+
+    `lv_usage` is a comma separated list. Each entry is one of the following.
+
+        * "scan": every Python source file that gets frozen into the
+          firmware (build/manifest.py) is scanned for attribute names.
+        * path to a ".py" file: the file is scanned the same way.
+        * path to any other file: the file is an allow list, one name per
+          line. Names are the same ones used from Python,
+          "label", "obj.set_style_bg_color", "FLEX_FLOW" etc...
+          Blank lines and lines starting with "#" are ignored.
+        * anything else is taken as a name.
+    """
+    import json
+
+    names = set()
+
+    for entry in (lv_usage or '').split(','):
+        entry = entry.strip()
+        if not entry:
+            continue
+
+        if entry == 'scan':
+            _scan_lv_usage_manifest('build/manifest.py', names, set())
+        elif os.path.isfile(entry):
+            if entry.endswith('.py'):
+                _scan_lv_usage_file(entry, names)
+                continue
+
+            with open(entry, 'r') as f:
+                for line in f:
+                    line = line.split('#', 1)[0].strip()
+                    if line:
+                        names.add(line)
+        else:
+            names.add(entry)
+
+    for name in list(names):
+        # "obj.set_width" style entries
+        names.update(name.split('.'))
+
+    if not os.path.exists('build'):
+        os.mkdir('build')
+
+    if lv_usage:
+        data = json.dumps({'names': sorted(names)}, indent=4)
+        print(f'LVGL usage: {len(names)} names written to {LV_USAGE_FILE}')
+    else:
+        data = json.dumps({'names': None}, indent=4)
+
+    # only written when it changes, a newer file makes make regenerate the
+    # bindings
+    if os.path.exists(LV_USAGE_FILE):
+        with open(LV_USAGE_FILE, 'r') as f:
+            if f.read() == data:
+                data = None
+
+    if data is not None:
+        with open(LV_USAGE_FILE, 'w') as f:
+            f.write(data)
+
+    os.environ['LV_USAGE_FILE'] = os.path.abspath(LV_USAGE_FILE)
+
+
 def get_lvgl():
     cmd_ = [
         'git submodule update --init --depth=1 -- lib/lvgl'
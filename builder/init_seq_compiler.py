@@ -0,0 +1,529 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+# Compiles the display initialization modules (_<display>_init*.py) into
+# binary init sequences.
+#
+# Those modules are mostly long runs of
+#
+#     param_buf[:n] = bytearray([...])
+#     self.set_params(cmd, param_mv[:n])
+#     time.sleep_ms(ms)
+#
+# Every line allocates and crosses into C. Runs of those statements that only
+# use constant values get replaced by a single call to
+# DisplayDriver._send_init_seq() with a bytes literal. When frozen the bytes
+# object is in flash and lcd_bus plays it back in C. Anything that is not
+# constant (reading from the display, using attributes of the driver, if
+# blocks...) stays as Python code.
+#
+# The format is what lcd_bus.Bus.tx_init_seq() reads (modlcd_bus.h)
+#
+#     0x01 cmd:u8                len:u8           params
+#     0x02 cmd:u16               len:u8           params
+#     0x03 cmd:u32               len:u16          params
+#     0x04 ms:u16                                  delay
+#     0x05 count:u8              length:u16       repeat the next "length"
+#                                                  bytes "count" times
+#     0x00                                         end (optional)
+#
+# all multi byte values are little endian.
+
+import os
+import ast
+
+
+SEQ_END = 0x00
+SEQ_CMD8 = 0x01
+SEQ_CMD16 = 0x02
+SEQ_CMD32 = 0x03
+SEQ_DELAY = 0x04
+SEQ_REPEAT = 0x05
+
+# a run has to have at least this many commands to be worth replacing
+MIN_RUN_COMMANDS = 2
+
+MAX_REPEAT_WINDOW = 4
+
+
+def encode_cmd(cmd, params):
+    params = bytes(params)
+
+    if cmd <= 0xFF and len(params) <= 0xFF:
+        return bytes([SEQ_CMD8, cmd, len(params)]) + params
+    if cmd <= 0xFFFF and len(params) <= 0xFF:
+        return bytes([SEQ_CMD16]) + cmd.to_bytes(2, 'little') + bytes([len(params)]) + params
+
+    return bytes([SEQ_CMD32]) + cmd.to_bytes(4, 'little') + len(params).to_bytes(2, 'little') + params
+
+
+def encode_delay(ms):
+    res = b''
+    while ms > 0:
+        chunk = min(ms, 0xFFFF)
+        res += bytes([SEQ_DELAY]) + chunk.to_bytes(2, 'little')
+        ms -= chunk
+
+    return res
+
+
+def encode_records(records):
+    # records is a list of already encoded records. Consecutive repeats of
+    # 1 to MAX_REPEAT_WINDOW records get collapsed into a repeat opcode.
+    res = b''
+    i = 0
+
+    while i < len(records):
+        best = None
+
+        for window in range(1, MAX_REPEAT_WINDOW + 1):
+            block = records[i:i + window]
+            if len(block) != window:
+                break
+
+            count = 1
+            while (
+                count < 0xFF and
+                records[i + count * window:i + (count + 1) * window] == block
+            ):
+                count += 1
+
+            body = b''.join(block)
+            saved = len(body) * (count - 1) - 4
+
+            if count > 1 and len(body) <= 0xFFFF and saved > 0:
+                if best is None or saved > best[2]:
+                    best = (window, count, saved)
+
+        if best is None:
+            res += records[i]
+            i += 1
+        else:
+            window, count, _ = best
+            body = b''.join(records[i:i + window])
+            res += bytes([SEQ_REPEAT, count]) + len(body).to_bytes(2, 'little') + body
+            i += window * count
+
+    return res
+
+
+class _Compiler:
+
+    def __init__(self, module):
+        self.constants = {}
+        self.converted = 0
+
+        for node in module.body:
+            # _NAME = const(value) and _NAME = value at the module level
+            if (
+                isinstance(node, ast.Assign) and
+                len(node.targets) == 1 and
+                isinstance(node.targets[0], ast.Name)
+            ):
+                value = node.value
+                if (
+                    isinstance(value, ast.Call) and
+                    isinstance(value.func, ast.Name) and
+                    value.func.id == 'const' and
+                    len(value.args) == 1
+                ):
+                    value = value.args[0]
+
+                value = self.eval_int(value)
+                if value is not None:
+                    self.constants[node.targets[0].id] = value
+
+    def eval_int(self, node):
+        if isinstance(node, ast.Constant) and type(node.value) is int:
+            return node.value
+        if isinstance(node, ast.Name) and node.id in self.constants:
+            return self.constants[node.id]
+        if isinstance(node, ast.UnaryOp) and isinstance(node.op, ast.USub):
+            value = self.eval_int(node.operand)
+            return None if value is None else -value
+        if isinstance(node, ast.BinOp):
+            left = self.eval_int(node.left)
+            right = self.eval_int(node.right)
+            if left is None or right is None:
+                return None
+
+            ops = {
+                ast.BitOr: lambda l, r: l | r,
+                ast.BitAnd: lambda l, r: l & r,
+                ast.LShift: lambda l, r: l << r,
+                ast.RShift: lambda l, r: l >> r,
+                ast.Add: lambda l, r: l + r,
+                ast.Sub: lambda l, r: l - r,
+                ast.Mult: lambda l, r: l * r,
+            }
+            op = ops.get(type(node.op), None)
+            return None if op is None else op(left, right)
+
+        return None
+
+    def eval_bytes(self, node):
+        # bytearray([...]), bytes([...]), b'...'
+        if isinstance(node, ast.Constant) and isinstance(node.value, bytes):
+            return list(node.value)
+
+        if (
+            isinstance(node, ast.Call) and
+            isinstance(node.func, ast.Name) and
+            node.func.id in ('bytearray', 'bytes') and
+            len(node.args) == 1 and
+            not node.keywords and
+            isinstance(node.args[0], (ast.List, ast.Tuple))
+        ):
+            values = [self.eval_int(elt) for elt in node.args[0].elts]
+            if None in values or any(not 0 <= v <= 0xFF for v in values):
+                return None
+            return values
+
+        return None
+
+    @staticmethod
+    def eval_slice(node, constant):
+        # returns (start, stop) for x[:n], x[a:b] and x[i]
+        if isinstance(node, ast.Slice):
+            if node.step is not None:
+                return None
+            start = 0 if node.lower is None else constant(node.lower)
+            stop = None if node.upper is None else constant(node.upper)
+            if start is None or stop is None:
+                return None
+            return start, stop
+
+        index = constant(node)
+        if index is None:
+            return None
+        return index, index + 1
+
+
+class _Block:
+    """
+    Tracks what is known about the parameter buffer while walking the
+    statements of a single block.
+    """
+
+    def __init__(self, compiler, buf_names, mv_names):
+        self.compiler = compiler
+        self.buf_names = buf_names
+        self.mv_names = mv_names
+        self.buf = {}
+
+        self.run_statements = []
+        self.run_records = []
+        self.run_commands = 0
+        # buffer contents at the start of the run
+        self.run_buf = {}
+
+    def is_buf(self, node):
+        return isinstance(node, ast.Name) and node.id in self.buf_names
+
+    def is_mv(self, node):
+        return isinstance(node, ast.Name) and node.id in (self.mv_names | self.buf_names)
+
+    def static_statement(self, stmt):
+        # returns True if the statement got consumed
+        compiler = self.compiler
+
+        # param_buf[...] = ...
+        if (
+            isinstance(stmt, ast.Assign) and
+            len(stmt.targets) == 1 and
+            isinstance(stmt.targets[0], ast.Subscript) and
+            self.is_buf(stmt.targets[0].value)
+        ):
+            target = stmt.targets[0]
+            span = compiler.eval_slice(target.slice, compiler.eval_int)
+            if span is None:
+                return False
+
+            start, stop = span
+            if isinstance(target.slice, ast.Slice):
+                values = compiler.eval_bytes(stmt.value)
+            else:
+                value = compiler.eval_int(stmt.value)
+                values = None if value is None or not 0 <= value <= 0xFF else [value]
+
+            if values is None or len(values) != stop - start:
+                return False
+
+            for i, value in enumerate(values):
+                self.buf[start + i] = value
+
+            self.run_statements.append(stmt)
+            return True
+
+        if not isinstance(stmt, ast.Expr) or not isinstance(stmt.value, ast.Call):
+            return False
+
+        call = stmt.value
+        func = call.func
+
+        if call.keywords or not isinstance(func, ast.Attribute):
+            return False
+
+        # self.set_params(cmd) / self.set_params(cmd, param_mv[...])
+        if (
+            isinstance(func.value, ast.Name) and
+            func.value.id == 'self' and
+            func.attr == 'set_params' and
+            len(call.args) in (1, 2)
+        ):
+            cmd = compiler.eval_int(call.args[0])
+            if cmd is None or cmd < 0:
+                return False
+
+            if len(call.args) == 1 or (
+                isinstance(call.args[1], ast.Constant) and
+                call.args[1].value is None
+            ):
+                params = []
+            else:
+                arg = call.args[1]
+                if isinstance(arg, ast.Subscript):
+                    if not self.is_mv(arg.value) or not isinstance(arg.slice, ast.Slice):
+                        return False
+
+                    span = compiler.eval_slice(arg.slice, compiler.eval_int)
+                    if span is None:
+                        return False
+
+                    start, stop = span
+                    params = [self.buf.get(i, None) for i in range(start, stop)]
+                    if None in params:
+                        return False
+                else:
+                    # self.set_params(cmd, bytearray([...]))
+                    params = compiler.eval_bytes(arg)
+                    if params is None:
+                        return False
+
+            self.run_records.append(encode_cmd(cmd, params))
+            self.run_commands += 1
+            self.run_statements.append(stmt)
+            return True
+
+        # time.sleep_ms(ms), time.sleep_us(us), time.sleep(s)
+        if (
+            isinstance(func.value, ast.Name) and
+            func.value.id == 'time' and
+            func.attr in ('sleep_ms', 'sleep_us', 'sleep') and
+            len(call.args) == 1
+        ):
+            value = compiler.eval_int(call.args[0])
+            if value is None or value < 0:
+                return False
+
+            if func.attr == 'sleep_us':
+                ms = (value + 999) // 1000
+            elif func.attr == 'sleep':
+                ms = value * 1000
+            else:
+                ms = value
+
+            self.run_records.append(encode_delay(ms))
+            self.run_statements.append(stmt)
+            return True
+
+        return False
+
+    def flush(self, more_follows):
+        statements = self.run_statements
+
+        if self.run_commands < MIN_RUN_COMMANDS:
+            self.reset_run()
+            return statements
+
+        seq = encode_records(self.run_records)
+
+        res = [
+            ast.Expr(
+                value=ast.Call(
+                    func=ast.Attribute(
+                        value=ast.Name(id='self', ctx=ast.Load()),
+                        attr='_send_init_seq',
+                        ctx=ast.Load()
+                    ),
+                    args=[ast.Constant(value=seq)],
+                    keywords=[]
+                )
+            )
+        ]
+
+        # code after the run might use what is left in the buffer, those
+        # bytes get written once instead of once per command.
+        if more_follows and self.buf_names:
+            changed = sorted(
+                i for i, value in self.buf.items()
+                if self.run_buf.get(i, None) != value
+            )
+
+            buf_name = sorted(self.buf_names)[0]
+            start = None
+
+            for pos, i in enumerate(changed):
+                if start is None:
+                    start = i
+                if pos + 1 == len(changed) or changed[pos + 1] != i + 1:
+                    res.append(
+                        ast.Assign(
+                            targets=[
+                                ast.Subscript(
+                                    value=ast.Name(id=buf_name, ctx=ast.Load()),
+                                    slice=ast.Slice(
+                                        lower=ast.Constant(value=start),
+                                        upper=ast.Constant(value=i + 1)
+                                    ),
+                                    ctx=ast.Store()
+                                )
+                            ],
+                            value=ast.Constant(value=bytes(self.buf[j] for j in range(start, i + 1))),
+                            lineno=0
+                        )
+                    )
+                    start = None
+
+        self.compiler.converted += self.run_commands
+        self.reset_run()
+        return res
+
+    def reset_run(self):
+        self.run_statements = []
+        self.run_records = []
+        self.run_commands = 0
+        self.run_buf = dict(self.buf)
+
+
+def _alias_names(body):
+    # param_buf = bytearray(n) / param_buf = self._param_buf
+    # param_mv = memoryview(param_buf) / param_mv = self._param_mv
+    buf_names = set()
+    mv_names = set()
+    self_buf = False
+    self_mv = set()
+
+    for stmt in body:
+        if (
+            not isinstance(stmt, ast.Assign) or
+            len(stmt.targets) != 1 or
+            not isinstance(stmt.targets[0], ast.Name)
+        ):
+            continue
+
+        name = stmt.targets[0].id
+        value = stmt.value
+
+        if isinstance(value, ast.Attribute) and isinstance(value.value, ast.Name) and value.value.id == 'self':
+            if value.attr == '_param_buf':
+                buf_names.add(name)
+                self_buf = True
+            elif value.attr == '_param_mv':
+                self_mv.add(name)
+        elif isinstance(value, ast.Call) and isinstance(value.func, ast.Name):
+            if value.func.id == 'bytearray':
+                buf_names.add(name)
+            elif (
+                value.func.id == 'memoryview' and
+                len(value.args) == 1 and
+                isinstance(value.args[0], ast.Name) and
+                value.args[0].id in buf_names
+            ):
+                mv_names.add(name)
+
+    # a name that gets assigned more than once can't be trusted
+    assigned = {}
+    for node in ast.walk(ast.Module(body=body, type_ignores=[])):
+        if isinstance(node, ast.Name) and isinstance(node.ctx, ast.Store):
+            assigned[node.id] = assigned.get(node.id, 0) + 1
+
+    # self._param_mv is a view of self._param_buf so it can only be used
+    # when that buffer is the one being tracked
+    if self_buf:
+        mv_names |= self_mv
+
+    buf_names = {name for name in buf_names if assigned.get(name, 0) == 1}
+    mv_names = {name for name in mv_names if assigned.get(name, 0) == 1}
+
+    return buf_names, mv_names
+
+
+def _compile_block(compiler, body, buf_names, mv_names, nested=False):
+    block = _Block(compiler, buf_names, mv_names)
+    res = []
+
+    for i, stmt in enumerate(body):
+        if block.static_statement(stmt):
+            continue
+
+        res.extend(block.flush(True))
+
+        for field in ('body', 'orelse', 'finalbody'):
+            sub_body = getattr(stmt, field, None)
+            if isinstance(sub_body, list) and sub_body and isinstance(sub_body[0], ast.stmt):
+                setattr(stmt, field, _compile_block(compiler, sub_body, buf_names, mv_names, True))
+
+        res.append(stmt)
+
+        # whatever that statement did, the buffer contents are unknown now.
+        block.buf = {}
+        block.reset_run()
+
+    # code after a nested block can still use the buffer
+    res.extend(block.flush(nested))
+    return res
+
+
+def compile_source(source, file_name='<init>'):
+    """
+    Returns the converted source code or None if there was nothing to
+    convert.
+    """
+    module = ast.parse(source, file_name)
+    compiler = _Compiler(module)
+
+    for node in module.body:
+        if not isinstance(node, ast.FunctionDef) or node.name != 'init':
+            continue
+
+        buf_names, mv_names = _alias_names(node.body)
+        node.body = _compile_block(compiler, node.body, buf_names, mv_names)
+
+    if not compiler.converted:
+        return None
+
+    ast.fix_missing_locations(module)
+    return (
+        '# Auto-Generated file, DO NOT EDIT!\n'
+        f'# compiled from {os.path.basename(file_name)} by builder/init_seq_compiler.py\n\n' +
+        ast.unparse(module) + '\n'
+    )
+
+
+def compile_file(src_file, out_path):
+    """
+    Compiles `src_file` into `out_path`. Returns the path to the file that
+    should be frozen, which is `src_file` if there was nothing to compile.
+    """
+    with open(src_file, 'r', encoding='utf-8') as f:
+        source = f.read()
+
+    if 'def init(' not in source:
+        return src_file
+
+    try:
+        converted = compile_source(source, src_file)
+    except SyntaxError:
+        return src_file
+
+    if converted is None:
+        return src_file
+
+    if not os.path.exists(out_path):
+        os.makedirs(out_path)
+
+    out_file = os.path.join(out_path, os.path.basename(src_file))
+    with open(out_file, 'w', encoding='utf-8') as f:
+        f.write(converted)
+
+    return out_file
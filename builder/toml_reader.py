@@ -459,6 +459,9 @@ class TOMLmcu:
             else:
                 build_arg = arg
 
+            if isinstance(value, (list, tuple)):
+                value = ','.join(str(item) for item in value)
+
             if not isinstance(value, bool):
                 build_arg = f'{build_arg}={value}'
 
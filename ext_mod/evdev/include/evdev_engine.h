@@ -0,0 +1,66 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// The event engine has no MicroPython dependencies so it can be built and
+// tested on the host, see tests/test_evdev.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __EVDEV_ENGINE_H__
+    #define __EVDEV_ENGINE_H__
+
+    #define EVDEV_KEY_QUEUE_LEN  (32)  // needs to be a power of 2
+    #define EVDEV_READ_EVENTS    (64)  // input_event structs per read()
+
+    struct input_event;
+
+    typedef struct _evdev_key_event_t {
+        uint16_t code;
+        uint8_t value;  // 0 released, 1 pressed, 2 autorepeat
+    } evdev_key_event_t;
+
+    typedef struct _evdev_state_t {
+        int32_t x;
+        int32_t y;
+        int32_t wheel;      // REL_WHEEL steps since the last wheel() call
+        uint8_t buttons;    // bit n is BTN_MOUSE + n, BTN_TOUCH is bit 0
+    } evdev_state_t;
+
+    typedef struct _evdev_device_t {
+        int fd;
+        bool lost;          // unplugged, the index stays taken until close()
+        bool is_abs;
+        int32_t abs_min[2];
+        int32_t abs_max[2];
+        int32_t width;      // output range, 0 leaves the values alone
+        int32_t height;
+        int32_t slot;       // current ABS_MT_SLOT, only slot 0 moves the point
+        int32_t hat[2];     // last ABS_HAT0X/ABS_HAT0Y
+
+        evdev_state_t state;    // as of the last SYN_REPORT
+        evdev_state_t pending;  // being built up from the events
+        bool dropped;           // SYN_DROPPED, skip until the next SYN_REPORT
+
+        evdev_key_event_t keys[EVDEV_KEY_QUEUE_LEN];
+        uint16_t key_head;
+        uint16_t key_tail;
+    } evdev_device_t;
+
+    // scales an absolute axis (0 is x, 1 is y) to the output range
+    int32_t evdev_scale_abs(evdev_device_t *dev, uint8_t axis, int32_t value);
+
+    // returns true if a SYN_REPORT committed new state
+    bool evdev_process(evdev_device_t *dev, const struct input_event *ev);
+
+    // drains the device, returns true if the state or the key queue changed.
+    // lost gets set if the device has gone away
+    bool evdev_drain(evdev_device_t *dev, bool *lost);
+
+    // takes an unplugged device out of the epoll set and closes it
+    void evdev_disconnect(int epfd, evdev_device_t *dev);
+
+    // handles the epoll events of a device, returns true if the drivers
+    // need to look at it
+    bool evdev_service(int epfd, evdev_device_t *dev, uint32_t events);
+#endif /* __EVDEV_ENGINE_H__ */
@@ -0,0 +1,21 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "evdev_engine.h"
+
+#ifndef __EVDEV_READER_H__
+    #define __EVDEV_READER_H__
+
+    #define EVDEV_MAX_DEVICES    (8)
+
+    typedef struct _mp_evdev_reader_obj_t {
+        mp_obj_base_t base;
+
+        int epfd;
+        evdev_device_t devices[EVDEV_MAX_DEVICES];
+    } mp_evdev_reader_obj_t;
+
+    extern const mp_obj_type_t mp_evdev_reader_type;
+#endif /* __EVDEV_READER_H__ */
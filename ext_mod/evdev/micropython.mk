@@ -0,0 +1,12 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+################################################################################
+# evdev build rules
+
+MOD_DIR := $(USERMOD_DIR)
+
+# evdev and epoll are Linux only
+ifneq (,$(filter unix raspberry_pi, $(LV_PORT)))
+    SRC_USERMOD_C += $(MOD_DIR)/src/evdev.c
+    SRC_USERMOD_C += $(MOD_DIR)/src/evdev_engine.c
+endif
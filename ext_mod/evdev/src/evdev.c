@@ -0,0 +1,372 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/evdev_reader.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/mperrno.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+
+// an unplugged device stays valid so the drivers can still read its last
+// state, see evdev_disconnect
+static evdev_device_t *evdev_get_device(mp_evdev_reader_obj_t *self, mp_obj_t index_in)
+{
+    mp_int_t index = mp_obj_get_int(index_in);
+
+    if (index < 0 || index >= EVDEV_MAX_DEVICES ||
+            (self->devices[index].fd < 0 && !self->devices[index].lost)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid device"));
+    }
+
+    return &self->devices[index];
+}
+
+
+static mp_obj_t mp_evdev_reader_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    mp_arg_check_num(n_args, n_kw, 0, 0, false);
+
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) mp_raise_OSError(errno);
+
+    mp_evdev_reader_obj_t *self = m_new_obj_with_finaliser(mp_evdev_reader_obj_t);
+    self->base.type = &mp_evdev_reader_type;
+    self->epfd = epfd;
+
+    for (uint8_t i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        self->devices[i].fd = -1;
+        self->devices[i].lost = false;
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+/* open(path, *, width=0, height=0, grab=False)
+ * Adds a /dev/input/event* device to the epoll set and returns its index.
+ * width and height are the display size. Relative motion gets clamped to it
+ * and absolute axes get scaled to it, 0 leaves the values as is.
+ */
+static mp_obj_t mp_evdev_reader_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_path, ARG_width, ARG_height, ARG_grab };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,   MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_path,   MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_width,  MP_ARG_INT  | MP_ARG_KW_ONLY,  { .u_int = 0             } },
+        { MP_QSTR_height, MP_ARG_INT  | MP_ARG_KW_ONLY,  { .u_int = 0             } },
+        { MP_QSTR_grab,   MP_ARG_BOOL | MP_ARG_KW_ONLY,  { .u_bool = false        } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(args[ARG_self].u_obj);
+
+    uint8_t index;
+    for (index = 0; index < EVDEV_MAX_DEVICES; index++) {
+        if (self->devices[index].fd < 0 && !self->devices[index].lost) break;
+    }
+
+    if (index == EVDEV_MAX_DEVICES) {
+        mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("a maximum of %d devices is supported"), EVDEV_MAX_DEVICES);
+    }
+
+    const char *path = mp_obj_str_get_str(args[ARG_path].u_obj);
+
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) mp_raise_OSError(errno);
+
+    if (args[ARG_grab].u_bool && ioctl(fd, EVIOCGRAB, 1) < 0) {
+        int err = errno;
+        close(fd);
+        mp_raise_OSError(err);
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = index;
+
+    if (epoll_ctl(self->epfd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        int err = errno;
+        close(fd);
+        mp_raise_OSError(err);
+    }
+
+    evdev_device_t *dev = &self->devices[index];
+    memset(dev, 0, sizeof(evdev_device_t));
+
+    dev->fd = fd;
+    dev->width = (int32_t)args[ARG_width].u_int;
+    dev->height = (int32_t)args[ARG_height].u_int;
+
+    struct input_absinfo info_x;
+    struct input_absinfo info_y;
+
+    if (ioctl(fd, EVIOCGABS(ABS_X), &info_x) == 0 && ioctl(fd, EVIOCGABS(ABS_Y), &info_y) == 0 &&
+            info_x.maximum > info_x.minimum && info_y.maximum > info_y.minimum) {
+        dev->is_abs = true;
+        dev->abs_min[0] = info_x.minimum;
+        dev->abs_max[0] = info_x.maximum;
+        dev->abs_min[1] = info_y.minimum;
+        dev->abs_max[1] = info_y.maximum;
+        dev->state.x = evdev_scale_abs(dev, 0, info_x.value);
+        dev->state.y = evdev_scale_abs(dev, 1, info_y.value);
+    } else {
+        // a mouse starts in the middle of the screen
+        dev->state.x = dev->width / 2;
+        dev->state.y = dev->height / 2;
+    }
+
+    dev->pending = dev->state;
+
+    return mp_obj_new_int_from_uint(index);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(mp_evdev_reader_open_obj, 2, mp_evdev_reader_open);
+
+
+static mp_obj_t mp_evdev_reader_close(mp_obj_t self_in, mp_obj_t index_in)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    evdev_device_t *dev = evdev_get_device(self, index_in);
+
+    if (dev->fd >= 0) {
+        epoll_ctl(self->epfd, EPOLL_CTL_DEL, dev->fd, NULL);
+        close(dev->fd);
+        dev->fd = -1;
+    }
+
+    dev->lost = false;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_evdev_reader_close_obj, mp_evdev_reader_close);
+
+
+/* poll(timeout=0)
+ * Waits up to timeout milliseconds (-1 forever) for any of the devices and
+ * reads everything they have queued. Returns a bitmask of the devices that
+ * have new state or new keys. A device that got unplugged is closed and
+ * shows up in the bitmask, connected() returns False for it after that.
+ */
+static mp_obj_t mp_evdev_reader_poll(size_t n_args, const mp_obj_t *args)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    int timeout = 0;
+    if (n_args == 2) timeout = (int)mp_obj_get_int(args[1]);
+
+    struct epoll_event events[EVDEV_MAX_DEVICES];
+    int count;
+
+    MP_THREAD_GIL_EXIT();
+    count = epoll_wait(self->epfd, events, EVDEV_MAX_DEVICES, timeout);
+    MP_THREAD_GIL_ENTER();
+
+    if (count < 0) {
+        if (errno == EINTR) return MP_OBJ_NEW_SMALL_INT(0);
+        mp_raise_OSError(errno);
+    }
+
+    mp_int_t changed = 0;
+
+    for (int i = 0; i < count; i++) {
+        uint32_t index = events[i].data.u32;
+
+        if (evdev_service(self->epfd, &self->devices[index], events[i].events)) {
+            changed |= (mp_int_t)(1 << index);
+        }
+    }
+
+    return MP_OBJ_NEW_SMALL_INT(changed);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_evdev_reader_poll_obj, 1, 2, mp_evdev_reader_poll);
+
+
+// connected(index) -> False once the device has been unplugged
+static mp_obj_t mp_evdev_reader_connected(mp_obj_t self_in, mp_obj_t index_in)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    evdev_device_t *dev = evdev_get_device(self, index_in);
+
+    return mp_obj_new_bool(dev->fd >= 0);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_evdev_reader_connected_obj, mp_evdev_reader_connected);
+
+
+// pointer(index) -> (pressed, x, y) as of the last SYN_REPORT
+static mp_obj_t mp_evdev_reader_pointer(mp_obj_t self_in, mp_obj_t index_in)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    evdev_device_t *dev = evdev_get_device(self, index_in);
+
+    mp_obj_t tuple[3] = {
+        mp_obj_new_bool(dev->state.buttons & 1),
+        mp_obj_new_int(dev->state.x),
+        mp_obj_new_int(dev->state.y),
+    };
+    return mp_obj_new_tuple(3, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_evdev_reader_pointer_obj, mp_evdev_reader_pointer);
+
+
+// wheel(index) -> (steps, buttons), the steps get reset
+static mp_obj_t mp_evdev_reader_wheel(mp_obj_t self_in, mp_obj_t index_in)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    evdev_device_t *dev = evdev_get_device(self, index_in);
+
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int(dev->state.wheel),
+        mp_obj_new_int_from_uint(dev->state.buttons),
+    };
+
+    dev->state.wheel = 0;
+
+    return mp_obj_new_tuple(2, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_evdev_reader_wheel_obj, mp_evdev_reader_wheel);
+
+
+// key(index) -> (code, value) for the oldest queued key or None
+static mp_obj_t mp_evdev_reader_key(mp_obj_t self_in, mp_obj_t index_in)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    evdev_device_t *dev = evdev_get_device(self, index_in);
+
+    if (dev->key_head == dev->key_tail) return mp_const_none;
+
+    evdev_key_event_t *key = &dev->keys[dev->key_tail & (EVDEV_KEY_QUEUE_LEN - 1)];
+    dev->key_tail++;
+
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int_from_uint(key->code),
+        mp_obj_new_int_from_uint(key->value),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_evdev_reader_key_obj, mp_evdev_reader_key);
+
+
+static mp_obj_t mp_evdev_reader_fileno(mp_obj_t self_in)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int(self->epfd);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_evdev_reader_fileno_obj, mp_evdev_reader_fileno);
+
+
+static mp_obj_t mp_evdev_reader_deinit(mp_obj_t self_in)
+{
+    mp_evdev_reader_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    for (uint8_t i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        if (self->devices[i].fd >= 0) {
+            close(self->devices[i].fd);
+            self->devices[i].fd = -1;
+        }
+
+        self->devices[i].lost = false;
+    }
+
+    if (self->epfd >= 0) {
+        close(self->epfd);
+        self->epfd = -1;
+    }
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_evdev_reader_deinit_obj, mp_evdev_reader_deinit);
+
+
+static const mp_rom_map_elem_t mp_evdev_reader_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_open),    MP_ROM_PTR(&mp_evdev_reader_open_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_close),   MP_ROM_PTR(&mp_evdev_reader_close_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_poll),    MP_ROM_PTR(&mp_evdev_reader_poll_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_connected), MP_ROM_PTR(&mp_evdev_reader_connected_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pointer), MP_ROM_PTR(&mp_evdev_reader_pointer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wheel),   MP_ROM_PTR(&mp_evdev_reader_wheel_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_key),     MP_ROM_PTR(&mp_evdev_reader_key_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_fileno),  MP_ROM_PTR(&mp_evdev_reader_fileno_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_deinit),  MP_ROM_PTR(&mp_evdev_reader_deinit_obj)  },
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&mp_evdev_reader_deinit_obj)  },
+};
+
+static MP_DEFINE_CONST_DICT(mp_evdev_reader_locals_dict, mp_evdev_reader_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_evdev_reader_type,
+    MP_QSTR_Reader,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_evdev_reader_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_evdev_reader_locals_dict
+);
+
+
+// devices() -> [(name, path), ...] for every event device that can be opened
+static mp_obj_t mp_evdev_devices(void)
+{
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+
+    char path[32];
+    char name[256];
+
+    for (uint8_t i = 0; i < 32; i++) {
+        snprintf(path, sizeof(path), "/dev/input/event%d", i);
+
+        int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) continue;  // missing or no permissions
+
+        memset(name, 0, sizeof(name));
+
+        if (ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) >= 0) {
+            mp_obj_t tuple[2] = {
+                mp_obj_new_str(name, strlen(name)),
+                mp_obj_new_str(path, strlen(path)),
+            };
+            mp_obj_list_append(list, mp_obj_new_tuple(2, tuple));
+        }
+
+        close(fd);
+    }
+
+    return list;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_0(mp_evdev_devices_obj, mp_evdev_devices);
+
+
+static const mp_rom_map_elem_t mp_module_evdev_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR_evdev)  },
+    { MP_ROM_QSTR(MP_QSTR_Reader),   MP_ROM_PTR(&mp_evdev_reader_type) },
+    { MP_ROM_QSTR(MP_QSTR_devices),  MP_ROM_PTR(&mp_evdev_devices_obj) },
+    { MP_ROM_QSTR(MP_QSTR_MAX_DEVICES), MP_ROM_INT(EVDEV_MAX_DEVICES) },
+};
+
+static MP_DEFINE_CONST_DICT(mp_module_evdev_globals, mp_module_evdev_globals_table);
+
+
+const mp_obj_module_t mp_module_evdev = {
+    .base    = {&mp_type_module},
+    .globals = (mp_obj_dict_t *)&mp_module_evdev_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR_evdev, mp_module_evdev);
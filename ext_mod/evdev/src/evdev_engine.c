@@ -0,0 +1,221 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/evdev_engine.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+
+static int32_t evdev_clamp(int32_t value, int32_t size)
+{
+    if (size <= 0) return value;
+    if (value < 0) return 0;
+    if (value >= size) return size - 1;
+    return value;
+}
+
+
+int32_t evdev_scale_abs(evdev_device_t *dev, uint8_t axis, int32_t value)
+{
+    int32_t size = axis ? dev->height : dev->width;
+    int32_t span = dev->abs_max[axis] - dev->abs_min[axis];
+
+    if (size <= 0 || span <= 0) return value;
+
+    return evdev_clamp((int32_t)(((int64_t)(value - dev->abs_min[axis]) * (size - 1)) / span), size);
+}
+
+
+static void evdev_queue_key(evdev_device_t *dev, uint16_t code, int32_t value)
+{
+    // a full queue drops the oldest key
+    if ((uint16_t)(dev->key_head - dev->key_tail) == EVDEV_KEY_QUEUE_LEN) dev->key_tail++;
+
+    evdev_key_event_t *key = &dev->keys[dev->key_head & (EVDEV_KEY_QUEUE_LEN - 1)];
+    key->code = code;
+    key->value = (uint8_t)value;
+    dev->key_head++;
+}
+
+
+// reloads the position and buttons from the kernel after events were lost
+static void evdev_resync(evdev_device_t *dev)
+{
+    dev->pending = dev->state;
+    dev->pending.wheel = 0;
+
+    if (dev->is_abs) {
+        struct input_absinfo info;
+
+        if (ioctl(dev->fd, EVIOCGABS(ABS_X), &info) == 0) dev->pending.x = evdev_scale_abs(dev, 0, info.value);
+        if (ioctl(dev->fd, EVIOCGABS(ABS_Y), &info) == 0) dev->pending.y = evdev_scale_abs(dev, 1, info.value);
+    }
+
+    uint8_t keys[KEY_MAX / 8 + 1];
+    memset(keys, 0, sizeof(keys));
+
+    if (ioctl(dev->fd, EVIOCGKEY(sizeof(keys)), keys) >= 0) {
+        uint8_t buttons = 0;
+
+        for (uint8_t i = 0; i < 8; i++) {
+            if (keys[(BTN_MOUSE + i) / 8] & (1 << ((BTN_MOUSE + i) % 8))) buttons |= (uint8_t)(1 << i);
+        }
+
+        if (keys[BTN_TOUCH / 8] & (1 << (BTN_TOUCH % 8))) buttons |= 1;
+
+        dev->pending.buttons = buttons;
+    }
+}
+
+
+/* Every read() pulls as many input_event structs as the kernel has queued
+ * and the motion gets folded into the pending state. The pending state only
+ * becomes visible to the indev drivers at SYN_REPORT, so a mouse that
+ * reports 1000 times a second costs a single tuple per LVGL read instead of
+ * a Python object per event.
+ */
+bool evdev_process(evdev_device_t *dev, const struct input_event *ev)
+{
+    if (ev->type == EV_SYN) {
+        if (ev->code == SYN_DROPPED) {
+            dev->dropped = true;
+            return false;
+        }
+
+        if (ev->code != SYN_REPORT) return false;
+
+        if (dev->dropped) {
+            dev->dropped = false;
+            evdev_resync(dev);
+        }
+
+        int32_t wheel = dev->state.wheel + dev->pending.wheel;
+
+        dev->state = dev->pending;
+        dev->state.wheel = wheel;
+        dev->pending.wheel = 0;
+
+        return true;
+    }
+
+    if (dev->dropped) return false;
+
+    switch (ev->type) {
+        case EV_REL:
+            if (ev->code == REL_X) {
+                dev->pending.x = evdev_clamp(dev->pending.x + ev->value, dev->width);
+            } else if (ev->code == REL_Y) {
+                dev->pending.y = evdev_clamp(dev->pending.y + ev->value, dev->height);
+            } else if (ev->code == REL_WHEEL) {
+                dev->pending.wheel += ev->value;
+            }
+            break;
+
+        case EV_ABS:
+            if (ev->code == ABS_MT_SLOT) {
+                dev->slot = ev->value;
+            } else if (ev->code == ABS_HAT0X || ev->code == ABS_HAT0Y) {
+                // gamepad d-pads report as a hat, they get turned into the
+                // arrow keys so they can go through the key queue
+                uint16_t minus = (ev->code == ABS_HAT0X) ? KEY_LEFT : KEY_UP;
+                uint16_t plus = (ev->code == ABS_HAT0X) ? KEY_RIGHT : KEY_DOWN;
+                int32_t last = (ev->code == ABS_HAT0X) ? dev->hat[0] : dev->hat[1];
+
+                if (last < 0) evdev_queue_key(dev, minus, 0);
+                else if (last > 0) evdev_queue_key(dev, plus, 0);
+
+                if (ev->value < 0) evdev_queue_key(dev, minus, 1);
+                else if (ev->value > 0) evdev_queue_key(dev, plus, 1);
+
+                if (ev->code == ABS_HAT0X) dev->hat[0] = ev->value;
+                else dev->hat[1] = ev->value;
+            } else if (ev->code == ABS_X || (ev->code == ABS_MT_POSITION_X && dev->slot == 0)) {
+                dev->pending.x = evdev_scale_abs(dev, 0, ev->value);
+            } else if (ev->code == ABS_Y || (ev->code == ABS_MT_POSITION_Y && dev->slot == 0)) {
+                dev->pending.y = evdev_scale_abs(dev, 1, ev->value);
+            }
+            break;
+
+        case EV_KEY:
+            if (ev->code >= BTN_MOUSE && ev->code < BTN_MOUSE + 8) {
+                uint8_t bit = (uint8_t)(1 << (ev->code - BTN_MOUSE));
+                if (ev->value) dev->pending.buttons |= bit;
+                else dev->pending.buttons &= (uint8_t)~bit;
+            } else if (ev->code == BTN_TOUCH) {
+                if (ev->value) dev->pending.buttons |= 1;
+                else dev->pending.buttons &= (uint8_t)~1;
+            } else {
+                evdev_queue_key(dev, ev->code, ev->value);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+
+bool evdev_drain(evdev_device_t *dev, bool *lost)
+{
+    struct input_event events[EVDEV_READ_EVENTS];
+    uint16_t key_head = dev->key_head;
+    bool changed = false;
+    ssize_t len;
+
+    while (true) {
+        len = read(dev->fd, events, sizeof(events));
+
+        if (len < 0 && errno == ENODEV) *lost = true;
+        if (len <= 0) break;
+
+        size_t count = (size_t)len / sizeof(struct input_event);
+
+        for (size_t i = 0; i < count; i++) {
+            if (evdev_process(dev, &events[i])) changed = true;
+        }
+
+        if ((size_t)len < sizeof(events)) break;
+    }
+
+    return changed || key_head != dev->key_head;
+}
+
+
+/* Takes a device that has been unplugged out of the epoll set and closes it.
+ * The buttons get released so a driver doesn't see a press that never ends.
+ * Without this epoll keeps reporting EPOLLHUP and poll() never blocks.
+ */
+void evdev_disconnect(int epfd, evdev_device_t *dev)
+{
+    epoll_ctl(epfd, EPOLL_CTL_DEL, dev->fd, NULL);
+    close(dev->fd);
+
+    dev->fd = -1;
+    dev->lost = true;
+    dev->dropped = false;
+    dev->state.buttons = 0;
+    dev->pending.buttons = 0;
+}
+
+
+bool evdev_service(int epfd, evdev_device_t *dev, uint32_t events)
+{
+    if (dev->fd < 0) return false;
+
+    // whatever was queued before the hang up still gets read
+    bool lost = (events & (EPOLLHUP | EPOLLERR)) != 0;
+    bool changed = evdev_drain(dev, &lost);
+
+    if (lost) {
+        evdev_disconnect(epfd, dev);
+        changed = true;
+    }
+
+    return changed;
+}
@@ -0,0 +1,279 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host tests for the evdev event engine, run with "make -C ext_mod/evdev/tests"
+//
+// A pipe stands in for the event device. The engine reads input_event
+// structs from it the same way it reads them from /dev/input/event*.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <linux/input.h>
+
+#include "../include/evdev_engine.h"
+
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+
+// read() is wrapped, see the Makefile. Setting this makes the next read()
+// fail the way it does once a device has been unplugged.
+static int unplug_fd = -1;
+
+ssize_t __real_read(int fd, void *buf, size_t count);
+
+ssize_t __wrap_read(int fd, void *buf, size_t count)
+{
+    if (fd == unplug_fd) {
+        errno = ENODEV;
+        return -1;
+    }
+
+    return __real_read(fd, buf, count);
+}
+
+
+typedef struct _fake_device_t {
+    int epfd;
+    int write_fd;
+    evdev_device_t dev;
+} fake_device_t;
+
+
+static void fake_open(fake_device_t *fake, int32_t width, int32_t height)
+{
+    int fds[2];
+
+    CHECK(pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+
+    fake->epfd = epoll_create1(EPOLL_CLOEXEC);
+    fake->write_fd = fds[1];
+
+    memset(&fake->dev, 0, sizeof(evdev_device_t));
+    fake->dev.fd = fds[0];
+    fake->dev.width = width;
+    fake->dev.height = height;
+    fake->dev.state.x = width / 2;
+    fake->dev.state.y = height / 2;
+    fake->dev.pending = fake->dev.state;
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = 0;
+
+    CHECK(epoll_ctl(fake->epfd, EPOLL_CTL_ADD, fds[0], &event) == 0);
+}
+
+
+static void fake_close(fake_device_t *fake)
+{
+    if (fake->write_fd >= 0) close(fake->write_fd);
+    if (fake->dev.fd >= 0) close(fake->dev.fd);
+    close(fake->epfd);
+}
+
+
+static void fake_send(fake_device_t *fake, uint16_t type, uint16_t code, int32_t value)
+{
+    struct input_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+
+    CHECK(write(fake->write_fd, &ev, sizeof(ev)) == (ssize_t)sizeof(ev));
+}
+
+
+// what poll() in evdev.c does for a single device
+static bool fake_poll(fake_device_t *fake)
+{
+    struct epoll_event event;
+
+    if (epoll_wait(fake->epfd, &event, 1, 0) != 1) return false;
+
+    return evdev_service(fake->epfd, &fake->dev, event.events);
+}
+
+
+static void test_syn_report_coalescing(void)
+{
+    fake_device_t fake;
+    fake_open(&fake, 320, 240);
+
+    // nothing is visible until the report
+    fake_send(&fake, EV_REL, REL_X, 5);
+    fake_send(&fake, EV_REL, REL_Y, -3);
+    fake_send(&fake, EV_KEY, BTN_LEFT, 1);
+
+    CHECK(!fake_poll(&fake));
+    CHECK(fake.dev.state.x == 160 && fake.dev.state.y == 120);
+    CHECK(fake.dev.state.buttons == 0);
+
+    // the rest of the frame and 2 more frames come in one read
+    fake_send(&fake, EV_REL, REL_X, 5);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    fake_send(&fake, EV_REL, REL_X, 10);
+    fake_send(&fake, EV_REL, REL_WHEEL, 1);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    fake_send(&fake, EV_REL, REL_WHEEL, 2);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+
+    CHECK(fake_poll(&fake));
+    CHECK(fake.dev.state.x == 180 && fake.dev.state.y == 117);
+    CHECK(fake.dev.state.buttons == 1);
+    CHECK(fake.dev.state.wheel == 3);  // adds up until the driver reads it
+
+    // relative motion stays on the screen
+    fake_send(&fake, EV_REL, REL_X, 1000);
+    fake_send(&fake, EV_REL, REL_Y, -1000);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+
+    CHECK(fake_poll(&fake));
+    CHECK(fake.dev.state.x == 319 && fake.dev.state.y == 0);
+
+    // more than one read() worth of events
+    for (uint8_t i = 0; i < EVDEV_READ_EVENTS * 2; i++) {
+        fake_send(&fake, EV_REL, REL_X, -1);
+    }
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+
+    CHECK(fake_poll(&fake));
+    CHECK(fake.dev.state.x == 319 - EVDEV_READ_EVENTS * 2);
+
+    // keys go through the queue in order
+    fake_send(&fake, EV_KEY, KEY_A, 1);
+    fake_send(&fake, EV_KEY, KEY_A, 0);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+
+    CHECK(fake_poll(&fake));
+    CHECK((uint16_t)(fake.dev.key_head - fake.dev.key_tail) == 2);
+    CHECK(fake.dev.keys[0].code == KEY_A && fake.dev.keys[0].value == 1);
+    CHECK(fake.dev.keys[1].code == KEY_A && fake.dev.keys[1].value == 0);
+
+    fake_close(&fake);
+}
+
+
+static void test_syn_dropped(void)
+{
+    fake_device_t fake;
+    fake_open(&fake, 320, 240);
+
+    fake_send(&fake, EV_REL, REL_X, 10);
+    fake_send(&fake, EV_KEY, BTN_LEFT, 1);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    CHECK(fake_poll(&fake));
+    CHECK(fake.dev.state.x == 170 && fake.dev.state.buttons == 1);
+
+    // the kernel's buffer ran over in the middle of a frame, everything up
+    // to the next report is thrown out
+    fake_send(&fake, EV_REL, REL_X, 5);
+    fake_send(&fake, EV_SYN, SYN_DROPPED, 0);
+    fake_send(&fake, EV_REL, REL_X, 100);
+    fake_send(&fake, EV_REL, REL_WHEEL, 4);
+    fake_send(&fake, EV_KEY, KEY_B, 1);
+
+    CHECK(!fake_poll(&fake));
+    CHECK(fake.dev.dropped);
+    CHECK(fake.dev.key_head == fake.dev.key_tail);
+
+    // a pipe can't answer the EVIOCG* ioctls so the resync falls back to
+    // the last reported state
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    CHECK(fake_poll(&fake));
+    CHECK(!fake.dev.dropped);
+    CHECK(fake.dev.state.x == 170 && fake.dev.state.buttons == 1);
+    CHECK(fake.dev.state.wheel == 0);
+
+    // and the events after that count again
+    fake_send(&fake, EV_REL, REL_X, 1);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    CHECK(fake_poll(&fake));
+    CHECK(fake.dev.state.x == 171);
+
+    fake_close(&fake);
+}
+
+
+static void test_hang_up(void)
+{
+    fake_device_t fake;
+    fake_open(&fake, 320, 240);
+
+    fake_send(&fake, EV_KEY, BTN_LEFT, 1);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    CHECK(fake_poll(&fake));
+    CHECK(fake.dev.state.buttons == 1);
+
+    // events that were queued before the device went away still get read
+    fake_send(&fake, EV_REL, REL_X, 7);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    close(fake.write_fd);
+    fake.write_fd = -1;
+
+    CHECK(fake_poll(&fake));
+    CHECK(fake.dev.state.x == 167);
+    CHECK(fake.dev.fd == -1 && fake.dev.lost);
+    CHECK(fake.dev.state.buttons == 0);
+
+    // out of the epoll set, so it doesn't keep waking poll() up
+    struct epoll_event event;
+    CHECK(epoll_wait(fake.epfd, &event, 1, 0) == 0);
+
+    fake_close(&fake);
+}
+
+
+static void test_enodev(void)
+{
+    fake_device_t fake;
+    fake_open(&fake, 320, 240);
+
+    fake_send(&fake, EV_KEY, BTN_LEFT, 1);
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    CHECK(fake_poll(&fake));
+
+    // the read fails before epoll has reported a hang up
+    fake_send(&fake, EV_SYN, SYN_REPORT, 0);
+    unplug_fd = fake.dev.fd;
+
+    CHECK(fake_poll(&fake));
+    unplug_fd = -1;
+
+    CHECK(fake.dev.fd == -1 && fake.dev.lost);
+    CHECK(fake.dev.state.buttons == 0);
+
+    // a device that is closed is left alone
+    CHECK(!evdev_service(fake.epfd, &fake.dev, EPOLLIN | EPOLLHUP));
+
+    fake_close(&fake);
+}
+
+
+int main(void)
+{
+    test_syn_report_coalescing();
+    test_syn_dropped();
+    test_hang_up();
+    test_enodev();
+
+    if (failures) {
+        printf("test_evdev: %d failed\n", failures);
+        return 1;
+    }
+
+    printf("test_evdev: ok\n");
+    return 0;
+}
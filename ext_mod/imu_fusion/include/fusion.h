@@ -1,16 +1,22 @@
 #include "py/obj.h"
 
+#include "fusion_engine.h"
+
 #ifndef __FUSION_H__
     #define __FUSION_H__
 
+    // sample layouts for Fusion.update_batch, the values are packed in the
+    // order accel x, y, z, gyro x, y, z then mag x, y, z (native byte order)
+    #define FUSION_LAYOUT_AG_I16    (0)  // 6 x int16
+    #define FUSION_LAYOUT_AGM_I16   (1)  // 9 x int16
+    #define FUSION_LAYOUT_AG_F32    (2)  // 6 x float
+    #define FUSION_LAYOUT_AGM_F32   (3)  // 9 x float
+
     typedef struct {
         mp_obj_base_t base;
 
         uint32_t start_ts;
-        float mag_bias[3];
-        float beta;  // 0.6045997880780725842169464404f
-        float declination;
-        float q[4];
+        fusion_filter_t filter;
 
     } mp_fusion_obj_t;
 
@@ -0,0 +1,76 @@
+// The filters have no MicroPython dependencies so they can be built and
+// benchmarked on the host, see tests/bench_fusion.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __FUSION_ENGINE_H__
+    #define __FUSION_ENGINE_H__
+
+    // filters that can be picked with Fusion(algorithm=...)
+    #define FUSION_ALGORITHM_MADGWICK      (0)
+    #define FUSION_ALGORITHM_MAHONY        (1)
+    #define FUSION_ALGORITHM_MADGWICK_Q16  (2)  // fixed point, accel and gyro only
+
+    #define FUSION_CAL_IDLE     (0)
+    #define FUSION_CAL_RUNNING  (1)
+    #define FUSION_CAL_DONE     (2)
+
+    // running sums for Fusion.start_calibration, only allocated while a
+    // calibration is running
+    typedef struct {
+        uint32_t target;
+        uint32_t count;
+        bool gyro;
+        bool mag;
+
+        float gyro_sum[3];
+
+        uint32_t mag_count;
+        float mag_origin[3];  // first sample, the sums are relative to it
+        float mag_min[3];
+        float mag_max[3];
+
+        // normal equations for x^2 + b y^2 + c z^2 + d x + e y + f z + g = 0
+        double ata[6][6];
+        double atb[6];
+    } fusion_cal_t;
+
+    typedef struct {
+        float beta;  // 0.6045997880780725842169464404f
+        float declination;
+        float q[4];
+
+        uint8_t algorithm;
+
+        // Mahony proportional and integral gains and the integral feedback
+        float kp;
+        float ki;
+        float integral[3];
+
+        // quaternion for the fixed point filter, 1.0 is 65536
+        int32_t q16[4];
+
+        float gyro_bias[3];
+        float mag_bias[3];
+        float mag_scale[3];  // soft iron correction, applied after mag_bias
+
+        uint8_t cal_state;
+        fusion_cal_t *cal;
+    } fusion_filter_t;
+
+    // identity orientation, no calibration and the default gains
+    void fusion_filter_init(fusion_filter_t *filter, uint8_t algorithm);
+
+    // The next `samples` steps get added to cal, the results are applied once
+    // they are in. cal is owned by the caller and is let go of when done.
+    void fusion_filter_start_cal(fusion_filter_t *filter, fusion_cal_t *cal, uint32_t samples, bool gyro, bool mag);
+
+    // One filter step, accel in g, gyro in degrees per second and mag (which
+    // can be NULL) in any unit. Returns false if the sample can't be used.
+    bool fusion_filter_step(fusion_filter_t *filter, const float *accel, const float *gyro, const float *mag, float delta_t);
+
+    // converts the current quaternion to degrees, yaw is 0 if use_mag is false
+    void fusion_filter_euler(fusion_filter_t *filter, bool use_mag, float *roll_out, float *pitch_out, float *yaw_out);
+#endif /* __FUSION_ENGINE_H__ */
@@ -0,0 +1,26 @@
+#include "py/obj.h"
+
+#ifndef __ORIENTATION_H__
+    #define __ORIENTATION_H__
+
+    #define ORIENTATION_NONE  (-1)
+
+    typedef struct {
+        mp_obj_base_t base;
+
+        mp_obj_t callback;
+
+        float hysteresis;       // degrees past the 45 degree boundary
+        float adjustment;       // added to the angle before anything else
+        uint32_t dwell;         // milliseconds a new quadrant has to hold
+
+        int8_t rotation;        // confirmed quadrant, 0 - 3
+        int8_t candidate;       // quadrant waiting out the dwell time
+        uint32_t candidate_ts;
+
+    } mp_orientation_tracker_obj_t;
+
+
+    extern const mp_obj_type_t mp_orientation_tracker_type;
+
+#endif
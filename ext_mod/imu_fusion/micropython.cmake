@@ -9,6 +9,8 @@ set(FUSION_INCLUDES
 
 set(FUSION_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/src/fusion.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/fusion_engine.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/orientation.c
 )
 
 
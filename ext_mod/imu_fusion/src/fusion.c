@@ -1,19 +1,15 @@
 
 
 #include "fusion.h"
+#include "orientation.h"
 #include "mphalport.h"
 #include "py/obj.h"
 #include "py/runtime.h"
 
 #include <math.h>
+#include <string.h>
 
 
-#define FUSION_PI 3.14159265358979323846f
-#define FUSION_UNUSED(x) ((void)x)
-
-#define FUSION_RADIANS(degree) (degree) * FUSION_PI / 180.0f
-#define FUSION_DEGREES(radian) (radian) * 180.0f / FUSION_PI
-
 #define FUSION_MAX(item1, item2) (item1) >= (item2) ? (item1) : (item2)
 #define FUSION_MIN(item1, item2) (item1) <= (item2) ? (item1) : (item2)
 
@@ -21,11 +17,19 @@
 static mp_obj_t fusion_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
 {
     enum {
-        ARG_declination
+        ARG_declination,
+        ARG_algorithm,
+        ARG_beta,
+        ARG_kp,
+        ARG_ki
     };
 
     const mp_arg_t make_new_args[] = {
-        { MP_QSTR_declination, MP_ARG_OBJ  | MP_ARG_KW_ONLY,  {.u_obj = mp_const_none } }
+        { MP_QSTR_declination, MP_ARG_OBJ  | MP_ARG_KW_ONLY,  {.u_obj = mp_const_none } },
+        { MP_QSTR_algorithm,   MP_ARG_INT  | MP_ARG_KW_ONLY,  {.u_int = FUSION_ALGORITHM_MADGWICK } },
+        { MP_QSTR_beta,        MP_ARG_OBJ  | MP_ARG_KW_ONLY,  {.u_obj = mp_const_none } },
+        { MP_QSTR_kp,          MP_ARG_OBJ  | MP_ARG_KW_ONLY,  {.u_obj = mp_const_none } },
+        { MP_QSTR_ki,          MP_ARG_OBJ  | MP_ARG_KW_ONLY,  {.u_obj = mp_const_none } },
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
@@ -36,12 +40,20 @@ static mp_obj_t fusion_make_new(const mp_obj_type_t *type, size_t n_args, size_t
     mp_fusion_obj_t *self = m_new_obj(mp_fusion_obj_t);
     self->base.type = &mp_fusion_type;
 
-    self->beta = 0.6045997880780725842169464404f;
+    if (args[ARG_algorithm].u_int < FUSION_ALGORITHM_MADGWICK ||
+            args[ARG_algorithm].u_int > FUSION_ALGORITHM_MADGWICK_Q16) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid algorithm"));
+    }
+
+    fusion_filter_init(&self->filter, (uint8_t)args[ARG_algorithm].u_int);
+    self->start_ts = 0;
 
-    if (args[ARG_declination].u_obj == mp_const_none) {
-        self->declination = 0.0f;
-    } else {
-        self->declination = mp_obj_get_float_to_f(args[ARG_declination].u_obj);
+    if (args[ARG_beta].u_obj != mp_const_none) self->filter.beta = mp_obj_get_float_to_f(args[ARG_beta].u_obj);
+    if (args[ARG_kp].u_obj != mp_const_none) self->filter.kp = mp_obj_get_float_to_f(args[ARG_kp].u_obj);
+    if (args[ARG_ki].u_obj != mp_const_none) self->filter.ki = mp_obj_get_float_to_f(args[ARG_ki].u_obj);
+
+    if (args[ARG_declination].u_obj != mp_const_none) {
+        self->filter.declination = mp_obj_get_float_to_f(args[ARG_declination].u_obj);
     }
 
     return MP_OBJ_FROM_PTR(self);
@@ -80,7 +92,7 @@ static mp_obj_t calibrate(mp_obj_t self_in, mp_obj_t getxyz, mp_obj_t stopfunc)
     }
 
     for (uint8_t i=0;i<3;i++) {
-        self->mag_bias[i] = (mag_min[i] + mag_max[i]) / 2.0f;
+        self->filter.mag_bias[i] = (mag_min[i] + mag_max[i]) / 2.0f;
     }
 
     return mp_const_none;
@@ -105,192 +117,37 @@ static float delta_T(mp_fusion_obj_t *self)
 }
 
 
-mp_obj_t calculate(mp_fusion_obj_t *self, float accel[3], float gyro[3], float *mag)
+static mp_obj_t fusion_euler_tuple(mp_fusion_obj_t *self, bool use_mag)
 {
-    mp_obj_t tuple[3] = {
-        mp_const_none,
-        mp_const_none,
-        mp_const_none
-    };
-
     float roll;
     float pitch;
     float yaw;
 
-    float ax = accel[0];
-    float ay = accel[1];
-    float az = accel[2];
-
-    // Normalise accelerometer measurement
-    float norm = sqrtf((ax * ax) + (ay * ay) + (az * az));
+    fusion_filter_euler(&self->filter, use_mag, &roll, &pitch, &yaw);
 
-    if (norm == 0.0f) return mp_obj_new_tuple(3, tuple);  // handle NaN
-
-    norm = 1.0f / norm;  // use reciprocal for division
-
-    ax *= norm;
-    ay *= norm;
-    az *= norm;
-
-    float mx;
-    float my;
-    float mz;
-
-    if (mag != NULL) {
-        mx = mag[0] - self->mag_bias[0];
-        my = mag[1] - self->mag_bias[1];
-        mz = mag[2] - self->mag_bias[2];
-
-        // Normalise magnetometer measurement
-        norm = sqrtf((mx * mx) + (my * my) + (mz * mz));
-
-        if (norm == 0.0f) return mp_obj_new_tuple(3, tuple);  // handle NaN
-
-        norm = 1.0f / norm;  // use reciprocal for division
+    mp_obj_t tuple[3] = {
+        mp_obj_new_float((mp_float_t)roll),
+        mp_obj_new_float((mp_float_t)pitch),
+        mp_obj_new_float((mp_float_t)yaw)
+    };
 
-        mx *= norm;
-        my *= norm;
-        mz *= norm;
-    } else {
-        mx = 0.0f;
-        my = 0.0f;
-        mz = 0.0f;
-    }
+    return mp_obj_new_tuple(3, tuple);
+}
 
-    float gx = FUSION_RADIANS(gyro[0]);
-    float gy = FUSION_RADIANS(gyro[1]);
-    float gz = FUSION_RADIANS(gyro[2]);
-
-    float q1 = self->q[0];
-    float q2 = self->q[1];
-    float q3 = self->q[2];
-    float q4 = self->q[3];
-
-    // Auxiliary variables to avoid repeated arithmetic
-    float _2q1 = 2.0f * q1;
-    float _2q2 = 2.0f * q2;
-    float _2q3 = 2.0f * q3;
-    float _2q4 = 2.0f * q4;
-
-    float q1sq = q1 * q1;
-    float q2sq = q2 * q2;
-    float q3sq = q3 * q3;
-    float q4sq = q4 * q4;
-
-    float s1;
-    float s2;
-    float s3;
-    float s4;
-
-    if (mag != NULL) {
-        float q12 = q1 * q2;
-        float q13 = q1 * q3;
-        float q24 = q2 * q4;
-        float q34 = q3 * q4;
-
-        // Reference direction of Earth's magnetic field
-        float _2q1mx = _2q1 * mx;
-        float _2q1my = _2q1 * my;
-        float _2q1mz = _2q1 * mz;
-        float _2q2mx = _2q2 * mx;
-
-        float hx = (mx * q1sq) - (_2q1my * q4) + (_2q1mz * q3) + (mx * q2sq) + (_2q2 * my) * q3 + (_2q2 * mz * q4) - (mx * q3sq) - (mx * q4sq);
-        float hy = (_2q1mx * q4) + (my * q1sq) - (_2q1mz * q2) + (_2q2mx * q3) - (my * q2sq) + (my * q3sq) + (_2q3 * mz * q4) - (my * q4sq);
-
-        float _2bx = sqrtf((hx * hx) + (hy * hy));
-        float _2bz = (-_2q1mx * q3) + (_2q1my * q2) + (mz * q1sq) + (_2q2mx * q4) - (mz * q2sq) + (_2q3 * my * q4) - (mz * q3sq) + (mz * q4sq);
-        float _4bx = 2.0f * _2bx;
-        float _4bz = 2.0f * _2bz;
-
-        float temp1 = (2.0f * q24) - (2.0f * q13) - ax;
-        float temp2 = (2.0f * q12) + (2.0f * q34) - ay;
-        float temp3 = (_2bx * (0.5f - q3sq - q4sq)) + (_2bz * (q34 - q13)) - mx;
-        float temp4 = (_2bx * ((q2 * q3) - (q1 * q4))) + (_2bz * (q12 + q34)) - my;
-        float temp5 = (_2bx * (q13 + q24)) + (_2bz * (0.5f - q2sq - q3sq)) - mz;
-        float temp6 = 1.0f - (2.0f * q2sq) - (2 * q3sq) - az;
-        float temp7 = 4.0f * temp6;
-        float temp8 = _2bx * q3;
-        float temp9 = _2bx * q4;
-        float temp10 = _2bz * q4;
-        float temp11 = _2bz * q1;
-        float temp12 = _2bz * q2;
-        float temp13 = _2bx * q2;
-        float temp14 = _2bz * q3;
-        float temp15 = _2bx * q1;
-
-        // Gradient descent algorithm corrective step
-        s1 = (-_2q3 * temp1) + (_2q2 * temp2) - (temp14 * temp3) + ((temp9 + temp12) * temp4) + (temp8 * temp5);
-        s2 = (_2q4 * temp1) + (_2q1 * temp2) - (q2 * temp7) + (temp10 * temp3) + ((temp8 + temp11) * temp4) + ((temp9 - (_4bz * q2)) * temp5);
-        s3 = (-_2q1 * temp1) + (_2q4 * temp2) - (q3 * temp7) + ((-_4bx * q3 - temp11) * temp3) + ((temp13 + temp10) * temp4) + ((temp15 - (_4bz * q3)) * temp5);
-        s4 = (_2q2 * temp1) + (_2q3 * temp2) + (((-_4bx * q4) + temp12) * temp3) + ((-temp15 + temp14) * temp4) + (temp13 * temp5);
-    } else {
-        float _4q1 = _2q1 + _2q1;
-        float _4q2 = _2q2 + _2q2;
-        float _4q3 = _2q3 + _2q3;
-
-        float _8q2 = _4q2 + _4q2;
-        float _8q3 = _4q3 + _4q3;
-
-        // Gradient decent algorithm corrective step
-        s1 = (_4q1 * q3sq) + (_2q3 * ax) + (_4q1 * q2sq) - (_2q2 * ay);
-        s2 = (_4q2 * q4sq) - (_2q4 * ax) + (4 * q1sq * q2) - (_2q1 * ay) - _4q2 + (_8q2 * q2sq) + (_8q2 * q3sq) + (_4q2 * az);
-        s3 = (4 * q1sq * q3) + (_2q1 * ax) + (_4q3 * q4sq) - (_2q4 * ay) - _4q3 + (_8q3 * q2sq) + (_8q3 * q3sq) + (_4q3 * az);
-        s4 = (4 * q2sq * q4) - (_2q2 * ax) + (4 * q3sq * q4) - (_2q3 * ay);
-    }
 
-    norm = 1.0f / sqrtf((s1 * s1) + (s2 * s2) + (s3 * s3) + (s4 * s4));  // normalise step magnitude
-    s1 *= norm;
-    s2 *= norm;
-    s3 *= norm;
-    s4 *= norm;
-
-    float beta = self->beta;
-
-    // Compute rate of change of quaternion
-    float qDot1 = 0.5f * ((-q2 * gx) - (q3 * gy) - (q4 * gz)) - (beta * s1);
-    float qDot2 = 0.5f * ((q1 * gx) + (q3 * gz) - (q4 * gy)) - (beta * s2);
-    float qDot3 = 0.5f * ((q1 * gy) - (q2 * gz) + (q4 * gx)) - (beta * s3);
-    float qDot4 = 0.5f * ((q1 * gz) + (q2 * gy) - (q3 * gx)) - (beta * s4);
-
-    // Integrate to yield quaternion
-    float delta_t = delta_T(self);
-    q1 += qDot1 * delta_t;
-    q2 += qDot2 * delta_t;
-    q3 += qDot3 * delta_t;
-    q4 += qDot4 * delta_t;
-
-    norm = 1.0f / sqrtf((q1 * q1) + (q2 * q2) + (q3 * q3) + (q4 * q4));  // normalise quaternion
-
-    q1 *= norm;
-    q2 *= norm;
-    q3 *= norm;
-    q4 *= norm;
-
-    q1sq = q1 * q1;
-    q2sq = q2 * q2;
-    float s3sq = s3 * s3;
-    q4sq = q4 * q4;
-
-    self->q[0] = q1;
-    self->q[1] = q2;
-    self->q[2] = q3;
-    self->q[3] = q4;
-
-    pitch = FUSION_DEGREES(-asinf(2.0f * ((q2 * q4) - (q1 * q3))));
-    roll = FUSION_DEGREES(atan2f(2.0f * ((q1 * q2) + (q3 * q4)), q1sq - q2sq - s3sq + q4sq));
-
-    if (mag != NULL) {
-        yaw = FUSION_DEGREES(atan2f(2.0f * ((q2 * q3) + (q1 * q4)), q1sq + q2sq - s3sq - q4sq));
-        yaw += self->declination;
-    } else {
-        yaw = 0.0f;
+mp_obj_t calculate(mp_fusion_obj_t *self, float accel[3], float gyro[3], float *mag)
+{
+    if (!fusion_filter_step(&self->filter, accel, gyro, mag, delta_T(self))) {
+        mp_obj_t tuple[3] = {
+            mp_const_none,
+            mp_const_none,
+            mp_const_none
+        };
+
+        return mp_obj_new_tuple(3, tuple);
     }
 
-    tuple[0] = mp_obj_new_float((mp_float_t)roll);
-    tuple[1] = mp_obj_new_float((mp_float_t)pitch);
-    tuple[2] = mp_obj_new_float((mp_float_t)yaw);
-
-    return mp_obj_new_tuple(3, tuple);
+    return fusion_euler_tuple(self, mag != NULL);
 }
 
 
@@ -345,9 +202,302 @@ mp_obj_t update(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 static MP_DEFINE_CONST_FUN_OBJ_KW(update_obj, 3, update);
 
 
+/* update_batch(buf, layout, dt=None, *, count=-1, accel_scale=1.0,
+ *              gyro_scale=1.0, mag_scale=1.0, decimate=0)
+ *
+ * Runs the filter over every sample in buf, which is normally the result of
+ * a FIFO burst read. The raw values get multiplied by the scales to get g,
+ * degrees per second and the magnetometer units. dt is the time between
+ * samples in seconds, if it is None the time since the last update gets
+ * spread evenly over the samples.
+ *
+ * Returns (roll, pitch, yaw) after the last sample. If decimate is more than 0
+ * a list with the orientation after every decimate samples is returned
+ * instead.
+ */
+static mp_obj_t update_batch(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_buf, ARG_layout, ARG_dt, ARG_count, ARG_accel_scale,
+           ARG_gyro_scale, ARG_mag_scale, ARG_decimate };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,        MP_ARG_OBJ | MP_ARG_REQUIRED                            },
+        { MP_QSTR_buf,         MP_ARG_OBJ | MP_ARG_REQUIRED                            },
+        { MP_QSTR_layout,      MP_ARG_INT | MP_ARG_REQUIRED                            },
+        { MP_QSTR_dt,          MP_ARG_OBJ,                  { .u_obj = mp_const_none } },
+        { MP_QSTR_count,       MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = -1            } },
+        { MP_QSTR_accel_scale, MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+        { MP_QSTR_gyro_scale,  MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+        { MP_QSTR_mag_scale,   MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+        { MP_QSTR_decimate,    MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0             } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_fusion_obj_t *self = (mp_fusion_obj_t *)args[ARG_self].u_obj;
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_buf].u_obj, &bufinfo, MP_BUFFER_READ);
+
+    uint8_t layout = (uint8_t)args[ARG_layout].u_int;
+    bool use_mag;
+    bool is_float;
+
+    switch (layout) {
+        case FUSION_LAYOUT_AG_I16:
+            use_mag = false;
+            is_float = false;
+            break;
+        case FUSION_LAYOUT_AGM_I16:
+            use_mag = true;
+            is_float = false;
+            break;
+        case FUSION_LAYOUT_AG_F32:
+            use_mag = false;
+            is_float = true;
+            break;
+        case FUSION_LAYOUT_AGM_F32:
+            use_mag = true;
+            is_float = true;
+            break;
+        default:
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid layout"));
+    }
+
+    size_t values = use_mag ? 9 : 6;
+    size_t stride = values * (is_float ? sizeof(float) : sizeof(int16_t));
+    size_t count = bufinfo.len / stride;
+
+    if (args[ARG_count].u_int >= 0 && (size_t)args[ARG_count].u_int < count) {
+        count = (size_t)args[ARG_count].u_int;
+    }
+
+    float accel_scale = 1.0f;
+    float gyro_scale = 1.0f;
+    float mag_scale = 1.0f;
+
+    if (args[ARG_accel_scale].u_obj != mp_const_none) accel_scale = mp_obj_get_float_to_f(args[ARG_accel_scale].u_obj);
+    if (args[ARG_gyro_scale].u_obj != mp_const_none) gyro_scale = mp_obj_get_float_to_f(args[ARG_gyro_scale].u_obj);
+    if (args[ARG_mag_scale].u_obj != mp_const_none) mag_scale = mp_obj_get_float_to_f(args[ARG_mag_scale].u_obj);
+
+    float delta_t;
+
+    if (args[ARG_dt].u_obj != mp_const_none) {
+        delta_t = mp_obj_get_float_to_f(args[ARG_dt].u_obj);
+        self->start_ts = mp_hal_ticks_us();
+    } else {
+        delta_t = delta_T(self);
+        if (count > 1) delta_t /= (float)count;
+    }
+
+    mp_int_t decimate = args[ARG_decimate].u_int;
+    mp_obj_t series = mp_const_none;
+
+    if (decimate > 0) series = mp_obj_new_list(0, NULL);
+
+    float scales[9] = {
+        accel_scale, accel_scale, accel_scale,
+        gyro_scale, gyro_scale, gyro_scale,
+        mag_scale, mag_scale, mag_scale
+    };
+
+    float sample[9];
+    bool have_orientation = false;
+    const uint8_t *buf = (const uint8_t *)bufinfo.buf;
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *record = buf + (i * stride);
+
+        // memcpy keeps this safe for buffers that aren't aligned
+        if (is_float) {
+            float raw[9];
+            memcpy(raw, record, stride);
+            for (uint8_t j = 0; j < values; j++) sample[j] = raw[j] * scales[j];
+        } else {
+            int16_t raw[9];
+            memcpy(raw, record, stride);
+            for (uint8_t j = 0; j < values; j++) sample[j] = (float)raw[j] * scales[j];
+        }
+
+        if (fusion_filter_step(&self->filter, &sample[0], &sample[3], use_mag ? &sample[6] : NULL, delta_t)) {
+            have_orientation = true;
+        }
+
+        if (decimate > 0 && ((i + 1) % (size_t)decimate) == 0) {
+            mp_obj_list_append(series, fusion_euler_tuple(self, use_mag));
+        }
+    }
+
+    if (decimate > 0) return series;
+
+    if (!have_orientation) {
+        mp_obj_t tuple[3] = {
+            mp_const_none,
+            mp_const_none,
+            mp_const_none
+        };
+
+        return mp_obj_new_tuple(3, tuple);
+    }
+
+    return fusion_euler_tuple(self, use_mag);
+}
+
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(update_batch_obj, 3, update_batch);
+
+
+/* start_calibration(samples=500, *, gyro=True, mag=False)
+ * The next `samples` updates get used for the calibration, update and
+ * update_batch keep working the same as always so this doesn't block. Keep
+ * the device still for the gyro and turn it through every orientation for the
+ * magnetometer, the two are normally done one after the other.
+ */
+static mp_obj_t start_calibration(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_samples, ARG_gyro, ARG_mag };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,    MP_ARG_OBJ  | MP_ARG_REQUIRED                   },
+        { MP_QSTR_samples, MP_ARG_INT,                  { .u_int = 500    } },
+        { MP_QSTR_gyro,    MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = true  } },
+        { MP_QSTR_mag,     MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_fusion_obj_t *self = (mp_fusion_obj_t *)args[ARG_self].u_obj;
+
+    if (args[ARG_samples].u_int < 1) {
+        mp_raise_ValueError(MP_ERROR_TEXT("samples must be at least 1"));
+    }
+
+    fusion_cal_t *cal = self->filter.cal;
+    if (cal == NULL) cal = m_new(fusion_cal_t, 1);
+
+    fusion_filter_start_cal(&self->filter, cal, (uint32_t)args[ARG_samples].u_int,
+                            args[ARG_gyro].u_bool, args[ARG_mag].u_bool);
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(start_calibration_obj, 1, start_calibration);
+
+
+static mp_obj_t cancel_calibration(mp_obj_t self_in)
+{
+    mp_fusion_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    self->filter.cal = NULL;
+    if (self->filter.cal_state == FUSION_CAL_RUNNING) self->filter.cal_state = FUSION_CAL_IDLE;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(cancel_calibration_obj, cancel_calibration);
+
+
+// 0.0 - 1.0, 1.0 once the results have been applied
+static mp_obj_t calibration_progress(mp_obj_t self_in)
+{
+    mp_fusion_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    float progress;
+
+    if (self->filter.cal_state == FUSION_CAL_DONE) progress = 1.0f;
+    else if (self->filter.cal == NULL) progress = 0.0f;
+    else progress = (float)self->filter.cal->count / (float)self->filter.cal->target;
+
+    return mp_obj_new_float(progress);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(calibration_progress_obj, calibration_progress);
+
+
+static mp_obj_t fusion_vector_tuple(const float *v)
+{
+    mp_obj_t tuple[3] = {
+        mp_obj_new_float(v[0]),
+        mp_obj_new_float(v[1]),
+        mp_obj_new_float(v[2])
+    };
+
+    return mp_obj_new_tuple(3, tuple);
+}
+
+
+/* calibration_result()
+ * Returns (gyro_bias, mag_bias, mag_scale) once a calibration has finished,
+ * None before that. The values can be saved and passed to set_calibration.
+ */
+static mp_obj_t calibration_result(mp_obj_t self_in)
+{
+    mp_fusion_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->filter.cal_state != FUSION_CAL_DONE) return mp_const_none;
+
+    mp_obj_t tuple[3] = {
+        fusion_vector_tuple(self->filter.gyro_bias),
+        fusion_vector_tuple(self->filter.mag_bias),
+        fusion_vector_tuple(self->filter.mag_scale)
+    };
+
+    return mp_obj_new_tuple(3, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(calibration_result_obj, calibration_result);
+
+
+static void fusion_get_vector(mp_obj_t obj, float *v)
+{
+    mp_obj_t *items;
+    mp_obj_get_array_fixed_n(obj, 3, &items);
+
+    for (uint8_t i = 0; i < 3; i++) v[i] = mp_obj_get_float_to_f(items[i]);
+}
+
+
+static mp_obj_t set_calibration(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_gyro_bias, ARG_mag_bias, ARG_mag_scale };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,      MP_ARG_OBJ | MP_ARG_REQUIRED                 },
+        { MP_QSTR_gyro_bias, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+        { MP_QSTR_mag_bias,  MP_ARG_OBJ, { .u_obj = mp_const_none } },
+        { MP_QSTR_mag_scale, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_fusion_obj_t *self = (mp_fusion_obj_t *)args[ARG_self].u_obj;
+
+    if (args[ARG_gyro_bias].u_obj != mp_const_none) fusion_get_vector(args[ARG_gyro_bias].u_obj, self->filter.gyro_bias);
+    if (args[ARG_mag_bias].u_obj != mp_const_none) fusion_get_vector(args[ARG_mag_bias].u_obj, self->filter.mag_bias);
+    if (args[ARG_mag_scale].u_obj != mp_const_none) fusion_get_vector(args[ARG_mag_scale].u_obj, self->filter.mag_scale);
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(set_calibration_obj, 1, set_calibration);
+
+
 static const mp_rom_map_elem_t fusion_locals_dict_table[] = {
-    { MP_ROM_QSTR(MP_QSTR_calibrate), MP_ROM_PTR(&calibrate_obj) },
-    { MP_ROM_QSTR(MP_QSTR_update),    MP_ROM_PTR(&update_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_calibrate),     MP_ROM_PTR(&calibrate_obj)          },
+    { MP_ROM_QSTR(MP_QSTR_update),        MP_ROM_PTR(&update_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_update_batch),  MP_ROM_PTR(&update_batch_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_start_calibration),    MP_ROM_PTR(&start_calibration_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_cancel_calibration),   MP_ROM_PTR(&cancel_calibration_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_calibration_progress), MP_ROM_PTR(&calibration_progress_obj) },
+    { MP_ROM_QSTR(MP_QSTR_calibration_result),   MP_ROM_PTR(&calibration_result_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_set_calibration),      MP_ROM_PTR(&set_calibration_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_LAYOUT_AG_I16),  MP_ROM_INT(FUSION_LAYOUT_AG_I16)    },
+    { MP_ROM_QSTR(MP_QSTR_LAYOUT_AGM_I16), MP_ROM_INT(FUSION_LAYOUT_AGM_I16)   },
+    { MP_ROM_QSTR(MP_QSTR_LAYOUT_AG_F32),  MP_ROM_INT(FUSION_LAYOUT_AG_F32)    },
+    { MP_ROM_QSTR(MP_QSTR_LAYOUT_AGM_F32), MP_ROM_INT(FUSION_LAYOUT_AGM_F32)   },
+    { MP_ROM_QSTR(MP_QSTR_ALGORITHM_MADGWICK),     MP_ROM_INT(FUSION_ALGORITHM_MADGWICK)     },
+    { MP_ROM_QSTR(MP_QSTR_ALGORITHM_MAHONY),       MP_ROM_INT(FUSION_ALGORITHM_MAHONY)       },
+    { MP_ROM_QSTR(MP_QSTR_ALGORITHM_MADGWICK_Q16), MP_ROM_INT(FUSION_ALGORITHM_MADGWICK_Q16) },
 };
 
 
@@ -363,9 +513,61 @@ MP_DEFINE_CONST_OBJ_TYPE(
 );
 
 
+/* unpack_i16(buf, big_endian=False, count=-1)
+ * Converts the raw 16 bit sensor values in buf to native int16 in place so
+ * the buffer can be passed straight to Fusion.update_batch. Only the byte
+ * order needs fixing, the values are two's complement so reading them back as
+ * int16 takes care of the sign. Returns the number of values.
+ */
+static mp_obj_t unpack_i16(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_buf, ARG_big_endian, ARG_count };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_buf,        MP_ARG_OBJ | MP_ARG_REQUIRED                  },
+        { MP_QSTR_big_endian, MP_ARG_BOOL,                { .u_bool = false } },
+        { MP_QSTR_count,      MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = -1     } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_buf].u_obj, &bufinfo, MP_BUFFER_RW);
+
+    size_t count = bufinfo.len / 2;
+
+    if (args[ARG_count].u_int >= 0 && (size_t)args[ARG_count].u_int < count) {
+        count = (size_t)args[ARG_count].u_int;
+    }
+
+    #if MP_ENDIANNESS_LITTLE
+    bool swap = args[ARG_big_endian].u_bool;
+    #else
+    bool swap = !args[ARG_big_endian].u_bool;
+    #endif
+
+    if (swap) {
+        uint8_t *buf = (uint8_t *)bufinfo.buf;
+        uint8_t tmp;
+
+        for (size_t i = 0; i < count; i++) {
+            tmp = buf[i * 2];
+            buf[i * 2] = buf[(i * 2) + 1];
+            buf[(i * 2) + 1] = tmp;
+        }
+    }
+
+    return mp_obj_new_int_from_uint(count);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(unpack_i16_obj, 1, unpack_i16);
+
+
 static const mp_rom_map_elem_t fusion_globals_table[] = {
-    { MP_ROM_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR_fusion) },
-    { MP_ROM_QSTR(MP_QSTR_Fusion),   MP_ROM_PTR(&mp_fusion_type)     }
+    { MP_ROM_QSTR(MP_QSTR___name__),   MP_OBJ_NEW_QSTR(MP_QSTR_fusion) },
+    { MP_ROM_QSTR(MP_QSTR_Fusion),     MP_ROM_PTR(&mp_fusion_type)     },
+    { MP_ROM_QSTR(MP_QSTR_unpack_i16), MP_ROM_PTR(&unpack_i16_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_OrientationTracker), MP_ROM_PTR(&mp_orientation_tracker_type) },
 };
 
 
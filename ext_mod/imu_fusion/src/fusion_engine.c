@@ -0,0 +1,700 @@
+#include "fusion_engine.h"
+
+#include <math.h>
+#include <string.h>
+
+/* The filters and the calibration fit only work on floats and plain structs,
+ * no MicroPython objects are used.
+ */
+
+
+#define FUSION_PI 3.14159265358979323846f
+
+#define FUSION_RADIANS(degree) (degree) * FUSION_PI / 180.0f
+#define FUSION_DEGREES(radian) (radian) * 180.0f / FUSION_PI
+
+#define FUSION_MAX(item1, item2) (item1) >= (item2) ? (item1) : (item2)
+#define FUSION_MIN(item1, item2) (item1) <= (item2) ? (item1) : (item2)
+
+#define FUSION_Q16_ONE  (65536)
+#define FUSION_TO_Q16(value)  ((int32_t)((value) * 65536.0f))
+#define FUSION_Q16_MUL(a, b)  ((int32_t)(((int64_t)(a) * (int64_t)(b)) >> 16))
+
+
+void fusion_filter_init(fusion_filter_t *filter, uint8_t algorithm)
+{
+    filter->algorithm = algorithm;
+    filter->beta = 0.6045997880780725842169464404f;
+    filter->declination = 0.0f;
+
+    filter->kp = 1.0f;
+    filter->ki = 0.0f;
+
+    // identity orientation, a zeroed quaternion can't be normalised
+    filter->q[0] = 1.0f;
+    filter->q[1] = 0.0f;
+    filter->q[2] = 0.0f;
+    filter->q[3] = 0.0f;
+
+    filter->q16[0] = FUSION_Q16_ONE;
+    filter->q16[1] = 0;
+    filter->q16[2] = 0;
+    filter->q16[3] = 0;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        filter->integral[i] = 0.0f;
+        filter->gyro_bias[i] = 0.0f;
+        filter->mag_bias[i] = 0.0f;
+        filter->mag_scale[i] = 1.0f;
+    }
+
+    filter->cal_state = FUSION_CAL_IDLE;
+    filter->cal = NULL;
+}
+
+
+void fusion_filter_start_cal(fusion_filter_t *filter, fusion_cal_t *cal, uint32_t samples, bool gyro, bool mag)
+{
+    memset(cal, 0, sizeof(fusion_cal_t));
+
+    cal->target = samples;
+    cal->gyro = gyro;
+    cal->mag = mag;
+
+    filter->cal = cal;
+    filter->cal_state = FUSION_CAL_RUNNING;
+}
+
+
+// One Madgwick filter step, returns false if the sample can't be used
+static bool madgwick_step(fusion_filter_t *filter, const float *accel, const float *gyro, const float *mag, float delta_t)
+{
+    float ax = accel[0];
+    float ay = accel[1];
+    float az = accel[2];
+
+    // Normalise accelerometer measurement
+    float norm = sqrtf((ax * ax) + (ay * ay) + (az * az));
+
+    if (norm == 0.0f) return false;  // handle NaN
+
+    norm = 1.0f / norm;  // use reciprocal for division
+
+    ax *= norm;
+    ay *= norm;
+    az *= norm;
+
+    float mx;
+    float my;
+    float mz;
+
+    if (mag != NULL) {
+        mx = mag[0];
+        my = mag[1];
+        mz = mag[2];
+
+        // Normalise magnetometer measurement
+        norm = sqrtf((mx * mx) + (my * my) + (mz * mz));
+
+        if (norm == 0.0f) return false;  // handle NaN
+
+        norm = 1.0f / norm;  // use reciprocal for division
+
+        mx *= norm;
+        my *= norm;
+        mz *= norm;
+    } else {
+        mx = 0.0f;
+        my = 0.0f;
+        mz = 0.0f;
+    }
+
+    float gx = FUSION_RADIANS(gyro[0]);
+    float gy = FUSION_RADIANS(gyro[1]);
+    float gz = FUSION_RADIANS(gyro[2]);
+
+    float q1 = filter->q[0];
+    float q2 = filter->q[1];
+    float q3 = filter->q[2];
+    float q4 = filter->q[3];
+
+    // Auxiliary variables to avoid repeated arithmetic
+    float _2q1 = 2.0f * q1;
+    float _2q2 = 2.0f * q2;
+    float _2q3 = 2.0f * q3;
+    float _2q4 = 2.0f * q4;
+
+    float q1sq = q1 * q1;
+    float q2sq = q2 * q2;
+    float q3sq = q3 * q3;
+    float q4sq = q4 * q4;
+
+    float s1;
+    float s2;
+    float s3;
+    float s4;
+
+    if (mag != NULL) {
+        float q12 = q1 * q2;
+        float q13 = q1 * q3;
+        float q24 = q2 * q4;
+        float q34 = q3 * q4;
+
+        // Reference direction of Earth's magnetic field
+        float _2q1mx = _2q1 * mx;
+        float _2q1my = _2q1 * my;
+        float _2q1mz = _2q1 * mz;
+        float _2q2mx = _2q2 * mx;
+
+        float hx = (mx * q1sq) - (_2q1my * q4) + (_2q1mz * q3) + (mx * q2sq) + (_2q2 * my) * q3 + (_2q2 * mz * q4) - (mx * q3sq) - (mx * q4sq);
+        float hy = (_2q1mx * q4) + (my * q1sq) - (_2q1mz * q2) + (_2q2mx * q3) - (my * q2sq) + (my * q3sq) + (_2q3 * mz * q4) - (my * q4sq);
+
+        float _2bx = sqrtf((hx * hx) + (hy * hy));
+        float _2bz = (-_2q1mx * q3) + (_2q1my * q2) + (mz * q1sq) + (_2q2mx * q4) - (mz * q2sq) + (_2q3 * my * q4) - (mz * q3sq) + (mz * q4sq);
+        float _4bx = 2.0f * _2bx;
+        float _4bz = 2.0f * _2bz;
+
+        float temp1 = (2.0f * q24) - (2.0f * q13) - ax;
+        float temp2 = (2.0f * q12) + (2.0f * q34) - ay;
+        float temp3 = (_2bx * (0.5f - q3sq - q4sq)) + (_2bz * (q34 - q13)) - mx;
+        float temp4 = (_2bx * ((q2 * q3) - (q1 * q4))) + (_2bz * (q12 + q34)) - my;
+        float temp5 = (_2bx * (q13 + q24)) + (_2bz * (0.5f - q2sq - q3sq)) - mz;
+        float temp6 = 1.0f - (2.0f * q2sq) - (2 * q3sq) - az;
+        float temp7 = 4.0f * temp6;
+        float temp8 = _2bx * q3;
+        float temp9 = _2bx * q4;
+        float temp10 = _2bz * q4;
+        float temp11 = _2bz * q1;
+        float temp12 = _2bz * q2;
+        float temp13 = _2bx * q2;
+        float temp14 = _2bz * q3;
+        float temp15 = _2bx * q1;
+
+        // Gradient descent algorithm corrective step
+        s1 = (-_2q3 * temp1) + (_2q2 * temp2) - (temp14 * temp3) + ((temp9 + temp12) * temp4) + (temp8 * temp5);
+        s2 = (_2q4 * temp1) + (_2q1 * temp2) - (q2 * temp7) + (temp10 * temp3) + ((temp8 + temp11) * temp4) + ((temp9 - (_4bz * q2)) * temp5);
+        s3 = (-_2q1 * temp1) + (_2q4 * temp2) - (q3 * temp7) + ((-_4bx * q3 - temp11) * temp3) + ((temp13 + temp10) * temp4) + ((temp15 - (_4bz * q3)) * temp5);
+        s4 = (_2q2 * temp1) + (_2q3 * temp2) + (((-_4bx * q4) + temp12) * temp3) + ((-temp15 + temp14) * temp4) + (temp13 * temp5);
+    } else {
+        float _4q1 = _2q1 + _2q1;
+        float _4q2 = _2q2 + _2q2;
+        float _4q3 = _2q3 + _2q3;
+
+        float _8q2 = _4q2 + _4q2;
+        float _8q3 = _4q3 + _4q3;
+
+        // Gradient decent algorithm corrective step
+        s1 = (_4q1 * q3sq) + (_2q3 * ax) + (_4q1 * q2sq) - (_2q2 * ay);
+        s2 = (_4q2 * q4sq) - (_2q4 * ax) + (4 * q1sq * q2) - (_2q1 * ay) - _4q2 + (_8q2 * q2sq) + (_8q2 * q3sq) + (_4q2 * az);
+        s3 = (4 * q1sq * q3) + (_2q1 * ax) + (_4q3 * q4sq) - (_2q4 * ay) - _4q3 + (_8q3 * q2sq) + (_8q3 * q3sq) + (_4q3 * az);
+        s4 = (4 * q2sq * q4) - (_2q2 * ax) + (4 * q3sq * q4) - (_2q3 * ay);
+    }
+
+    norm = 1.0f / sqrtf((s1 * s1) + (s2 * s2) + (s3 * s3) + (s4 * s4));  // normalise step magnitude
+    s1 *= norm;
+    s2 *= norm;
+    s3 *= norm;
+    s4 *= norm;
+
+    float beta = filter->beta;
+
+    // Compute rate of change of quaternion
+    float qDot1 = 0.5f * ((-q2 * gx) - (q3 * gy) - (q4 * gz)) - (beta * s1);
+    float qDot2 = 0.5f * ((q1 * gx) + (q3 * gz) - (q4 * gy)) - (beta * s2);
+    float qDot3 = 0.5f * ((q1 * gy) - (q2 * gz) + (q4 * gx)) - (beta * s3);
+    float qDot4 = 0.5f * ((q1 * gz) + (q2 * gy) - (q3 * gx)) - (beta * s4);
+
+    // Integrate to yield quaternion
+    q1 += qDot1 * delta_t;
+    q2 += qDot2 * delta_t;
+    q3 += qDot3 * delta_t;
+    q4 += qDot4 * delta_t;
+
+    norm = 1.0f / sqrtf((q1 * q1) + (q2 * q2) + (q3 * q3) + (q4 * q4));  // normalise quaternion
+
+    q1 *= norm;
+    q2 *= norm;
+    q3 *= norm;
+    q4 *= norm;
+
+    filter->q[0] = q1;
+    filter->q[1] = q2;
+    filter->q[2] = q3;
+    filter->q[3] = q4;
+
+    return true;
+}
+
+
+/* One Mahony filter step.
+ * The error between the measured and the estimated direction of gravity (and
+ * of the magnetic field) is fed back into the gyro rates through a PI
+ * controller. It is a good bit cheaper than the gradient descent that the
+ * Madgwick filter does.
+ */
+static bool mahony_step(fusion_filter_t *filter, const float *accel, const float *gyro, const float *mag, float delta_t)
+{
+    float ax = accel[0];
+    float ay = accel[1];
+    float az = accel[2];
+
+    float norm = sqrtf((ax * ax) + (ay * ay) + (az * az));
+
+    if (norm == 0.0f) return false;
+
+    norm = 1.0f / norm;
+
+    ax *= norm;
+    ay *= norm;
+    az *= norm;
+
+    float q1 = filter->q[0];
+    float q2 = filter->q[1];
+    float q3 = filter->q[2];
+    float q4 = filter->q[3];
+
+    float q1q1 = q1 * q1;
+    float q1q2 = q1 * q2;
+    float q1q3 = q1 * q3;
+    float q1q4 = q1 * q4;
+    float q2q2 = q2 * q2;
+    float q2q3 = q2 * q3;
+    float q2q4 = q2 * q4;
+    float q3q3 = q3 * q3;
+    float q3q4 = q3 * q4;
+    float q4q4 = q4 * q4;
+
+    // Estimated direction of gravity, half size
+    float halfvx = q2q4 - q1q3;
+    float halfvy = q1q2 + q3q4;
+    float halfvz = q1q1 - 0.5f + q4q4;
+
+    // Error is the cross product of the measured and estimated directions
+    float halfex = (ay * halfvz) - (az * halfvy);
+    float halfey = (az * halfvx) - (ax * halfvz);
+    float halfez = (ax * halfvy) - (ay * halfvx);
+
+    if (mag != NULL) {
+        float mx = mag[0];
+        float my = mag[1];
+        float mz = mag[2];
+
+        norm = sqrtf((mx * mx) + (my * my) + (mz * mz));
+
+        if (norm == 0.0f) return false;
+
+        norm = 1.0f / norm;
+
+        mx *= norm;
+        my *= norm;
+        mz *= norm;
+
+        // Reference direction of Earth's magnetic field
+        float hx = 2.0f * ((mx * (0.5f - q3q3 - q4q4)) + (my * (q2q3 - q1q4)) + (mz * (q2q4 + q1q3)));
+        float hy = 2.0f * ((mx * (q2q3 + q1q4)) + (my * (0.5f - q2q2 - q4q4)) + (mz * (q3q4 - q1q2)));
+        float bx = sqrtf((hx * hx) + (hy * hy));
+        float bz = 2.0f * ((mx * (q2q4 - q1q3)) + (my * (q3q4 + q1q2)) + (mz * (0.5f - q2q2 - q3q3)));
+
+        // Estimated direction of the magnetic field, half size
+        float halfwx = (bx * (0.5f - q3q3 - q4q4)) + (bz * (q2q4 - q1q3));
+        float halfwy = (bx * (q2q3 - q1q4)) + (bz * (q1q2 + q3q4));
+        float halfwz = (bx * (q1q3 + q2q4)) + (bz * (0.5f - q2q2 - q3q3));
+
+        halfex += (my * halfwz) - (mz * halfwy);
+        halfey += (mz * halfwx) - (mx * halfwz);
+        halfez += (mx * halfwy) - (my * halfwx);
+    }
+
+    float gx = FUSION_RADIANS(gyro[0]);
+    float gy = FUSION_RADIANS(gyro[1]);
+    float gz = FUSION_RADIANS(gyro[2]);
+
+    if (filter->ki > 0.0f) {
+        filter->integral[0] += filter->ki * halfex * delta_t;
+        filter->integral[1] += filter->ki * halfey * delta_t;
+        filter->integral[2] += filter->ki * halfez * delta_t;
+
+        gx += filter->integral[0];
+        gy += filter->integral[1];
+        gz += filter->integral[2];
+    } else {
+        // stops the integral from winding up while it is turned off
+        filter->integral[0] = 0.0f;
+        filter->integral[1] = 0.0f;
+        filter->integral[2] = 0.0f;
+    }
+
+    gx += filter->kp * halfex;
+    gy += filter->kp * halfey;
+    gz += filter->kp * halfez;
+
+    // Integrate rate of change of quaternion
+    gx *= 0.5f * delta_t;
+    gy *= 0.5f * delta_t;
+    gz *= 0.5f * delta_t;
+
+    float qa = q1;
+    float qb = q2;
+    float qc = q3;
+
+    q1 += (-qb * gx) - (qc * gy) - (q4 * gz);
+    q2 += (qa * gx) + (qc * gz) - (q4 * gy);
+    q3 += (qa * gy) - (qb * gz) + (q4 * gx);
+    q4 += (qa * gz) + (qb * gy) - (qc * gx);
+
+    norm = 1.0f / sqrtf((q1 * q1) + (q2 * q2) + (q3 * q3) + (q4 * q4));
+
+    filter->q[0] = q1 * norm;
+    filter->q[1] = q2 * norm;
+    filter->q[2] = q3 * norm;
+    filter->q[3] = q4 * norm;
+
+    return true;
+}
+
+
+static uint32_t fusion_isqrt64(uint64_t value)
+{
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) bit >>= 2;
+
+    while (bit != 0) {
+        if (value >= res + bit) {
+            value -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)res;
+}
+
+
+// scales a Q16 vector to a length of 1.0, returns false for a zero vector
+static bool fusion_q16_normalise(int32_t *v, uint8_t n)
+{
+    uint64_t sum = 0;
+
+    for (uint8_t i = 0; i < n; i++) sum += (uint64_t)((int64_t)v[i] * (int64_t)v[i]);
+
+    uint32_t norm = fusion_isqrt64(sum);
+
+    if (norm == 0) return false;
+
+    for (uint8_t i = 0; i < n; i++) v[i] = (int32_t)(((int64_t)v[i] << 16) / (int64_t)norm);
+
+    return true;
+}
+
+
+/* One Madgwick filter step done in Q16 fixed point.
+ * The samples get converted once on the way in and the float quaternion is
+ * only written on the way out, everything in between is integer math so
+ * targets without an FPU don't end up in the soft float library. The
+ * magnetometer is not used.
+ */
+static bool madgwick_q16_step(fusion_filter_t *filter, const float *accel, const float *gyro, float delta_t)
+{
+    int32_t a[3] = {
+        FUSION_TO_Q16(accel[0]),
+        FUSION_TO_Q16(accel[1]),
+        FUSION_TO_Q16(accel[2])
+    };
+
+    if (!fusion_q16_normalise(a, 3)) return false;
+
+    int32_t ax = a[0];
+    int32_t ay = a[1];
+    int32_t az = a[2];
+
+    int32_t gx = FUSION_TO_Q16(FUSION_RADIANS(gyro[0]));
+    int32_t gy = FUSION_TO_Q16(FUSION_RADIANS(gyro[1]));
+    int32_t gz = FUSION_TO_Q16(FUSION_RADIANS(gyro[2]));
+
+    // Q24 keeps the resolution for short sample periods
+    int64_t dt = (int64_t)(delta_t * 16777216.0f);
+
+    int32_t q1 = filter->q16[0];
+    int32_t q2 = filter->q16[1];
+    int32_t q3 = filter->q16[2];
+    int32_t q4 = filter->q16[3];
+
+    int32_t _2q1 = 2 * q1;
+    int32_t _2q2 = 2 * q2;
+    int32_t _2q3 = 2 * q3;
+    int32_t _2q4 = 2 * q4;
+    int32_t _4q1 = 4 * q1;
+    int32_t _4q2 = 4 * q2;
+    int32_t _4q3 = 4 * q3;
+    int32_t _8q2 = 8 * q2;
+    int32_t _8q3 = 8 * q3;
+
+    int32_t q1sq = FUSION_Q16_MUL(q1, q1);
+    int32_t q2sq = FUSION_Q16_MUL(q2, q2);
+    int32_t q3sq = FUSION_Q16_MUL(q3, q3);
+    int32_t q4sq = FUSION_Q16_MUL(q4, q4);
+
+    // Gradient decent algorithm corrective step
+    int32_t s[4];
+    s[0] = FUSION_Q16_MUL(_4q1, q3sq) + FUSION_Q16_MUL(_2q3, ax) + FUSION_Q16_MUL(_4q1, q2sq) - FUSION_Q16_MUL(_2q2, ay);
+    s[1] = FUSION_Q16_MUL(_4q2, q4sq) - FUSION_Q16_MUL(_2q4, ax) + (4 * FUSION_Q16_MUL(q1sq, q2)) - FUSION_Q16_MUL(_2q1, ay) -
+           _4q2 + FUSION_Q16_MUL(_8q2, q2sq) + FUSION_Q16_MUL(_8q2, q3sq) + FUSION_Q16_MUL(_4q2, az);
+    s[2] = (4 * FUSION_Q16_MUL(q1sq, q3)) + FUSION_Q16_MUL(_2q1, ax) + FUSION_Q16_MUL(_4q3, q4sq) - FUSION_Q16_MUL(_2q4, ay) -
+           _4q3 + FUSION_Q16_MUL(_8q3, q2sq) + FUSION_Q16_MUL(_8q3, q3sq) + FUSION_Q16_MUL(_4q3, az);
+    s[3] = (4 * FUSION_Q16_MUL(q2sq, q4)) - FUSION_Q16_MUL(_2q2, ax) + (4 * FUSION_Q16_MUL(q3sq, q4)) - FUSION_Q16_MUL(_2q3, ay);
+
+    // already converged, only the gyro moves the quaternion
+    if (!fusion_q16_normalise(s, 4)) {
+        s[0] = 0;
+        s[1] = 0;
+        s[2] = 0;
+        s[3] = 0;
+    }
+
+    int32_t beta = FUSION_TO_Q16(filter->beta);
+
+    // Compute rate of change of quaternion
+    int32_t qDot1 = ((-FUSION_Q16_MUL(q2, gx) - FUSION_Q16_MUL(q3, gy) - FUSION_Q16_MUL(q4, gz)) / 2) - FUSION_Q16_MUL(beta, s[0]);
+    int32_t qDot2 = ((FUSION_Q16_MUL(q1, gx) + FUSION_Q16_MUL(q3, gz) - FUSION_Q16_MUL(q4, gy)) / 2) - FUSION_Q16_MUL(beta, s[1]);
+    int32_t qDot3 = ((FUSION_Q16_MUL(q1, gy) - FUSION_Q16_MUL(q2, gz) + FUSION_Q16_MUL(q4, gx)) / 2) - FUSION_Q16_MUL(beta, s[2]);
+    int32_t qDot4 = ((FUSION_Q16_MUL(q1, gz) + FUSION_Q16_MUL(q2, gy) - FUSION_Q16_MUL(q3, gx)) / 2) - FUSION_Q16_MUL(beta, s[3]);
+
+    // Integrate to yield quaternion
+    int32_t q[4] = {
+        q1 + (int32_t)(((int64_t)qDot1 * dt) >> 24),
+        q2 + (int32_t)(((int64_t)qDot2 * dt) >> 24),
+        q3 + (int32_t)(((int64_t)qDot3 * dt) >> 24),
+        q4 + (int32_t)(((int64_t)qDot4 * dt) >> 24)
+    };
+
+    if (!fusion_q16_normalise(q, 4)) return false;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        filter->q16[i] = q[i];
+        filter->q[i] = (float)q[i] * (1.0f / 65536.0f);
+    }
+
+    return true;
+}
+
+
+/* calibration
+ * The samples that go through fusion_step get added to running sums so the
+ * calibration happens while the filter keeps running, nothing calls back into
+ * Python. The gyro bias is the mean of the readings while the device sits
+ * still. The magnetometer gets an axis aligned ellipsoid fit which gives the
+ * hard iron offset (center) and the soft iron scale (radii). The min/max
+ * method is the fallback if the fit doesn't work out.
+ *
+ * The fit is x^2 + b y^2 + c z^2 + d x + e y + f z + g = 0. With the constant
+ * term in there it doesn't matter where the origin of the sums is, the
+ * a x^2 + ... = 1 form needs the origin well inside the ellipsoid and the
+ * first sample is on its surface.
+ */
+static void fusion_cal_add(fusion_cal_t *cal, const float *gyro, const float *mag)
+{
+    if (cal->gyro) {
+        cal->gyro_sum[0] += gyro[0];
+        cal->gyro_sum[1] += gyro[1];
+        cal->gyro_sum[2] += gyro[2];
+    }
+
+    if (cal->mag && mag != NULL) {
+        if (cal->mag_count == 0) {
+            for (uint8_t i = 0; i < 3; i++) {
+                cal->mag_origin[i] = mag[i];
+                cal->mag_min[i] = mag[i];
+                cal->mag_max[i] = mag[i];
+            }
+        } else {
+            for (uint8_t i = 0; i < 3; i++) {
+                cal->mag_min[i] = FUSION_MIN(cal->mag_min[i], mag[i]);
+                cal->mag_max[i] = FUSION_MAX(cal->mag_max[i], mag[i]);
+            }
+        }
+
+        double x = (double)(mag[0] - cal->mag_origin[0]);
+        double y = (double)(mag[1] - cal->mag_origin[1]);
+        double z = (double)(mag[2] - cal->mag_origin[2]);
+
+        double row[6] = { y * y, z * z, x, y, z, 1.0 };
+        double rhs = -(x * x);
+
+        for (uint8_t i = 0; i < 6; i++) {
+            cal->atb[i] += row[i] * rhs;
+            for (uint8_t j = i; j < 6; j++) cal->ata[i][j] += row[i] * row[j];
+        }
+
+        cal->mag_count++;
+    }
+
+    cal->count++;
+}
+
+
+// Gaussian elimination with partial pivoting, the result ends up in b
+static bool fusion_cal_solve(double a[6][6], double *b)
+{
+    for (uint8_t col = 0; col < 6; col++) {
+        uint8_t pivot = col;
+
+        for (uint8_t row = col + 1; row < 6; row++) {
+            if (fabs(a[row][col]) > fabs(a[pivot][col])) pivot = row;
+        }
+
+        if (fabs(a[pivot][col]) < 1e-12) return false;
+
+        if (pivot != col) {
+            for (uint8_t i = 0; i < 6; i++) {
+                double tmp = a[col][i];
+                a[col][i] = a[pivot][i];
+                a[pivot][i] = tmp;
+            }
+            double tmp = b[col];
+            b[col] = b[pivot];
+            b[pivot] = tmp;
+        }
+
+        for (uint8_t row = col + 1; row < 6; row++) {
+            double factor = a[row][col] / a[col][col];
+            for (uint8_t i = col; i < 6; i++) a[row][i] -= factor * a[col][i];
+            b[row] -= factor * b[col];
+        }
+    }
+
+    for (int8_t row = 5; row >= 0; row--) {
+        double sum = b[row];
+        for (uint8_t i = (uint8_t)row + 1; i < 6; i++) sum -= a[row][i] * b[i];
+        b[row] = sum / a[row][row];
+    }
+
+    return true;
+}
+
+
+static void fusion_cal_finish(fusion_filter_t *filter)
+{
+    fusion_cal_t *cal = filter->cal;
+
+    if (cal->gyro && cal->count > 0) {
+        for (uint8_t i = 0; i < 3; i++) filter->gyro_bias[i] = cal->gyro_sum[i] / (float)cal->count;
+    }
+
+    if (cal->mag && cal->mag_count >= 6) {
+        double a[6][6];
+        double p[6];
+
+        // only the upper triangle got summed
+        for (uint8_t i = 0; i < 6; i++) {
+            p[i] = cal->atb[i];
+            for (uint8_t j = 0; j < 6; j++) a[i][j] = (j >= i) ? cal->ata[i][j] : cal->ata[j][i];
+        }
+
+        bool fitted = fusion_cal_solve(a, p) && p[0] > 0.0 && p[1] > 0.0;
+        double radii[3];
+
+        // x^2 + b y^2 + c z^2 + d x + e y + f z + g = 0 is
+        // (x - x0)^2 + b (y - y0)^2 + c (z - z0)^2 = k
+        double coef[3] = { 1.0, p[0], p[1] };
+        double center[3];
+        double k = -p[5];
+
+        if (fitted) {
+            for (uint8_t i = 0; i < 3; i++) {
+                center[i] = -p[i + 2] / (2.0 * coef[i]);
+                k += coef[i] * center[i] * center[i];
+            }
+
+            fitted = k > 0.0;
+        }
+
+        if (fitted) {
+            for (uint8_t i = 0; i < 3; i++) {
+                filter->mag_bias[i] = cal->mag_origin[i] + (float)center[i];
+                radii[i] = sqrt(k / coef[i]);
+            }
+        } else {
+            for (uint8_t i = 0; i < 3; i++) {
+                filter->mag_bias[i] = (cal->mag_min[i] + cal->mag_max[i]) / 2.0f;
+                radii[i] = (double)(cal->mag_max[i] - cal->mag_min[i]) / 2.0;
+            }
+        }
+
+        double avg = (radii[0] + radii[1] + radii[2]) / 3.0;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            filter->mag_scale[i] = (radii[i] > 0.0) ? (float)(avg / radii[i]) : 1.0f;
+        }
+    }
+
+    filter->cal = NULL;
+    filter->cal_state = FUSION_CAL_DONE;
+}
+/* end calibration */
+
+
+bool fusion_filter_step(fusion_filter_t *filter, const float *accel, const float *gyro, const float *mag, float delta_t)
+{
+    if (filter->cal != NULL) {
+        fusion_cal_add(filter->cal, gyro, mag);
+        if (filter->cal->count >= filter->cal->target) fusion_cal_finish(filter);
+    }
+
+    float g[3] = {
+        gyro[0] - filter->gyro_bias[0],
+        gyro[1] - filter->gyro_bias[1],
+        gyro[2] - filter->gyro_bias[2]
+    };
+
+    float m[3];
+
+    if (mag != NULL) {
+        for (uint8_t i = 0; i < 3; i++) m[i] = (mag[i] - filter->mag_bias[i]) * filter->mag_scale[i];
+        mag = m;
+    }
+
+    switch (filter->algorithm) {
+        case FUSION_ALGORITHM_MAHONY:
+            return mahony_step(filter, accel, g, mag, delta_t);
+        case FUSION_ALGORITHM_MADGWICK_Q16:
+            return madgwick_q16_step(filter, accel, g, delta_t);
+        default:
+            return madgwick_step(filter, accel, g, mag, delta_t);
+    }
+}
+
+
+void fusion_filter_euler(fusion_filter_t *filter, bool use_mag, float *roll_out, float *pitch_out, float *yaw_out)
+{
+    float q1 = filter->q[0];
+    float q2 = filter->q[1];
+    float q3 = filter->q[2];
+    float q4 = filter->q[3];
+
+    float q1sq = q1 * q1;
+    float q2sq = q2 * q2;
+    float q3sq = q3 * q3;
+    float q4sq = q4 * q4;
+
+    float roll;
+    float pitch;
+    float yaw;
+
+    pitch = FUSION_DEGREES(-asinf(2.0f * ((q2 * q4) - (q1 * q3))));
+    roll = FUSION_DEGREES(atan2f(2.0f * ((q1 * q2) + (q3 * q4)), q1sq - q2sq - q3sq + q4sq));
+
+    if (use_mag) {
+        yaw = FUSION_DEGREES(atan2f(2.0f * ((q2 * q3) + (q1 * q4)), q1sq + q2sq - q3sq - q4sq));
+        yaw += filter->declination;
+    } else {
+        yaw = 0.0f;
+    }
+
+    *roll_out = roll;
+    *pitch_out = pitch;
+    *yaw_out = yaw;
+}
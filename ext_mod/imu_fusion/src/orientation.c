@@ -0,0 +1,191 @@
+
+
+#include "fusion.h"
+#include "orientation.h"
+#include "mphalport.h"
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include <math.h>
+
+
+static float wrap_360(float angle)
+{
+    angle = fmodf(angle, 360.0f);
+    if (angle < 0.0f) angle += 360.0f;
+    return angle;
+}
+
+
+/* Moves the state machine along with a new angle.
+ *
+ * The angle has to go hysteresis degrees past the 45 degree boundary of the
+ * current quadrant before the new quadrant becomes a candidate, and the
+ * candidate has to hold for dwell milliseconds before it is confirmed. That
+ * stops a device held near a boundary from flipping the display back and
+ * forth.
+ *
+ * Returns true if the rotation changed.
+ */
+static bool orientation_step(mp_orientation_tracker_obj_t *self, float angle)
+{
+    angle = wrap_360(angle + self->adjustment);
+
+    int8_t quadrant = (int8_t)((int)((angle + 45.0f) / 90.0f) % 4);
+
+    float distance = fabsf(wrap_360(angle - (float)self->rotation * 90.0f + 180.0f) - 180.0f);
+
+    if (quadrant == self->rotation || distance < 45.0f + self->hysteresis) {
+        self->candidate = ORIENTATION_NONE;
+        return false;
+    }
+
+    uint32_t now = mp_hal_ticks_ms();
+
+    if (quadrant != self->candidate) {
+        self->candidate = quadrant;
+        self->candidate_ts = now;
+    }
+
+    if (now - self->candidate_ts < self->dwell) return false;
+
+    self->rotation = quadrant;
+    self->candidate = ORIENTATION_NONE;
+    return true;
+}
+
+
+static mp_obj_t orientation_tracker_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_callback,
+        ARG_hysteresis,
+        ARG_dwell,
+        ARG_adjustment,
+        ARG_rotation
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_callback,   MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+        { MP_QSTR_hysteresis, MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+        { MP_QSTR_dwell,      MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 300           } },
+        { MP_QSTR_adjustment, MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+        { MP_QSTR_rotation,   MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0             } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    mp_orientation_tracker_obj_t *self = m_new_obj(mp_orientation_tracker_obj_t);
+    self->base.type = &mp_orientation_tracker_type;
+
+    self->callback = args[ARG_callback].u_obj;
+
+    if (args[ARG_hysteresis].u_obj == mp_const_none) self->hysteresis = 15.0f;
+    else self->hysteresis = mp_obj_get_float_to_f(args[ARG_hysteresis].u_obj);
+
+    if (self->hysteresis < 0.0f || self->hysteresis >= 45.0f) {
+        mp_raise_ValueError(MP_ERROR_TEXT("hysteresis range is 0.0 to 45.0"));
+    }
+
+    if (args[ARG_adjustment].u_obj == mp_const_none) self->adjustment = 0.0f;
+    else self->adjustment = mp_obj_get_float_to_f(args[ARG_adjustment].u_obj);
+
+    if (args[ARG_dwell].u_int < 0) self->dwell = 0;
+    else self->dwell = (uint32_t)args[ARG_dwell].u_int;
+
+    self->rotation = (int8_t)(args[ARG_rotation].u_int & 0x3);
+    self->candidate = ORIENTATION_NONE;
+    self->candidate_ts = 0;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+/* update(angle)
+ * angle is either the roll in degrees or a fusion.Fusion object, in which
+ * case the roll gets taken straight from the filter's quaternion.
+ *
+ * Returns the new rotation (0 - 3) if it changed otherwise None. The callback
+ * only gets called when the rotation changes.
+ */
+static mp_obj_t orientation_tracker_update(mp_obj_t self_in, mp_obj_t angle_in)
+{
+    mp_orientation_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    float angle;
+
+    if (mp_obj_is_type(angle_in, &mp_fusion_type)) {
+        float pitch;
+        float yaw;
+        mp_fusion_obj_t *fusion = MP_OBJ_TO_PTR(angle_in);
+        fusion_filter_euler(&fusion->filter, false, &angle, &pitch, &yaw);
+    } else {
+        angle = mp_obj_get_float_to_f(angle_in);
+    }
+
+    if (!orientation_step(self, angle)) return mp_const_none;
+
+    mp_obj_t rotation = mp_obj_new_int(self->rotation);
+
+    if (self->callback != mp_const_none) mp_call_function_1(self->callback, rotation);
+
+    return rotation;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(orientation_tracker_update_obj, orientation_tracker_update);
+
+
+static mp_obj_t orientation_tracker_set_rotation(mp_obj_t self_in, mp_obj_t rotation_in)
+{
+    mp_orientation_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    self->rotation = (int8_t)(mp_obj_get_int(rotation_in) & 0x3);
+    self->candidate = ORIENTATION_NONE;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(orientation_tracker_set_rotation_obj, orientation_tracker_set_rotation);
+
+
+static mp_obj_t orientation_tracker_get_rotation(mp_obj_t self_in)
+{
+    mp_orientation_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int(self->rotation);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(orientation_tracker_get_rotation_obj, orientation_tracker_get_rotation);
+
+
+static mp_obj_t orientation_tracker_set_adjustment(mp_obj_t self_in, mp_obj_t adjustment_in)
+{
+    mp_orientation_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    self->adjustment = mp_obj_get_float_to_f(adjustment_in);
+    self->candidate = ORIENTATION_NONE;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(orientation_tracker_set_adjustment_obj, orientation_tracker_set_adjustment);
+
+
+static const mp_rom_map_elem_t orientation_tracker_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_update),         MP_ROM_PTR(&orientation_tracker_update_obj)         },
+    { MP_ROM_QSTR(MP_QSTR_set_rotation),   MP_ROM_PTR(&orientation_tracker_set_rotation_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_get_rotation),   MP_ROM_PTR(&orientation_tracker_get_rotation_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_set_adjustment), MP_ROM_PTR(&orientation_tracker_set_adjustment_obj) },
+};
+
+static MP_DEFINE_CONST_DICT(orientation_tracker_locals_dict, orientation_tracker_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_orientation_tracker_type,
+    MP_QSTR_OrientationTracker,
+    MP_TYPE_FLAG_NONE,
+    make_new, orientation_tracker_make_new,
+    locals_dict, (mp_obj_dict_t *)&orientation_tracker_locals_dict
+);
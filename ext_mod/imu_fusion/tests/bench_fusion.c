@@ -0,0 +1,161 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host benchmark for the fusion filters, run with "make -C ext_mod/imu_fusion/tests"
+//
+// A synthetic roll/pitch trajectory gets turned into accelerometer and gyro
+// samples with noise added, every filter is run over the same samples and
+// the error against the trajectory and the update rate are printed. It fails
+// if a filter doesn't track the trajectory.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "fusion_engine.h"
+
+
+#define SAMPLES       (200000)
+#define SAMPLE_RATE   (125.0f)  // Hz
+#define SETTLE        (2000)    // samples skipped before the error is measured
+#define MAX_RMS       (1.0)     // degrees
+
+#define PI            3.14159265358979323846f
+#define RADIANS(d)    ((d) * PI / 180.0f)
+#define DEGREES(r)    ((r) * 180.0f / PI)
+
+
+typedef struct {
+    float accel[SAMPLES][3];
+    float gyro[SAMPLES][3];
+    float roll[SAMPLES];
+    float pitch[SAMPLES];
+} trajectory_t;
+
+
+// fixed seed LCG so every run and every libc gets the same samples
+static uint32_t noise_state = 1;
+
+static float noise(float amplitude)
+{
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return ((float)(noise_state >> 8) / 8388608.0f - 1.0f) * amplitude;
+}
+
+
+/* roll = 40 sin(0.5 t) and pitch = 25 sin(0.3 t + 1) degrees with the yaw
+ * held at 0. The gyro gets the body rates for that ZYX rotation with +-0.3
+ * deg/s of noise and the accelerometer gets gravity with +-0.02 g of noise.
+ */
+static void make_trajectory(trajectory_t *traj)
+{
+    float dt = 1.0f / SAMPLE_RATE;
+
+    for (size_t i = 0; i < SAMPLES; i++) {
+        float t = (float)i * dt;
+
+        float roll = RADIANS(40.0f * sinf(0.5f * t));
+        float pitch = RADIANS(25.0f * sinf(0.3f * t + 1.0f));
+        float roll_rate = RADIANS(40.0f * 0.5f * cosf(0.5f * t));
+        float pitch_rate = RADIANS(25.0f * 0.3f * cosf(0.3f * t + 1.0f));
+
+        traj->gyro[i][0] = DEGREES(roll_rate) + noise(0.3f);
+        traj->gyro[i][1] = DEGREES(pitch_rate * cosf(roll)) + noise(0.3f);
+        traj->gyro[i][2] = DEGREES(-pitch_rate * sinf(roll)) + noise(0.3f);
+
+        traj->accel[i][0] = -sinf(pitch) + noise(0.02f);
+        traj->accel[i][1] = sinf(roll) * cosf(pitch) + noise(0.02f);
+        traj->accel[i][2] = cosf(roll) * cosf(pitch) + noise(0.02f);
+
+        traj->roll[i] = DEGREES(roll);
+        traj->pitch[i] = DEGREES(pitch);
+    }
+}
+
+
+static double seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+// returns false if the filter didn't track the trajectory
+static bool run(const char *name, uint8_t algorithm, const trajectory_t *traj)
+{
+    fusion_filter_t filter;
+    float dt = 1.0f / SAMPLE_RATE;
+
+    // timed on its own so the error bookkeeping doesn't count
+    fusion_filter_init(&filter, algorithm);
+    filter.beta = 0.1f;
+
+    double start = seconds();
+    for (size_t i = 0; i < SAMPLES; i++) fusion_filter_step(&filter, traj->accel[i], traj->gyro[i], NULL, dt);
+    double elapsed = seconds() - start;
+
+    fusion_filter_init(&filter, algorithm);
+    filter.beta = 0.1f;
+
+    double sum_sq = 0.0;
+    double max_err = 0.0;
+    size_t n = 0;
+
+    for (size_t i = 0; i < SAMPLES; i++) {
+        fusion_filter_step(&filter, traj->accel[i], traj->gyro[i], NULL, dt);
+
+        if (i < SETTLE) continue;
+
+        float roll;
+        float pitch;
+        float yaw;
+
+        fusion_filter_euler(&filter, false, &roll, &pitch, &yaw);
+
+        double errs[2] = { roll - traj->roll[i], pitch - traj->pitch[i] };
+
+        for (uint8_t j = 0; j < 2; j++) {
+            sum_sq += errs[j] * errs[j];
+            if (fabs(errs[j]) > max_err) max_err = fabs(errs[j]);
+            n++;
+        }
+    }
+
+    double rms = sqrt(sum_sq / (double)n);
+
+    printf("%-13s rms %.2f deg, max %.2f deg, %.1f M updates/s\n",
+           name, rms, max_err, (double)SAMPLES / elapsed / 1e6);
+
+    return rms <= MAX_RMS;
+}
+
+
+int main(void)
+{
+    trajectory_t *traj = malloc(sizeof(trajectory_t));
+
+    if (traj == NULL) return 1;
+
+    make_trajectory(traj);
+
+    printf("%d samples at %.0f Hz, beta=0.1, kp=1.0, ki=0.0\n", SAMPLES, (double)SAMPLE_RATE);
+
+    bool ok = true;
+
+    ok &= run("madgwick", FUSION_ALGORITHM_MADGWICK, traj);
+    ok &= run("mahony", FUSION_ALGORITHM_MAHONY, traj);
+    ok &= run("madgwick_q16", FUSION_ALGORITHM_MADGWICK_Q16, traj);
+
+    free(traj);
+
+    if (!ok) {
+        printf("bench_fusion: a filter is off by more than %.1f deg rms\n", MAX_RMS);
+        return 1;
+    }
+
+    printf("bench_fusion: ok\n");
+    return 0;
+}
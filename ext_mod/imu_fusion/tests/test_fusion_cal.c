@@ -0,0 +1,137 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host tests for the calibration, run with "make -C ext_mod/imu_fusion/tests"
+
+#include <math.h>
+#include <stdio.h>
+
+#include "fusion_engine.h"
+
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(value, expected, tolerance) CHECK(fabs((double)(value) - (double)(expected)) <= (tolerance))
+
+
+static uint32_t noise_state = 1;
+
+static float noise(float amplitude)
+{
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return ((float)(noise_state >> 8) / 8388608.0f - 1.0f) * amplitude;
+}
+
+
+// runs samples points of an axis aligned ellipsoid through a mag calibration
+static void run_mag_cal(fusion_filter_t *filter, const float *center, const float *radii, uint32_t samples, float jitter)
+{
+    static const float accel[3] = { 0.0f, 0.0f, 1.0f };
+    static const float gyro[3] = { 0.0f, 0.0f, 0.0f };
+    fusion_cal_t cal;
+
+    fusion_filter_init(filter, FUSION_ALGORITHM_MADGWICK);
+    fusion_filter_start_cal(filter, &cal, samples, false, true);
+
+    for (uint32_t i = 0; i < samples; i++) {
+        float v[3];
+        float norm;
+
+        do {
+            v[0] = noise(1.0f);
+            v[1] = noise(1.0f);
+            v[2] = noise(1.0f);
+            norm = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        } while (norm < 0.1f || norm > 1.0f);
+
+        float mag[3];
+        for (uint8_t j = 0; j < 3; j++) mag[j] = center[j] + radii[j] * v[j] / norm + noise(jitter);
+
+        fusion_filter_step(filter, accel, gyro, mag, 0.01f);
+    }
+
+    CHECK(filter->cal_state == FUSION_CAL_DONE);
+    CHECK(filter->cal == NULL);
+}
+
+
+static void test_ellipsoid(void)
+{
+    const float center[3] = { 30.0f, -20.0f, 10.0f };
+    const float radii[3] = { 40.0f, 50.0f, 45.0f };
+    fusion_filter_t filter;
+
+    run_mag_cal(&filter, center, radii, 500, 0.0f);
+
+    float avg = (radii[0] + radii[1] + radii[2]) / 3.0f;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK_NEAR(filter.mag_bias[i], center[i], 0.01);
+        CHECK_NEAR(filter.mag_scale[i], avg / radii[i], 0.001);
+    }
+}
+
+
+static void test_ellipsoid_noisy(void)
+{
+    // a large offset compared to the field and some sensor noise
+    const float center[3] = { -350.0f, 120.0f, 800.0f };
+    const float radii[3] = { 48.0f, 52.0f, 44.0f };
+    fusion_filter_t filter;
+
+    run_mag_cal(&filter, center, radii, 1000, 0.5f);
+
+    float avg = (radii[0] + radii[1] + radii[2]) / 3.0f;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK_NEAR(filter.mag_bias[i], center[i], 0.5);
+        CHECK_NEAR(filter.mag_scale[i], avg / radii[i], 0.02);
+    }
+}
+
+
+static void test_gyro_bias(void)
+{
+    static const float accel[3] = { 0.0f, 0.0f, 1.0f };
+    const float bias[3] = { 0.5f, -1.25f, 2.0f };
+    fusion_filter_t filter;
+    fusion_cal_t cal;
+
+    fusion_filter_init(&filter, FUSION_ALGORITHM_MADGWICK);
+    fusion_filter_start_cal(&filter, &cal, 200, true, false);
+
+    for (uint32_t i = 0; i < 200; i++) {
+        float gyro[3] = { bias[0] + noise(0.1f), bias[1] + noise(0.1f), bias[2] + noise(0.1f) };
+        fusion_filter_step(&filter, accel, gyro, NULL, 0.01f);
+    }
+
+    CHECK(filter.cal_state == FUSION_CAL_DONE);
+
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK_NEAR(filter.gyro_bias[i], bias[i], 0.02);
+        CHECK_NEAR(filter.mag_bias[i], 0.0, 0.0);
+        CHECK_NEAR(filter.mag_scale[i], 1.0, 0.0);
+    }
+}
+
+
+int main(void)
+{
+    test_ellipsoid();
+    test_ellipsoid_noisy();
+    test_gyro_bias();
+
+    if (failures) {
+        printf("test_fusion_cal: %d failed\n", failures);
+        return 1;
+    }
+
+    printf("test_fusion_cal: ok\n");
+    return 0;
+}
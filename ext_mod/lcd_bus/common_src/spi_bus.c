@@ -82,6 +82,7 @@
     mp_lcd_err_t s_spi_get_lane_count(mp_obj_t obj, uint8_t *lane_count);
     mp_lcd_err_t s_spi_rx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
     mp_lcd_err_t s_spi_tx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
+    mp_lcd_err_t s_spi_tx_params(mp_obj_t obj, const uint8_t *seq, size_t seq_size);
     mp_lcd_err_t s_spi_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update);
 
     void send_param_16(mp_lcd_spi_bus_obj_t *self, void *param, size_t param_size);
@@ -166,6 +167,7 @@
         self->panel_io_handle.del = s_spi_del;
         self->panel_io_handle.init = s_spi_init;
         self->panel_io_handle.tx_param = s_spi_tx_param;
+        self->panel_io_handle.tx_params = s_spi_tx_params;
         self->panel_io_handle.rx_param = s_spi_rx_param;
         self->panel_io_handle.tx_color = s_spi_tx_color;
         self->panel_io_handle.get_lane_count = s_spi_get_lane_count;
@@ -272,6 +274,35 @@
     }
 
 
+    // the whole batch gets sent with CS held active, the DC line is what
+    // separates the commands from each other. lcd_panel_io_tx_params has
+    // already checked that seq only holds complete command records.
+    mp_lcd_err_t s_spi_tx_params(mp_obj_t obj, const uint8_t *seq, size_t seq_size)
+    {
+        mp_lcd_spi_bus_obj_t *self = MP_OBJ_TO_PTR(obj);
+
+        size_t pos = 0;
+        uint32_t lcd_cmd;
+        size_t param_size;
+
+        CS_ON();
+
+        while (pos < seq_size) {
+            lcd_seq_read_cmd(seq, seq_size, &pos, &lcd_cmd, &param_size);
+            self->send_cmd(self, (int)lcd_cmd);
+
+            if (param_size) {
+                self->send_param(self, (void *)(seq + pos), param_size);
+            }
+
+            pos += param_size;
+        }
+
+        CS_OFF();
+        return LCD_OK;
+    }
+
+
     mp_lcd_err_t s_spi_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update)
     {
         LCD_UNUSED(x_start);
@@ -380,6 +411,8 @@ static const mp_rom_map_elem_t mp_lcd_spi_bus_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
     { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
     { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_tx_params),            MP_ROM_PTR(&mp_lcd_bus_tx_params_obj)            },
+    { MP_ROM_QSTR(MP_QSTR_tx_init_seq),          MP_ROM_PTR(&mp_lcd_bus_tx_init_seq_obj)          },
     { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
     { MP_ROM_QSTR(MP_QSTR_rx_param),             MP_ROM_PTR(&mp_lcd_bus_rx_param_obj)             },
     { MP_ROM_QSTR(MP_QSTR_init),                 MP_ROM_PTR(&mp_lcd_bus_init_obj)                 },
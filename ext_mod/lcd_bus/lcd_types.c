@@ -9,6 +9,9 @@
 #include "py/objarray.h"
 #include "py/binary.h"
 
+// stdlib includes
+#include <string.h>
+
 void rgb565_byte_swap(void *buf, uint32_t buf_size_px)
 {
     uint16_t *buf16 = (uint16_t *)buf;
@@ -352,3 +355,105 @@ mp_lcd_err_t lcd_panel_io_get_lane_count(mp_obj_t obj, uint8_t *lane_count)
 
     return self->panel_io_handle.get_lane_count(obj, lane_count);
 }
+
+
+mp_lcd_err_t lcd_seq_read_cmd(const uint8_t *seq, size_t seq_size, size_t *pos, uint32_t *lcd_cmd, size_t *param_size)
+{
+    size_t p = *pos;
+
+    switch (seq[p]) {
+        case LCD_SEQ_CMD8:
+            if (p + 3 > seq_size) return LCD_ERR_INVALID_SIZE;
+            *lcd_cmd = seq[p + 1];
+            *param_size = seq[p + 2];
+            p += 3;
+            break;
+
+        case LCD_SEQ_CMD16:
+            if (p + 4 > seq_size) return LCD_ERR_INVALID_SIZE;
+            *lcd_cmd = (uint32_t)seq[p + 1] | ((uint32_t)seq[p + 2] << 8);
+            *param_size = seq[p + 3];
+            p += 4;
+            break;
+
+        case LCD_SEQ_CMD32:
+            if (p + 7 > seq_size) return LCD_ERR_INVALID_SIZE;
+            *lcd_cmd = (uint32_t)seq[p + 1] | ((uint32_t)seq[p + 2] << 8) |
+                       ((uint32_t)seq[p + 3] << 16) | ((uint32_t)seq[p + 4] << 24);
+            *param_size = (size_t)seq[p + 5] | ((size_t)seq[p + 6] << 8);
+            p += 7;
+            break;
+
+        default:
+            return LCD_ERR_INVALID_ARG;
+    }
+
+    if (p + *param_size > seq_size) return LCD_ERR_INVALID_SIZE;
+
+    *pos = p;
+    return LCD_OK;
+}
+
+
+// checks that seq only holds complete command records so a bus is able to
+// send it without having to stop part way through a transaction
+mp_lcd_err_t lcd_seq_check_cmds(const uint8_t *seq, size_t seq_size)
+{
+    size_t pos = 0;
+    uint32_t lcd_cmd;
+    size_t param_size;
+    mp_lcd_err_t ret;
+
+    while (pos < seq_size) {
+        ret = lcd_seq_read_cmd(seq, seq_size, &pos, &lcd_cmd, &param_size);
+        if (ret != LCD_OK) return ret;
+        pos += param_size;
+    }
+
+    return LCD_OK;
+}
+
+
+mp_lcd_err_t lcd_panel_io_tx_params(mp_obj_t obj, const uint8_t *seq, size_t seq_size)
+{
+    mp_lcd_bus_obj_t *self = (mp_lcd_bus_obj_t *)obj;
+
+    mp_lcd_err_t ret = lcd_seq_check_cmds(seq, seq_size);
+    if (ret != LCD_OK) return ret;
+
+    if (self->panel_io_handle.tx_params != NULL) {
+        return self->panel_io_handle.tx_params(obj, seq, seq_size);
+    }
+
+    LCD_DEBUG_PRINT("lcd_panel_io_tx_params(self, seq, seq_size=%d)\n", seq_size)
+
+    uint8_t stack_params[LCD_SEQ_STACK_PARAMS];
+    size_t pos = 0;
+    uint32_t lcd_cmd;
+    size_t param_size;
+
+    while (pos < seq_size) {
+        lcd_seq_read_cmd(seq, seq_size, &pos, &lcd_cmd, &param_size);
+
+        // The sequence is often a frozen bytes object that lives in flash
+        // which the bus might not be able to send from. The parameters get
+        // copied to RAM first.
+        if (param_size == 0) {
+            ret = lcd_panel_io_tx_param(obj, (int)lcd_cmd, NULL, 0);
+        } else if (param_size <= LCD_SEQ_STACK_PARAMS) {
+            memcpy(stack_params, seq + pos, param_size);
+            ret = lcd_panel_io_tx_param(obj, (int)lcd_cmd, stack_params, param_size);
+        } else {
+            uint8_t *params = m_new(uint8_t, param_size);
+            memcpy(params, seq + pos, param_size);
+            ret = lcd_panel_io_tx_param(obj, (int)lcd_cmd, params, param_size);
+            m_del(uint8_t, params, param_size);
+        }
+
+        if (ret != LCD_OK) return ret;
+
+        pos += param_size;
+    }
+
+    return LCD_OK;
+}
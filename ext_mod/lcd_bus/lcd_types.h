@@ -12,6 +12,19 @@
 
     typedef struct _lcd_panel_io_t lcd_panel_io_t;
 
+    // binary init sequence opcodes, all multi byte values are little endian.
+    // The sequences are made by builder/init_seq_compiler.py,
+    // tx_params only accepts the command records (0x01 - 0x03)
+    #define LCD_SEQ_END        (0x00)  // end of the sequence (optional)
+    #define LCD_SEQ_CMD8       (0x01)  // cmd:u8  len:u8  params[len]
+    #define LCD_SEQ_CMD16      (0x02)  // cmd:u16 len:u8  params[len]
+    #define LCD_SEQ_CMD32      (0x03)  // cmd:u32 len:u16 params[len]
+    #define LCD_SEQ_DELAY      (0x04)  // ms:u16
+    #define LCD_SEQ_REPEAT     (0x05)  // count:u8 len:u16 body[len], body is played count times
+
+    // parameters up to this size are copied to the stack before being sent
+    #define LCD_SEQ_STACK_PARAMS  (64)
+
     #ifdef ESP_IDF_VERSION
         #include "sdkconfig.h"
 
@@ -57,6 +70,7 @@
         mp_lcd_err_t (*init)(mp_obj_t obj, uint16_t width, uint16_t height, uint8_t bpp, uint32_t buffer_size, bool rgb565_byte_swap, uint8_t cmd_bits, uint8_t param_bits);
         mp_lcd_err_t (*rx_param)(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
         mp_lcd_err_t (*tx_param)(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
+        mp_lcd_err_t (*tx_params)(mp_obj_t obj, const uint8_t *seq, size_t seq_size);  // optional
         mp_lcd_err_t (*tx_color)(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update);
         mp_obj_t (*allocate_framebuffer)(mp_obj_t obj, uint32_t size, uint32_t caps);
         mp_obj_t (*free_framebuffer)(mp_obj_t obj, mp_obj_t buf);
@@ -73,6 +87,9 @@
     mp_lcd_err_t lcd_panel_io_init(mp_obj_t obj, uint16_t width, uint16_t height, uint8_t bpp, uint32_t buffer_size, bool rgb565_byte_swap, uint8_t cmd_bits, uint8_t param_bits);
     mp_lcd_err_t lcd_panel_io_rx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
     mp_lcd_err_t lcd_panel_io_tx_param(mp_obj_t obj, int lcd_cmd, void *param, size_t param_size);
+    mp_lcd_err_t lcd_panel_io_tx_params(mp_obj_t obj, const uint8_t *seq, size_t seq_size);
+    mp_lcd_err_t lcd_seq_read_cmd(const uint8_t *seq, size_t seq_size, size_t *pos, uint32_t *lcd_cmd, size_t *param_size);
+    mp_lcd_err_t lcd_seq_check_cmds(const uint8_t *seq, size_t seq_size);
     mp_lcd_err_t lcd_panel_io_tx_color(mp_obj_t obj, int lcd_cmd, void *color, size_t color_size, int x_start, int y_start, int x_end, int y_end, uint8_t rotation, bool last_update);
     mp_obj_t lcd_panel_io_allocate_framebuffer(mp_obj_t obj, uint32_t size, uint32_t caps);
     mp_obj_t lcd_panel_io_free_framebuffer(mp_obj_t obj, mp_obj_t buf);
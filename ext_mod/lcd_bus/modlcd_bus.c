@@ -16,6 +16,7 @@
 #include "py/runtime.h"
 #include "py/objarray.h"
 #include "py/binary.h"
+#include "py/mphal.h"
 
 
 #ifdef ESP_IDF_VERSION
@@ -149,6 +150,119 @@ mp_obj_t mp_lcd_bus_tx_param(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
 MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_bus_tx_param_obj, 2, mp_lcd_bus_tx_param);
 
 
+static mp_lcd_err_t lcd_bus_play_seq(mp_obj_t obj, const uint8_t *seq, size_t len, bool nested)
+{
+    size_t pos = 0;
+    size_t run_start;
+    uint32_t cmd;
+    size_t param_size;
+    mp_lcd_err_t ret;
+
+    while (pos < len) {
+        // collect the run of commands up to the next delay or repeat so the
+        // bus is able to send them as a single batch
+        run_start = pos;
+        while (pos < len && lcd_seq_read_cmd(seq, len, &pos, &cmd, &param_size) == LCD_OK) {
+            pos += param_size;
+        }
+
+        if (pos != run_start) {
+            ret = lcd_panel_io_tx_params(obj, seq + run_start, pos - run_start);
+            if (ret != LCD_OK) return ret;
+        }
+
+        if (pos >= len) break;
+
+        switch (seq[pos]) {
+            case LCD_SEQ_END:
+                return LCD_OK;
+
+            case LCD_SEQ_DELAY:
+                if (pos + 3 > len) return LCD_ERR_INVALID_SIZE;
+                mp_hal_delay_ms((mp_uint_t)seq[pos + 1] | ((mp_uint_t)seq[pos + 2] << 8));
+                pos += 3;
+                break;
+
+            case LCD_SEQ_REPEAT: {
+                // repeats are not allowed to nest
+                if (nested || pos + 4 > len) return LCD_ERR_INVALID_ARG;
+                uint8_t count = seq[pos + 1];
+                size_t body_size = (size_t)seq[pos + 2] | ((size_t)seq[pos + 3] << 8);
+                pos += 4;
+                if (pos + body_size > len) return LCD_ERR_INVALID_SIZE;
+
+                for (uint8_t i = 0; i < count; i++) {
+                    ret = lcd_bus_play_seq(obj, seq + pos, body_size, true);
+                    if (ret != LCD_OK) return ret;
+                }
+                pos += body_size;
+                break;
+            }
+
+            default:
+                // either an unknown opcode or a truncated command record
+                return LCD_ERR_INVALID_ARG;
+        }
+    }
+
+    return LCD_OK;
+}
+
+
+mp_obj_t mp_lcd_bus_tx_params(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_seq };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,    MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_seq,     MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_seq].u_obj, &bufinfo, MP_BUFFER_READ);
+
+    mp_lcd_err_t ret = lcd_panel_io_tx_params(args[ARG_self].u_obj, (const uint8_t *)bufinfo.buf, (size_t)bufinfo.len);
+
+    if (ret == LCD_ERR_INVALID_ARG || ret == LCD_ERR_INVALID_SIZE) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("%d(lcd_panel_io_tx_params)"), ret);
+    } else if (ret != 0) {
+        mp_raise_msg_varg(&mp_type_OSError, MP_ERROR_TEXT("%d(lcd_panel_io_tx_params)"), ret);
+    }
+
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_bus_tx_params_obj, 2, mp_lcd_bus_tx_params);
+
+
+mp_obj_t mp_lcd_bus_tx_init_seq(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_seq };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,    MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_seq,     MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_seq].u_obj, &bufinfo, MP_BUFFER_READ);
+
+    mp_lcd_err_t ret = lcd_bus_play_seq(args[ARG_self].u_obj, (const uint8_t *)bufinfo.buf, (size_t)bufinfo.len, false);
+
+    if (ret == LCD_ERR_INVALID_ARG || ret == LCD_ERR_INVALID_SIZE) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("%d(lcd_panel_io_tx_init_seq)"), ret);
+    } else if (ret != 0) {
+        mp_raise_msg_varg(&mp_type_OSError, MP_ERROR_TEXT("%d(lcd_panel_io_tx_init_seq)"), ret);
+    }
+
+    return mp_const_none;
+}
+
+MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_bus_tx_init_seq_obj, 2, mp_lcd_bus_tx_init_seq);
+
+
 mp_obj_t mp_lcd_bus_tx_color(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
 {
     enum { ARG_self, ARG_cmd, ARG_data, ARG_x_start, ARG_y_start, ARG_x_end, ARG_y_end, ARG_rotation, ARG_last_update };
@@ -275,6 +389,8 @@ static const mp_rom_map_elem_t mp_lcd_bus_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_free_framebuffer),     MP_ROM_PTR(&mp_lcd_bus_free_framebuffer_obj)     },
     { MP_ROM_QSTR(MP_QSTR_register_callback),    MP_ROM_PTR(&mp_lcd_bus_register_callback_obj)    },
     { MP_ROM_QSTR(MP_QSTR_tx_param),             MP_ROM_PTR(&mp_lcd_bus_tx_param_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_tx_params),            MP_ROM_PTR(&mp_lcd_bus_tx_params_obj)            },
+    { MP_ROM_QSTR(MP_QSTR_tx_init_seq),          MP_ROM_PTR(&mp_lcd_bus_tx_init_seq_obj)          },
     { MP_ROM_QSTR(MP_QSTR_tx_color),             MP_ROM_PTR(&mp_lcd_bus_tx_color_obj)             },
     { MP_ROM_QSTR(MP_QSTR_rx_param),             MP_ROM_PTR(&mp_lcd_bus_rx_param_obj)             },
     { MP_ROM_QSTR(MP_QSTR_init),                 MP_ROM_PTR(&mp_lcd_bus_init_obj)                 },
@@ -13,6 +13,8 @@
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_init_obj;
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_get_lane_count_obj;
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_tx_param_obj;
+    extern const mp_obj_fun_builtin_var_t mp_lcd_bus_tx_params_obj;
+    extern const mp_obj_fun_builtin_var_t mp_lcd_bus_tx_init_seq_obj;
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_tx_color_obj;
     extern const mp_obj_fun_builtin_fixed_t mp_lcd_bus_deinit_obj;
     extern const mp_obj_fun_builtin_var_t mp_lcd_bus_rx_param_obj;
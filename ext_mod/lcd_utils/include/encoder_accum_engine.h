@@ -0,0 +1,61 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// The encoder accumulator has no MicroPython dependencies so it can be built
+// and tested on the host, see tests/test_encoder_accum.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __ENCODER_ACCUM_ENGINE_H__
+    #define __ENCODER_ACCUM_ENGINE_H__
+
+    #define ENCODER_CURVE_MAX_POINTS  (8)
+
+    // return values of encoder_accum_set_curve
+    #define ENCODER_CURVE_OK            (0)
+    #define ENCODER_CURVE_TOO_LONG      (1)  // more than ENCODER_CURVE_MAX_POINTS
+    #define ENCODER_CURVE_NOT_ASCENDING (2)
+
+    typedef struct _encoder_curve_point_t {
+        float rate;        // detents per second
+        float multiplier;
+    } encoder_curve_point_t;
+
+    /* The interrupt handler (or add/feed) is the only writer of count and
+     * read() is the only writer of consumed, so neither needs a lock. Both
+     * are in quarter steps (edges).
+     */
+    typedef struct _encoder_accum_t {
+        uint8_t last_ab;
+
+        volatile int32_t count;
+        int32_t consumed;
+        uint8_t steps_per_detent;
+
+        encoder_curve_point_t curve[ENCODER_CURVE_MAX_POINTS];
+        uint8_t curve_len;
+        float remainder;   // fraction the acceleration left over
+        uint32_t last_ms;  // ticks_ms of the last read
+    } encoder_accum_t;
+
+    // ab is the level of the pins at the start, (A << 1) | B
+    void encoder_accum_init(encoder_accum_t *enc, uint8_t steps_per_detent, uint8_t ab, uint32_t now_ms);
+
+    // a new level of the pins, (A << 1) | B
+    void encoder_accum_step(encoder_accum_t *enc, uint8_t ab);
+
+    // edges counted some other way
+    void encoder_accum_add(encoder_accum_t *enc, int32_t count);
+
+    // detents since the last read with the acceleration curve applied
+    int32_t encoder_accum_read(encoder_accum_t *enc, uint32_t now_ms);
+    void encoder_accum_reset(encoder_accum_t *enc, uint32_t now_ms);
+
+    // len 0 turns the acceleration off, the curve is left alone on an error
+    uint8_t encoder_accum_set_curve(encoder_accum_t *enc, const encoder_curve_point_t *points, size_t len);
+
+    // multiplier for a rate in detents per second, interpolated between the
+    // points of the curve
+    float encoder_accum_multiplier(const encoder_accum_t *enc, float rate);
+#endif /* __ENCODER_ACCUM_ENGINE_H__ */
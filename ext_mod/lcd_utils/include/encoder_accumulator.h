@@ -0,0 +1,21 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "encoder_accum_engine.h"
+
+#ifndef __ENCODER_ACCUMULATOR_H__
+    #define __ENCODER_ACCUMULATOR_H__
+
+    typedef struct _mp_encoder_accumulator_obj_t {
+        mp_obj_base_t base;
+
+        mp_obj_t a_value;  // bound pin.value methods, looked up once
+        mp_obj_t b_value;
+
+        encoder_accum_t enc;
+    } mp_encoder_accumulator_obj_t;
+
+    extern const mp_obj_type_t mp_encoder_accumulator_type;
+#endif /* __ENCODER_ACCUMULATOR_H__ */
@@ -0,0 +1,30 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "key_matrix_engine.h"
+
+#ifndef __KEY_MATRIX_H__
+    #define __KEY_MATRIX_H__
+
+    typedef struct _mp_key_matrix_obj_t {
+        mp_obj_base_t base;
+
+        // rows only get switched to output while they are scanned, in
+        // between they are inputs so two keys down in the same column can't
+        // short a driven row to another one
+        mp_obj_t row_init[KEY_MATRIX_MAX_ROWS];   // bound pin.init methods
+        mp_obj_t row_in[KEY_MATRIX_MAX_ROWS];     // the pin's IN mode
+        mp_obj_t row_out[KEY_MATRIX_MAX_ROWS];    // the pin's OUT mode
+        mp_obj_t col_value[KEY_MATRIX_MAX_COLS];  // unused when read is set
+        uint32_t col_bits[KEY_MATRIX_MAX_COLS];   // column masks for read
+        mp_obj_t read;    // returns all of the column levels as an int
+        bool active_low;
+        uint32_t settle_us;
+
+        key_matrix_t km;
+    } mp_key_matrix_obj_t;
+
+    extern const mp_obj_type_t mp_key_matrix_type;
+#endif /* __KEY_MATRIX_H__ */
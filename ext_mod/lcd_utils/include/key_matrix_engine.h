@@ -0,0 +1,58 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// The key matrix debouncing and queueing has no MicroPython dependencies so
+// it can be built and tested on the host, see tests/test_key_matrix.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __KEY_MATRIX_ENGINE_H__
+    #define __KEY_MATRIX_ENGINE_H__
+
+    #define KEY_MATRIX_MAX_ROWS   (16)
+    #define KEY_MATRIX_MAX_COLS   (32)
+    #define KEY_MATRIX_QUEUE_LEN  (32)  // needs to be a power of 2
+
+    // same values as lv.INDEV_STATE
+    #define KEY_MATRIX_RELEASED   (0)
+    #define KEY_MATRIX_PRESSED    (1)
+
+    typedef struct _key_matrix_event_t {
+        uint32_t code;
+        uint8_t state;
+    } key_matrix_event_t;
+
+    typedef struct _key_matrix_t {
+        uint8_t rows;
+        uint8_t cols;
+        uint32_t *codes;  // rows * cols key codes
+        bool ghost;       // matrix has no diodes, look for ghosted keys
+
+        uint32_t raw[KEY_MATRIX_MAX_ROWS];     // last scan, bit n is column n
+        uint32_t stable[KEY_MATRIX_MAX_ROWS];  // debounced
+        uint32_t changed_ms[KEY_MATRIX_MAX_ROWS];
+        uint32_t debounce_ms;
+
+        int16_t repeat_key;  // row * cols + col of the key repeating, -1 none
+        uint32_t repeat_ms;  // ticks_ms of the next repeat
+        uint32_t repeat_delay;
+        uint32_t repeat_period;
+
+        key_matrix_event_t queue[KEY_MATRIX_QUEUE_LEN];
+        uint16_t head;
+        uint16_t tail;
+    } key_matrix_t;
+
+    // Takes the keys of a whole scan, one word per row with bit n set for a
+    // key down in column n. The keys that have changed and been stable for
+    // the debounce time get queued.
+    void key_matrix_update(key_matrix_t *km, const uint32_t *keys, uint32_t now_ms);
+
+    // takes the oldest event off of the queue, false if it is empty
+    bool key_matrix_pop(key_matrix_t *km, key_matrix_event_t *event);
+    uint16_t key_matrix_queued(const key_matrix_t *km);
+
+    // empties the queue and stops any repeat
+    void key_matrix_clear(key_matrix_t *km);
+#endif /* __KEY_MATRIX_ENGINE_H__ */
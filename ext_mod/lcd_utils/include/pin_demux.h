@@ -0,0 +1,35 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#ifndef __PIN_DEMUX_H__
+    #define __PIN_DEMUX_H__
+
+    #define PIN_DEMUX_MAX_PINS     (32)
+
+    // same values as io_expander_framework.Pin.IRQ_*
+    #define PIN_DEMUX_IRQ_RISING   (0x01)
+    #define PIN_DEMUX_IRQ_FALLING  (0x02)
+
+    typedef struct _pin_demux_entry_t {
+        mp_obj_t handler;
+        mp_obj_t pin;         // passed to the handler
+        uint8_t trigger;
+        uint32_t last_ms;     // ticks_ms of the last change that was accepted
+    } pin_demux_entry_t;
+
+    typedef struct _mp_pin_demux_obj_t {
+        mp_obj_base_t base;
+
+        mp_obj_t read;        // returns the input register(s) as an int
+        uint32_t debounce_ms;
+        uint32_t states;      // last accepted level of each pin
+        uint32_t mask;        // pins that have a handler
+        uint32_t pending;     // pins that changed inside of the debounce time
+
+        pin_demux_entry_t entries[PIN_DEMUX_MAX_PINS];
+    } mp_pin_demux_obj_t;
+
+    extern const mp_obj_type_t mp_pin_demux_type;
+#endif /* __PIN_DEMUX_H__ */
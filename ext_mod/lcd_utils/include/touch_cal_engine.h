@@ -0,0 +1,43 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// The calibration solver has no MicroPython dependencies so it can be built
+// and tested on the host, see tests/test_touch_cal.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __TOUCH_CAL_ENGINE_H__
+    #define __TOUCH_CAL_ENGINE_H__
+
+    #define TOUCH_CAL_MAX_POINTS  (32)
+
+    // return values of touch_cal_solve
+    #define TOUCH_CAL_OK         (0)
+    #define TOUCH_CAL_TOO_FEW    (1)  // less than 3 points
+    #define TOUCH_CAL_COLLINEAR  (2)  // the points are on a line
+
+    typedef struct _touch_cal_fit_t {
+        double alpha_x;
+        double beta_x;
+        double delta_x;
+        double alpha_y;
+        double beta_y;
+        double delta_y;
+    } touch_cal_fit_t;
+
+    /* Least squares fit of
+     *     screen_x = alpha_x * raw_x + beta_x * raw_y + delta_x
+     *     screen_y = alpha_y * raw_x + beta_y * raw_y + delta_y
+     *
+     * If reject is more than 0, points that don't agree with the rest get
+     * dropped one at a time, see touch_cal_engine.c. used gets a flag for
+     * every point that is in the final fit and rms gets the RMS error of
+     * those points in pixels.
+     */
+    uint8_t touch_cal_solve(const double *raw_x, const double *raw_y, const double *scr_x, const double *scr_y,
+                            size_t n, double reject, bool *used, touch_cal_fit_t *fit, double *rms);
+
+    // distance in pixels between where the fit puts a raw point and scr
+    double touch_cal_residual(const touch_cal_fit_t *fit, double raw_x, double raw_y, double scr_x, double scr_y);
+#endif /* __TOUCH_CAL_ENGINE_H__ */
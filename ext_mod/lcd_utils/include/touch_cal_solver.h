@@ -0,0 +1,12 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "touch_cal_engine.h"
+
+#ifndef __TOUCH_CAL_SOLVER_H__
+    #define __TOUCH_CAL_SOLVER_H__
+
+    extern const mp_obj_fun_builtin_var_t mp_lcd_utils_solve_touch_cal_obj;
+#endif /* __TOUCH_CAL_SOLVER_H__ */
@@ -0,0 +1,20 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "touch_filter_engine.h"
+
+#ifndef __TOUCH_FILTER_H__
+    #define __TOUCH_FILTER_H__
+
+    typedef struct _mp_touch_filter_obj_t {
+        mp_obj_base_t base;
+
+        uint16_t threshold;
+        uint8_t format;
+        touch_filter_t filter;
+    } mp_touch_filter_obj_t;
+
+    extern const mp_obj_type_t mp_touch_filter_type;
+#endif /* __TOUCH_FILTER_H__ */
@@ -0,0 +1,41 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// The filter engine has no MicroPython dependencies so it can be built and
+// tested on the host, see tests/test_touch_filter.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __TOUCH_FILTER_ENGINE_H__
+    #define __TOUCH_FILTER_ENGINE_H__
+
+    #define TOUCH_FILTER_MAX_SAMPLES  (32)
+
+    // layouts of the sample buffers that get passed to TouchFilter.process
+    #define TOUCH_FILTER_FORMAT_XY16      (0)  // uint16 x, uint16 y (native byte order)
+    #define TOUCH_FILTER_FORMAT_XPT2046   (1)  // 3 byte SPI frames, x frame then y frame
+    #define TOUCH_FILTER_FORMAT_STMPE610  (2)  // 4 byte FIFO packets, 12 bit x, 12 bit y, 8 bit z
+
+    typedef struct _touch_filter_t {
+        uint16_t min_raw;
+        uint16_t max_raw;
+        uint8_t trim;           // samples dropped from each end of the sorted axis
+        uint8_t smoothing;      // IIR weight of the previous point, 0 - 255 (/256)
+        uint32_t margin_sq;     // maximum mean squared deviation
+
+        bool has_last;
+        int32_t last_x;         // Q4 fixed point
+        int32_t last_y;         // Q4 fixed point
+    } touch_filter_t;
+
+    // Unpacks up to TOUCH_FILTER_MAX_SAMPLES samples from a buffer in one of
+    // the TOUCH_FILTER_FORMAT_* layouts. Returns the number of samples.
+    size_t touch_filter_decode(uint8_t format, const uint8_t *buf, size_t len, uint16_t *xs, uint16_t *ys);
+
+    // Filters n raw (x, y) samples into a single point. The arrays get sorted
+    // in place. Returns false if there are not enough valid samples or if the
+    // samples are spread out too far.
+    bool touch_filter_run(touch_filter_t *filter, uint16_t *xs, uint16_t *ys, size_t n, uint16_t *x_out, uint16_t *y_out);
+    void touch_filter_reset(touch_filter_t *filter);
+#endif /* __TOUCH_FILTER_ENGINE_H__ */
@@ -0,0 +1,43 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#ifndef __TOUCH_RING_H__
+    #define __TOUCH_RING_H__
+
+    #define TOUCH_RING_DEFAULT_SIZE  (16)
+    #define TOUCH_RING_MAX_SIZE      (256)
+
+    typedef struct _touch_event_t {
+        uint32_t ticks;  // ticks_us of the interrupt edge that caused the read
+        int16_t x;
+        int16_t y;
+        uint8_t state;
+    } touch_event_t;
+
+    /* Both rings are single producer/single consumer so neither needs a lock.
+     * The interrupt handler is the only writer of edge_head and put() is the
+     * only writer of head. edge() and get() are the only writers of the tails.
+     * The indexes run free and get masked when used.
+     */
+    typedef struct _mp_touch_ring_obj_t {
+        mp_obj_base_t base;
+
+        mp_obj_t callback;  // scheduled from the interrupt handler
+        uint16_t mask;
+
+        touch_event_t *events;
+        volatile uint16_t head;
+        volatile uint16_t tail;
+
+        uint32_t *edges;
+        volatile uint16_t edge_head;
+        volatile uint16_t edge_tail;
+
+        volatile bool scheduled;
+        uint32_t dropped;
+    } mp_touch_ring_obj_t;
+
+    extern const mp_obj_type_t mp_touch_ring_type;
+#endif /* __TOUCH_RING_H__ */
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "touch_transform.h"
+
+#ifndef __TOUCH_TRACKER_H__
+    #define __TOUCH_TRACKER_H__
+
+    #define TOUCH_TRACKER_MAX_CONTACTS  (10)
+
+    // layouts of the point buffers that get passed to TouchTracker.update
+    #define TOUCH_TRACKER_FORMAT_IXY16  (0)  // int16 id, int16 x, int16 y (native byte order), id -1 = unknown
+    #define TOUCH_TRACKER_FORMAT_GT911  (1)  // 8 byte point records starting at the track id
+
+    #define TOUCH_GESTURE_NONE    (0)
+    #define TOUCH_GESTURE_PINCH   (1)
+    #define TOUCH_GESTURE_ROTATE  (2)
+    #define TOUCH_GESTURE_SWIPE   (3)  // two finger swipe
+
+    typedef struct _touch_contact_t {
+        int16_t id;
+        int16_t x;
+        int16_t y;
+        bool active;
+        bool seen;
+        uint32_t order;  // when the contact went down, the lowest active one is the primary
+    } touch_contact_t;
+
+    typedef struct _mp_touch_tracker_obj_t {
+        mp_obj_base_t base;
+
+        uint8_t max_contacts;
+        uint8_t format;
+        mp_touch_transform_obj_t *transform;
+
+        touch_contact_t contacts[TOUCH_TRACKER_MAX_CONTACTS];
+        uint32_t order;
+        int16_t next_id;
+
+        // two finger gesture, measured in screen coordinates if there is a transform
+        int16_t gesture_ids[2];
+        uint8_t gesture;
+        float start_distance;
+        float start_angle;
+        float start_mid_x;
+        float start_mid_y;
+        float scale;
+        float rotation;
+        float pan_x;
+        float pan_y;
+
+        float pinch_threshold;   // fraction of the starting distance
+        float rotate_threshold;  // degrees
+        float swipe_threshold;   // pixels
+    } mp_touch_tracker_obj_t;
+
+    extern const mp_obj_type_t mp_touch_tracker_type;
+#endif /* __TOUCH_TRACKER_H__ */
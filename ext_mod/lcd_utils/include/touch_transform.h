@@ -0,0 +1,33 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#ifndef __TOUCH_TRANSFORM_H__
+    #define __TOUCH_TRANSFORM_H__
+
+    typedef struct _mp_touch_transform_obj_t {
+        mp_obj_base_t base;
+
+        int32_t width;
+        int32_t height;
+        uint8_t rotation;  // lv.DISPLAY_ROTATION the display started with
+
+        bool calibrated;
+        bool mirror_x;
+        bool mirror_y;
+
+        // affine calibration coefficients in Q16 fixed point
+        int64_t alpha_x;
+        int64_t beta_x;
+        int64_t delta_x;
+        int64_t alpha_y;
+        int64_t beta_y;
+        int64_t delta_y;
+    } mp_touch_transform_obj_t;
+
+    // maps a raw point to screen coordinates in place
+    void touch_transform_map(mp_touch_transform_obj_t *self, int32_t *x, int32_t *y);
+
+    extern const mp_obj_type_t mp_touch_transform_type;
+#endif /* __TOUCH_TRANSFORM_H__ */
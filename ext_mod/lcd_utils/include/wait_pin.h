@@ -0,0 +1,19 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include "wait_pin_engine.h"
+
+#ifndef __WAIT_PIN_H__
+    #define __WAIT_PIN_H__
+
+    typedef struct _mp_wait_pin_obj_t {
+        mp_obj_base_t base;
+
+        mp_obj_t value;  // bound pin.value method
+        uint8_t state;   // level of the pin when the controller is ready
+    } mp_wait_pin_obj_t;
+
+    extern const mp_obj_type_t mp_wait_pin_type;
+#endif /* __WAIT_PIN_H__ */
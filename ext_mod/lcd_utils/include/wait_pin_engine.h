@@ -0,0 +1,25 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// The wait loop has no MicroPython dependencies so it can be built and
+// tested on the host, see tests/test_wait_pin.c
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __WAIT_PIN_ENGINE_H__
+    #define __WAIT_PIN_ENGINE_H__
+
+    typedef struct _wait_pin_io_t {
+        bool (*is_ready)(void *arg);
+        uint32_t (*ticks_ms)(void);
+        // sleeps up to ms milliseconds, an interrupt can end it early
+        void (*sleep_ms)(uint32_t ms);
+        void *arg;              // passed to is_ready
+    } wait_pin_io_t;
+
+    // Checks is_ready until it returns true or timeout milliseconds have
+    // gone by, a negative timeout waits forever. Returns false if it timed
+    // out.
+    bool wait_pin_run(const wait_pin_io_t *io, int32_t timeout);
+#endif /* __WAIT_PIN_ENGINE_H__ */
@@ -10,6 +10,20 @@ set(LCD_UTILS_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/src/lcd_utils.c
     ${CMAKE_CURRENT_LIST_DIR}/src/remap.c
     ${CMAKE_CURRENT_LIST_DIR}/src/binary_float.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/touch_filter.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/touch_filter_engine.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/touch_transform.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/touch_cal_solver.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/touch_cal_engine.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/touch_tracker.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/touch_ring.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/pin_demux.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/encoder_accumulator.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/encoder_accum_engine.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/key_matrix.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/key_matrix_engine.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/wait_pin.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/wait_pin_engine.c
 )
 
 # Add our source files to the lib
@@ -12,3 +12,17 @@ endif
 SRC_USERMOD_C += $(MOD_DIR)/src/lcd_utils.c
 SRC_USERMOD_C += $(MOD_DIR)/src/remap.c
 SRC_USERMOD_C += $(MOD_DIR)/src/binary_float.c
+SRC_USERMOD_C += $(MOD_DIR)/src/touch_filter.c
+SRC_USERMOD_C += $(MOD_DIR)/src/touch_filter_engine.c
+SRC_USERMOD_C += $(MOD_DIR)/src/touch_transform.c
+SRC_USERMOD_C += $(MOD_DIR)/src/touch_cal_solver.c
+SRC_USERMOD_C += $(MOD_DIR)/src/touch_cal_engine.c
+SRC_USERMOD_C += $(MOD_DIR)/src/touch_tracker.c
+SRC_USERMOD_C += $(MOD_DIR)/src/touch_ring.c
+SRC_USERMOD_C += $(MOD_DIR)/src/pin_demux.c
+SRC_USERMOD_C += $(MOD_DIR)/src/encoder_accumulator.c
+SRC_USERMOD_C += $(MOD_DIR)/src/encoder_accum_engine.c
+SRC_USERMOD_C += $(MOD_DIR)/src/key_matrix.c
+SRC_USERMOD_C += $(MOD_DIR)/src/key_matrix_engine.c
+SRC_USERMOD_C += $(MOD_DIR)/src/wait_pin.c
+SRC_USERMOD_C += $(MOD_DIR)/src/wait_pin_engine.c
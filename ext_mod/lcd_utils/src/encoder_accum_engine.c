@@ -0,0 +1,120 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/encoder_accum_engine.h"
+
+
+// direction of a quadrature transition, index is (previous AB << 2) | AB.
+// 0 is no movement or an invalid (skipped) transition
+static const int8_t encoder_transitions[16] = {
+    0, -1,  1,  0,
+    1,  0,  0, -1,
+   -1,  0,  0,  1,
+    0,  1, -1,  0
+};
+
+
+void encoder_accum_init(encoder_accum_t *enc, uint8_t steps_per_detent, uint8_t ab, uint32_t now_ms)
+{
+    enc->last_ab = ab & 0x03;
+    enc->count = 0;
+    enc->consumed = 0;
+    enc->steps_per_detent = steps_per_detent;
+    enc->curve_len = 0;
+    enc->remainder = 0.0f;
+    enc->last_ms = now_ms;
+}
+
+
+void encoder_accum_step(encoder_accum_t *enc, uint8_t ab)
+{
+    enc->count += encoder_transitions[(enc->last_ab << 2) | ab];
+    enc->last_ab = ab;
+}
+
+
+void encoder_accum_add(encoder_accum_t *enc, int32_t count)
+{
+    enc->count += count;
+}
+
+
+float encoder_accum_multiplier(const encoder_accum_t *enc, float rate)
+{
+    if (enc->curve_len == 0) return 1.0f;
+
+    const encoder_curve_point_t *curve = enc->curve;
+
+    if (rate <= curve[0].rate) return curve[0].multiplier;
+
+    for (uint8_t i = 1; i < enc->curve_len; i++) {
+        if (rate < curve[i].rate) {
+            float t = (rate - curve[i - 1].rate) / (curve[i].rate - curve[i - 1].rate);
+            return curve[i - 1].multiplier + t * (curve[i].multiplier - curve[i - 1].multiplier);
+        }
+    }
+
+    return curve[enc->curve_len - 1].multiplier;
+}
+
+
+uint8_t encoder_accum_set_curve(encoder_accum_t *enc, const encoder_curve_point_t *points, size_t len)
+{
+    if (len > ENCODER_CURVE_MAX_POINTS) return ENCODER_CURVE_TOO_LONG;
+
+    for (size_t i = 1; i < len; i++) {
+        if (points[i].rate <= points[i - 1].rate) return ENCODER_CURVE_NOT_ASCENDING;
+    }
+
+    for (size_t i = 0; i < len; i++) enc->curve[i] = points[i];
+
+    enc->curve_len = (uint8_t)len;
+    enc->remainder = 0.0f;
+
+    return ENCODER_CURVE_OK;
+}
+
+
+/* Edges that don't make up a whole detent stay for the next read so nothing
+ * gets lost. The rate the curve gets looked up with is the number of detents
+ * over the time since the last read.
+ */
+int32_t encoder_accum_read(encoder_accum_t *enc, uint32_t now_ms)
+{
+    uint32_t elapsed = now_ms - enc->last_ms;
+    enc->last_ms = now_ms;
+
+    int32_t delta = enc->count - enc->consumed;
+    int32_t detents = delta / (int32_t)enc->steps_per_detent;
+
+    if (detents == 0) return 0;
+
+    enc->consumed += detents * (int32_t)enc->steps_per_detent;
+
+    if (enc->curve_len == 0) return detents;
+
+    if (elapsed == 0) elapsed = 1;
+
+    float magnitude = (float)(detents < 0 ? -detents : detents);
+    float rate = magnitude * 1000.0f / (float)elapsed;
+
+    // a change in direction drops what was left over
+    if ((detents < 0) != (enc->remainder < 0.0f)) enc->remainder = 0.0f;
+
+    float value = (float)detents * encoder_accum_multiplier(enc, rate) + enc->remainder;
+    int32_t diff = (int32_t)value;
+
+    // a detent always moves at least one step
+    if (diff == 0) diff = detents < 0 ? -1 : 1;
+
+    enc->remainder = value - (float)diff;
+
+    return diff;
+}
+
+
+void encoder_accum_reset(encoder_accum_t *enc, uint32_t now_ms)
+{
+    enc->consumed = enc->count;
+    enc->remainder = 0.0f;
+    enc->last_ms = now_ms;
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/encoder_accumulator.h"
+
+#include "mphalport.h"
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+static inline uint8_t encoder_read_pins(mp_encoder_accumulator_obj_t *self)
+{
+    return (uint8_t)((mp_obj_is_true(mp_call_function_0(self->a_value)) << 1) |
+                     mp_obj_is_true(mp_call_function_0(self->b_value)));
+}
+
+
+static void encoder_set_curve(mp_encoder_accumulator_obj_t *self, mp_obj_t curve_in)
+{
+    if (curve_in == mp_const_none) {
+        encoder_accum_set_curve(&self->enc, NULL, 0);
+        return;
+    }
+
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_get_array(curve_in, &len, &items);
+
+    if (len > ENCODER_CURVE_MAX_POINTS) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("a maximum of %d curve points is supported"), ENCODER_CURVE_MAX_POINTS);
+    }
+
+    encoder_curve_point_t points[ENCODER_CURVE_MAX_POINTS];
+
+    for (size_t i = 0; i < len; i++) {
+        mp_obj_t *point;
+        mp_obj_get_array_fixed_n(items[i], 2, &point);
+
+        points[i].rate = mp_obj_get_float_to_f(point[0]);
+        points[i].multiplier = mp_obj_get_float_to_f(point[1]);
+    }
+
+    if (encoder_accum_set_curve(&self->enc, points, len) != ENCODER_CURVE_OK) {
+        mp_raise_ValueError(MP_ERROR_TEXT("curve rates must be ascending"));
+    }
+}
+
+
+static mp_obj_t mp_encoder_accumulator_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_pin_a,
+        ARG_pin_b,
+        ARG_steps_per_detent,
+        ARG_curve
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_pin_a,            MP_ARG_OBJ,                  { .u_obj = mp_const_none } },
+        { MP_QSTR_pin_b,            MP_ARG_OBJ,                  { .u_obj = mp_const_none } },
+        { MP_QSTR_steps_per_detent, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 4             } },
+        { MP_QSTR_curve,            MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    if (args[ARG_steps_per_detent].u_int < 1 || args[ARG_steps_per_detent].u_int > 255) {
+        mp_raise_ValueError(MP_ERROR_TEXT("steps_per_detent must be 1 - 255"));
+    }
+
+    if ((args[ARG_pin_a].u_obj == mp_const_none) != (args[ARG_pin_b].u_obj == mp_const_none)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("pin_a and pin_b must both be given"));
+    }
+
+    mp_encoder_accumulator_obj_t *self = m_new_obj(mp_encoder_accumulator_obj_t);
+    self->base.type = &mp_encoder_accumulator_type;
+
+    self->a_value = mp_const_none;
+    self->b_value = mp_const_none;
+
+    uint8_t ab = 0;
+
+    if (args[ARG_pin_a].u_obj != mp_const_none) {
+        // the bound methods get made here so the interrupt handler
+        // doesn't allocate
+        self->a_value = mp_load_attr(args[ARG_pin_a].u_obj, MP_QSTR_value);
+        self->b_value = mp_load_attr(args[ARG_pin_b].u_obj, MP_QSTR_value);
+
+        ab = encoder_read_pins(self);
+    }
+
+    encoder_accum_init(&self->enc, (uint8_t)args[ARG_steps_per_detent].u_int, ab, mp_hal_ticks_ms());
+    encoder_set_curve(self, args[ARG_curve].u_obj);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+// pin interrupt handler for both pins, safe to use as a hard IRQ
+static mp_obj_t mp_encoder_accumulator_irq(mp_obj_t self_in, mp_obj_t pin_in)
+{
+    (void)pin_in;
+    mp_encoder_accumulator_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->a_value == mp_const_none) return mp_const_none;
+
+    encoder_accum_step(&self->enc, encoder_read_pins(self));
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_encoder_accumulator_irq_obj, mp_encoder_accumulator_irq);
+
+
+// feed(a, b) for pins that are read some other way, an IO expander for one
+static mp_obj_t mp_encoder_accumulator_feed(mp_obj_t self_in, mp_obj_t a_in, mp_obj_t b_in)
+{
+    mp_encoder_accumulator_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    encoder_accum_step(&self->enc, (uint8_t)((mp_obj_is_true(a_in) << 1) | mp_obj_is_true(b_in)));
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_3(mp_encoder_accumulator_feed_obj, mp_encoder_accumulator_feed);
+
+
+// add(count) for hardware counters (PCNT), count is in edges
+static mp_obj_t mp_encoder_accumulator_add(mp_obj_t self_in, mp_obj_t count_in)
+{
+    mp_encoder_accumulator_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    encoder_accum_add(&self->enc, (int32_t)mp_obj_get_int(count_in));
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_encoder_accumulator_add_obj, mp_encoder_accumulator_add);
+
+
+/* read()
+ * Returns the number of detents since the last read with the acceleration
+ * curve applied. Edges that don't make up a whole detent stay for the next
+ * read so nothing gets lost.
+ */
+static mp_obj_t mp_encoder_accumulator_read(mp_obj_t self_in)
+{
+    mp_encoder_accumulator_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    return mp_obj_new_int(encoder_accum_read(&self->enc, mp_hal_ticks_ms()));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_encoder_accumulator_read_obj, mp_encoder_accumulator_read);
+
+
+// set_curve([(detents_per_second, multiplier), ...]) or None for no
+// acceleration. Rates in between the points are interpolated.
+static mp_obj_t mp_encoder_accumulator_set_curve(mp_obj_t self_in, mp_obj_t curve_in)
+{
+    mp_encoder_accumulator_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    encoder_set_curve(self, curve_in);
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_encoder_accumulator_set_curve_obj, mp_encoder_accumulator_set_curve);
+
+
+static mp_obj_t mp_encoder_accumulator_reset(mp_obj_t self_in)
+{
+    mp_encoder_accumulator_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    encoder_accum_reset(&self->enc, mp_hal_ticks_ms());
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_encoder_accumulator_reset_obj, mp_encoder_accumulator_reset);
+
+
+static const mp_rom_map_elem_t mp_encoder_accumulator_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_irq),       MP_ROM_PTR(&mp_encoder_accumulator_irq_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_feed),      MP_ROM_PTR(&mp_encoder_accumulator_feed_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_add),       MP_ROM_PTR(&mp_encoder_accumulator_add_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_read),      MP_ROM_PTR(&mp_encoder_accumulator_read_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_set_curve), MP_ROM_PTR(&mp_encoder_accumulator_set_curve_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset),     MP_ROM_PTR(&mp_encoder_accumulator_reset_obj)     },
+};
+
+static MP_DEFINE_CONST_DICT(mp_encoder_accumulator_locals_dict, mp_encoder_accumulator_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_encoder_accumulator_type,
+    MP_QSTR_EncoderAccumulator,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_encoder_accumulator_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_encoder_accumulator_locals_dict
+);
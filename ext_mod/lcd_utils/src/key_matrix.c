@@ -0,0 +1,303 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/key_matrix.h"
+
+#include "mphalport.h"
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+static uint32_t key_matrix_read_row(mp_key_matrix_obj_t *self)
+{
+    uint32_t levels = 0;
+
+    if (self->read != mp_const_none) {
+        // everything is read in one go, this is an io expander's input
+        // register(s)
+        uint32_t states = (uint32_t)mp_obj_get_int_truncated(mp_call_function_0(self->read));
+
+        for (uint8_t c = 0; c < self->km.cols; c++) {
+            if (states & self->col_bits[c]) levels |= 1UL << c;
+        }
+    } else {
+        for (uint8_t c = 0; c < self->km.cols; c++) {
+            if (mp_obj_is_true(mp_call_function_0(self->col_value[c]))) levels |= 1UL << c;
+        }
+    }
+
+    uint32_t mask = self->km.cols == 32 ? 0xFFFFFFFFUL : (1UL << self->km.cols) - 1;
+
+    return self->active_low ? ~levels & mask : levels;
+}
+
+
+/* The row being scanned is an output at the active level, every other row is
+ * an input and floats. If the idle rows were driven to the inactive level two
+ * keys held in the same column would connect a row driven low to a row driven
+ * high.
+ */
+static void key_matrix_drive_row(mp_key_matrix_obj_t *self, uint8_t row, bool drive)
+{
+    if (drive) {
+        mp_obj_t args[3] = {
+            self->row_out[row],
+            MP_OBJ_NEW_QSTR(MP_QSTR_value),
+            MP_OBJ_NEW_SMALL_INT(self->active_low ? 0 : 1)
+        };
+
+        mp_call_function_n_kw(self->row_init[row], 1, 1, args);
+    } else {
+        mp_call_function_1(self->row_init[row], self->row_in[row]);
+    }
+}
+
+
+static void key_matrix_scan(mp_key_matrix_obj_t *self)
+{
+    uint32_t now = mp_hal_ticks_ms();
+    uint32_t keys[KEY_MATRIX_MAX_ROWS];
+
+    for (uint8_t r = 0; r < self->km.rows; r++) {
+        key_matrix_drive_row(self, r, true);
+        if (self->settle_us) mp_hal_delay_us(self->settle_us);
+
+        keys[r] = key_matrix_read_row(self);
+
+        key_matrix_drive_row(self, r, false);
+    }
+
+    key_matrix_update(&self->km, keys, now);
+}
+
+
+static mp_obj_t mp_key_matrix_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_rows,
+        ARG_cols,
+        ARG_keymap,
+        ARG_read,
+        ARG_debounce,
+        ARG_repeat_delay,
+        ARG_repeat_period,
+        ARG_diodes,
+        ARG_active_low,
+        ARG_settle
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_rows,          MP_ARG_OBJ | MP_ARG_REQUIRED                         },
+        { MP_QSTR_cols,          MP_ARG_OBJ | MP_ARG_REQUIRED                         },
+        { MP_QSTR_keymap,        MP_ARG_OBJ,                  { .u_obj = mp_const_none } },
+        { MP_QSTR_read,          MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none } },
+        { MP_QSTR_debounce,      MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 20            } },
+        { MP_QSTR_repeat_delay,  MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0             } },
+        { MP_QSTR_repeat_period, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 100           } },
+        { MP_QSTR_diodes,        MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false       } },
+        { MP_QSTR_active_low,    MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = true        } },
+        { MP_QSTR_settle,        MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0             } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    size_t rows_len;
+    mp_obj_t *rows;
+    mp_obj_get_array(args[ARG_rows].u_obj, &rows_len, &rows);
+
+    size_t cols_len;
+    mp_obj_t *cols;
+    mp_obj_get_array(args[ARG_cols].u_obj, &cols_len, &cols);
+
+    if (rows_len == 0 || rows_len > KEY_MATRIX_MAX_ROWS) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("1 to %d rows are supported"), KEY_MATRIX_MAX_ROWS);
+    }
+
+    if (cols_len == 0 || cols_len > KEY_MATRIX_MAX_COLS) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("1 to %d columns are supported"), KEY_MATRIX_MAX_COLS);
+    }
+
+    mp_obj_t read = args[ARG_read].u_obj;
+
+    if (read != mp_const_none && !mp_obj_is_callable(read)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("read must be callable"));
+    }
+
+    size_t key_count = rows_len * cols_len;
+    size_t keymap_len = 0;
+    mp_obj_t *keymap = NULL;
+
+    if (args[ARG_keymap].u_obj != mp_const_none) {
+        mp_obj_get_array(args[ARG_keymap].u_obj, &keymap_len, &keymap);
+
+        if (keymap_len != key_count) {
+            mp_raise_ValueError(MP_ERROR_TEXT("keymap needs a code for every key"));
+        }
+    }
+
+    mp_key_matrix_obj_t *self = m_new0(mp_key_matrix_obj_t, 1);
+    self->base.type = &mp_key_matrix_type;
+
+    self->km.rows = (uint8_t)rows_len;
+    self->km.cols = (uint8_t)cols_len;
+    self->read = read;
+
+    // the bound methods get made here so a scan doesn't allocate them. The
+    // modes come from the pins because machine.Pin and the io expander pins
+    // don't use the same values
+    for (uint8_t r = 0; r < self->km.rows; r++) {
+        self->row_init[r] = mp_load_attr(rows[r], MP_QSTR_init);
+        self->row_in[r] = mp_load_attr(rows[r], MP_QSTR_IN);
+        self->row_out[r] = mp_load_attr(rows[r], MP_QSTR_OUT);
+    }
+
+    for (uint8_t c = 0; c < self->km.cols; c++) {
+        // with read the columns are the masks of the columns in the value
+        // read returns
+        if (read != mp_const_none) {
+            self->col_bits[c] = (uint32_t)mp_obj_get_int_truncated(cols[c]);
+            self->col_value[c] = mp_const_none;
+        } else {
+            self->col_value[c] = mp_load_attr(cols[c], MP_QSTR_value);
+        }
+    }
+
+    self->km.codes = m_new(uint32_t, key_count);
+
+    for (size_t i = 0; i < key_count; i++) {
+        if (keymap == NULL) {
+            self->km.codes[i] = (uint32_t)i;
+        } else if (mp_obj_is_str(keymap[i])) {
+            size_t len;
+            const char *str = mp_obj_str_get_data(keymap[i], &len);
+            self->km.codes[i] = len ? (uint8_t)str[0] : 0;
+        } else {
+            self->km.codes[i] = (uint32_t)mp_obj_get_int_truncated(keymap[i]);
+        }
+    }
+
+    self->active_low = args[ARG_active_low].u_bool;
+    self->km.ghost = !args[ARG_diodes].u_bool;
+    self->settle_us = args[ARG_settle].u_int < 0 ? 0 : (uint32_t)args[ARG_settle].u_int;
+    self->km.debounce_ms = args[ARG_debounce].u_int < 0 ? 0 : (uint32_t)args[ARG_debounce].u_int;
+    self->km.repeat_delay = args[ARG_repeat_delay].u_int < 0 ? 0 : (uint32_t)args[ARG_repeat_delay].u_int;
+    self->km.repeat_period = args[ARG_repeat_period].u_int < 1 ? 1 : (uint32_t)args[ARG_repeat_period].u_int;
+    self->km.repeat_key = -1;
+
+    // rows start out floating
+    for (uint8_t r = 0; r < self->km.rows; r++) key_matrix_drive_row(self, r, false);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+/* scan()
+ * Scans the whole matrix once. Rows are driven one at a time and the keys
+ * that have changed and been stable for the debounce time get queued.
+ * Returns the number of events waiting in the queue.
+ */
+static mp_obj_t mp_key_matrix_scan(mp_obj_t self_in)
+{
+    mp_key_matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    key_matrix_scan(self);
+
+    return mp_obj_new_int(key_matrix_queued(&self->km));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_key_matrix_scan_obj, mp_key_matrix_scan);
+
+
+/* read()
+ * Returns the oldest (state, code) event or None. The matrix only gets
+ * scanned when the queue is empty, this is what the keypad read callback
+ * calls.
+ */
+static mp_obj_t mp_key_matrix_read(mp_obj_t self_in)
+{
+    mp_key_matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (key_matrix_queued(&self->km) == 0) key_matrix_scan(self);
+
+    key_matrix_event_t event;
+
+    if (!key_matrix_pop(&self->km, &event)) return mp_const_none;
+
+    mp_obj_t tuple[2] = {
+        MP_OBJ_NEW_SMALL_INT(event.state),
+        mp_obj_new_int_from_uint(event.code)
+    };
+
+    return mp_obj_new_tuple(2, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_key_matrix_read_obj, mp_key_matrix_read);
+
+
+static mp_obj_t mp_key_matrix_pending(mp_obj_t self_in)
+{
+    mp_key_matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int(key_matrix_queued(&self->km));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_key_matrix_pending_obj, mp_key_matrix_pending);
+
+
+// pressed() returns the codes of the keys that are down after debouncing
+static mp_obj_t mp_key_matrix_pressed(mp_obj_t self_in)
+{
+    mp_key_matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+
+    for (uint8_t r = 0; r < self->km.rows; r++) {
+        uint32_t bits = self->km.stable[r];
+
+        while (bits) {
+            uint8_t c = (uint8_t)__builtin_ctz(bits);
+            bits &= bits - 1;
+
+            mp_obj_list_append(list, mp_obj_new_int_from_uint(self->km.codes[r * self->km.cols + c]));
+        }
+    }
+
+    return list;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_key_matrix_pressed_obj, mp_key_matrix_pressed);
+
+
+// clear() empties the queue and stops any repeat. Keys that are held down
+// don't get pressed again.
+static mp_obj_t mp_key_matrix_clear(mp_obj_t self_in)
+{
+    mp_key_matrix_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    key_matrix_clear(&self->km);
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_key_matrix_clear_obj, mp_key_matrix_clear);
+
+
+static const mp_rom_map_elem_t mp_key_matrix_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_scan),     MP_ROM_PTR(&mp_key_matrix_scan_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_read),     MP_ROM_PTR(&mp_key_matrix_read_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_pending),  MP_ROM_PTR(&mp_key_matrix_pending_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_pressed),  MP_ROM_PTR(&mp_key_matrix_pressed_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_clear),    MP_ROM_PTR(&mp_key_matrix_clear_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_RELEASED), MP_ROM_INT(KEY_MATRIX_RELEASED)         },
+    { MP_ROM_QSTR(MP_QSTR_PRESSED),  MP_ROM_INT(KEY_MATRIX_PRESSED)          },
+};
+
+static MP_DEFINE_CONST_DICT(mp_key_matrix_locals_dict, mp_key_matrix_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_key_matrix_type,
+    MP_QSTR_KeyMatrix,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_key_matrix_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_key_matrix_locals_dict
+);
@@ -0,0 +1,114 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/key_matrix_engine.h"
+
+
+static void key_matrix_push(key_matrix_t *km, uint32_t code, uint8_t state)
+{
+    // a full queue drops the oldest event
+    if ((uint16_t)(km->head - km->tail) == KEY_MATRIX_QUEUE_LEN) km->tail++;
+
+    key_matrix_event_t *event = &km->queue[km->head & (KEY_MATRIX_QUEUE_LEN - 1)];
+    event->code = code;
+    event->state = state;
+    km->head++;
+}
+
+
+/* In a matrix without diodes three keys pressed on the corners of a
+ * rectangle make the fourth corner read as pressed. When a row with more than
+ * one key down shares more than one column with another row it can't be
+ * known which of the keys are real, so the row is left as it was until the
+ * keys are released.
+ */
+static bool key_matrix_is_ghosted(key_matrix_t *km, uint8_t row)
+{
+    uint32_t keys = km->raw[row];
+
+    if ((keys & (keys - 1)) == 0) return false;
+
+    for (uint8_t r = 0; r < km->rows; r++) {
+        if (r == row) continue;
+
+        uint32_t shared = keys & km->raw[r];
+        if (shared & (shared - 1)) return true;
+    }
+
+    return false;
+}
+
+
+void key_matrix_update(key_matrix_t *km, const uint32_t *keys, uint32_t now_ms)
+{
+    for (uint8_t r = 0; r < km->rows; r++) {
+        // the debounce timer starts over every time the row changes
+        if (keys[r] != km->raw[r]) {
+            km->raw[r] = keys[r];
+            km->changed_ms[r] = now_ms;
+        }
+    }
+
+    for (uint8_t r = 0; r < km->rows; r++) {
+        uint32_t changed = km->raw[r] ^ km->stable[r];
+
+        if (changed == 0) continue;
+        if (now_ms - km->changed_ms[r] < km->debounce_ms) continue;
+        if (km->ghost && key_matrix_is_ghosted(km, r)) continue;
+
+        km->stable[r] = km->raw[r];
+
+        // releases go into the queue ahead of the presses
+        for (uint8_t pass = 0; pass < 2; pass++) {
+            uint32_t bits = changed & (pass ? km->stable[r] : ~km->stable[r]);
+
+            while (bits) {
+                uint8_t c = (uint8_t)__builtin_ctz(bits);
+                bits &= bits - 1;
+
+                int16_t key = (int16_t)(r * km->cols + c);
+
+                if (pass) {
+                    key_matrix_push(km, km->codes[key], KEY_MATRIX_PRESSED);
+                    km->repeat_key = key;
+                    km->repeat_ms = now_ms + km->repeat_delay;
+                } else {
+                    key_matrix_push(km, km->codes[key], KEY_MATRIX_RELEASED);
+                    if (key == km->repeat_key) km->repeat_key = -1;
+                }
+            }
+        }
+    }
+
+    // a repeat is sent as a release and a press so LVGL sees a new key
+    if (km->repeat_delay && km->repeat_key != -1 && (int32_t)(now_ms - km->repeat_ms) >= 0) {
+        uint32_t code = km->codes[km->repeat_key];
+
+        key_matrix_push(km, code, KEY_MATRIX_RELEASED);
+        key_matrix_push(km, code, KEY_MATRIX_PRESSED);
+        km->repeat_ms = now_ms + km->repeat_period;
+    }
+}
+
+
+bool key_matrix_pop(key_matrix_t *km, key_matrix_event_t *event)
+{
+    if (km->head == km->tail) return false;
+
+    *event = km->queue[km->tail & (KEY_MATRIX_QUEUE_LEN - 1)];
+    km->tail++;
+
+    return true;
+}
+
+
+uint16_t key_matrix_queued(const key_matrix_t *km)
+{
+    return (uint16_t)(km->head - km->tail);
+}
+
+
+void key_matrix_clear(key_matrix_t *km)
+{
+    km->tail = km->head;
+    km->repeat_key = -1;
+}
@@ -2,6 +2,15 @@
 
 #include "../include/remap.h"
 #include "../include/binary_float.h"
+#include "../include/touch_filter.h"
+#include "../include/touch_transform.h"
+#include "../include/touch_cal_solver.h"
+#include "../include/touch_tracker.h"
+#include "../include/touch_ring.h"
+#include "../include/pin_demux.h"
+#include "../include/encoder_accumulator.h"
+#include "../include/key_matrix.h"
+#include "../include/wait_pin.h"
 
 #include "py/obj.h"
 #include "py/runtime.h"
@@ -40,6 +49,15 @@ static const mp_rom_map_elem_t mp_lcd_utils_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_int_float_converter),    MP_ROM_PTR(&mp_lcd_utils_int_float_converter_obj) },
     { MP_ROM_QSTR(MP_QSTR_spi_mode_to_polarity_phase),    MP_ROM_PTR(&spi_mode_to_polarity_phase_obj) },
     { MP_ROM_QSTR(MP_QSTR_spi_polarity_phase_to_mode),    MP_ROM_PTR(&spi_polarity_phase_to_mode_obj) },
+    { MP_ROM_QSTR(MP_QSTR_TouchFilter),        MP_ROM_PTR(&mp_touch_filter_type) },
+    { MP_ROM_QSTR(MP_QSTR_TouchTransform),     MP_ROM_PTR(&mp_touch_transform_type) },
+    { MP_ROM_QSTR(MP_QSTR_solve_touch_cal),    MP_ROM_PTR(&mp_lcd_utils_solve_touch_cal_obj) },
+    { MP_ROM_QSTR(MP_QSTR_TouchTracker),       MP_ROM_PTR(&mp_touch_tracker_type) },
+    { MP_ROM_QSTR(MP_QSTR_TouchRing),          MP_ROM_PTR(&mp_touch_ring_type) },
+    { MP_ROM_QSTR(MP_QSTR_PinDemux),           MP_ROM_PTR(&mp_pin_demux_type) },
+    { MP_ROM_QSTR(MP_QSTR_EncoderAccumulator), MP_ROM_PTR(&mp_encoder_accumulator_type) },
+    { MP_ROM_QSTR(MP_QSTR_KeyMatrix),          MP_ROM_PTR(&mp_key_matrix_type) },
+    { MP_ROM_QSTR(MP_QSTR_WaitPin),            MP_ROM_PTR(&mp_wait_pin_type) },
 
 };
 
@@ -0,0 +1,226 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/pin_demux.h"
+
+#include "mphalport.h"
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+static uint8_t pin_demux_get_index(mp_obj_t bit_in)
+{
+    uint32_t bit = (uint32_t)mp_obj_get_int_truncated(bit_in);
+
+    if (bit == 0 || (bit & (bit - 1)) != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bit must have a single bit set"));
+    }
+
+    return (uint8_t)__builtin_ctz(bit);
+}
+
+
+static mp_obj_t mp_pin_demux_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_read,
+        ARG_debounce
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_read,        MP_ARG_OBJ | MP_ARG_REQUIRED                  },
+        { MP_QSTR_debounce,    MP_ARG_INT | MP_ARG_KW_ONLY,  { .u_int = 0    } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    if (!mp_obj_is_callable(args[ARG_read].u_obj)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("read must be callable"));
+    }
+
+    mp_pin_demux_obj_t *self = m_new0(mp_pin_demux_obj_t, 1);
+    self->base.type = &mp_pin_demux_type;
+
+    self->read = args[ARG_read].u_obj;
+    self->debounce_ms = args[ARG_debounce].u_int < 0 ? 0 : (uint32_t)args[ARG_debounce].u_int;
+
+    for (uint8_t i = 0; i < PIN_DEMUX_MAX_PINS; i++) {
+        self->entries[i].handler = mp_const_none;
+        self->entries[i].pin = mp_const_none;
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+// register(bit, handler, trigger, pin, value)
+static mp_obj_t mp_pin_demux_register(size_t n_args, const mp_obj_t *args)
+{
+    mp_pin_demux_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    uint8_t index = pin_demux_get_index(args[1]);
+    uint32_t bit = 1UL << index;
+
+    pin_demux_entry_t *entry = &self->entries[index];
+
+    entry->handler = args[2];
+    entry->trigger = (uint8_t)mp_obj_get_int(args[3]);
+    entry->pin = args[4];
+    entry->last_ms = mp_hal_ticks_ms() - self->debounce_ms;
+
+    // the level the pin is at when the handler gets set is the starting
+    // point, it isn't an edge
+    if (mp_obj_is_true(args[5])) self->states |= bit;
+    else self->states &= ~bit;
+
+    self->mask |= bit;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_pin_demux_register_obj, 6, 6, mp_pin_demux_register);
+
+
+static mp_obj_t mp_pin_demux_unregister(mp_obj_t self_in, mp_obj_t bit_in)
+{
+    mp_pin_demux_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint8_t index = pin_demux_get_index(bit_in);
+
+    self->mask &= ~(1UL << index);
+    self->pending &= ~(1UL << index);
+    self->entries[index].handler = mp_const_none;
+    self->entries[index].pin = mp_const_none;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_pin_demux_unregister_obj, mp_pin_demux_unregister);
+
+
+/* process(states=None)
+ * Called from the expander's interrupt callback. The input register(s) get
+ * read once using the read callable (unless states is passed) and only the
+ * pins that changed are looked at. A change that comes in before the pin's
+ * debounce time is up is ignored and the old level is kept. The pin gets
+ * flagged as pending, once the input register is read the expander won't
+ * interrupt again for a pin that settled on the new level, so the caller
+ * has to call process() again when pending() says the time is up.
+ * Returns the number of handlers that were called.
+ */
+static mp_obj_t mp_pin_demux_process(size_t n_args, const mp_obj_t *args)
+{
+    mp_pin_demux_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    if (self->mask == 0) return MP_OBJ_NEW_SMALL_INT(0);
+
+    mp_obj_t states_in;
+
+    if (n_args == 2 && args[1] != mp_const_none) states_in = args[1];
+    else states_in = mp_call_function_0(self->read);
+
+    uint32_t states = (uint32_t)mp_obj_get_int_truncated(states_in);
+    uint32_t changed = (states ^ self->states) & self->mask;
+    uint32_t now = mp_hal_ticks_ms();
+    mp_int_t called = 0;
+
+    // a pin that went back to the accepted level has nothing left to check
+    self->pending &= changed;
+
+    while (changed) {
+        uint8_t index = (uint8_t)__builtin_ctz(changed);
+        uint32_t bit = 1UL << index;
+        changed &= ~bit;
+
+        pin_demux_entry_t *entry = &self->entries[index];
+
+        if (self->debounce_ms && (now - entry->last_ms) < self->debounce_ms) {
+            self->pending |= bit;
+            continue;
+        }
+
+        entry->last_ms = now;
+        self->states ^= bit;
+        self->pending &= ~bit;
+
+        uint8_t edge = (states & bit) ? PIN_DEMUX_IRQ_RISING : PIN_DEMUX_IRQ_FALLING;
+
+        if (entry->trigger & edge) {
+            mp_call_function_1(entry->handler, entry->pin);
+            called++;
+        }
+    }
+
+    return MP_OBJ_NEW_SMALL_INT(called);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_pin_demux_process_obj, 1, 2, mp_pin_demux_process);
+
+
+/* pending()
+ * Milliseconds until the debounce time of the first pending pin is up and
+ * process() needs to be called to read it again, 0 if that time has already
+ * passed and -1 if no pin is pending.
+ */
+static mp_obj_t mp_pin_demux_pending(mp_obj_t self_in)
+{
+    mp_pin_demux_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    uint32_t pending = self->pending & self->mask;
+
+    if (pending == 0) return MP_OBJ_NEW_SMALL_INT(-1);
+
+    uint32_t now = mp_hal_ticks_ms();
+    uint32_t delay = self->debounce_ms;
+
+    while (pending) {
+        uint8_t index = (uint8_t)__builtin_ctz(pending);
+        pending &= ~(1UL << index);
+
+        uint32_t elapsed = now - self->entries[index].last_ms;
+
+        if (elapsed >= self->debounce_ms) return MP_OBJ_NEW_SMALL_INT(0);
+        if (self->debounce_ms - elapsed < delay) delay = self->debounce_ms - elapsed;
+    }
+
+    return mp_obj_new_int_from_uint(delay);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_pin_demux_pending_obj, mp_pin_demux_pending);
+
+
+static mp_obj_t mp_pin_demux_debounce(size_t n_args, const mp_obj_t *args)
+{
+    mp_pin_demux_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    if (n_args == 2) {
+        mp_int_t debounce = mp_obj_get_int(args[1]);
+        self->debounce_ms = debounce < 0 ? 0 : (uint32_t)debounce;
+        return mp_const_none;
+    }
+
+    return mp_obj_new_int_from_uint(self->debounce_ms);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_pin_demux_debounce_obj, 1, 2, mp_pin_demux_debounce);
+
+
+static const mp_rom_map_elem_t mp_pin_demux_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_register),        MP_ROM_PTR(&mp_pin_demux_register_obj)               },
+    { MP_ROM_QSTR(MP_QSTR_unregister),      MP_ROM_PTR(&mp_pin_demux_unregister_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_process),         MP_ROM_PTR(&mp_pin_demux_process_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_pending),         MP_ROM_PTR(&mp_pin_demux_pending_obj)                },
+    { MP_ROM_QSTR(MP_QSTR_debounce),        MP_ROM_PTR(&mp_pin_demux_debounce_obj)               },
+    { MP_ROM_QSTR(MP_QSTR_IRQ_RISING),      MP_ROM_INT(PIN_DEMUX_IRQ_RISING)                     },
+    { MP_ROM_QSTR(MP_QSTR_IRQ_FALLING),     MP_ROM_INT(PIN_DEMUX_IRQ_FALLING)                    },
+};
+
+static MP_DEFINE_CONST_DICT(mp_pin_demux_locals_dict, mp_pin_demux_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_pin_demux_type,
+    MP_QSTR_PinDemux,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_pin_demux_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_pin_demux_locals_dict
+);
@@ -0,0 +1,186 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/touch_cal_engine.h"
+
+#include <math.h>
+
+
+/* Fits the points flagged in `used`.
+ *
+ * The raw coordinates are centered on their mean before the normal
+ * equations are built. That takes the constant term out of the system
+ * which leaves a 2x2 solve for each axis and keeps the sums small enough
+ * that single precision hardware doesn't lose the fit.
+ */
+static bool touch_cal_fit(const double *raw_x, const double *raw_y, const double *scr_x, const double *scr_y,
+                          const bool *used, size_t n, touch_cal_fit_t *fit)
+{
+    double count = 0.0;
+    double mean_rx = 0.0;
+    double mean_ry = 0.0;
+    double mean_sx = 0.0;
+    double mean_sy = 0.0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!used[i]) continue;
+        count += 1.0;
+        mean_rx += raw_x[i];
+        mean_ry += raw_y[i];
+        mean_sx += scr_x[i];
+        mean_sy += scr_y[i];
+    }
+
+    if (count < 3.0) return false;
+
+    mean_rx /= count;
+    mean_ry /= count;
+    mean_sx /= count;
+    mean_sy /= count;
+
+    double sxx = 0.0;
+    double sxy = 0.0;
+    double syy = 0.0;
+    double sx_sx = 0.0;
+    double sy_sx = 0.0;
+    double sx_sy = 0.0;
+    double sy_sy = 0.0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!used[i]) continue;
+
+        double rx = raw_x[i] - mean_rx;
+        double ry = raw_y[i] - mean_ry;
+        double sx = scr_x[i] - mean_sx;
+        double sy = scr_y[i] - mean_sy;
+
+        sxx += rx * rx;
+        sxy += rx * ry;
+        syy += ry * ry;
+        sx_sx += rx * sx;
+        sy_sx += ry * sx;
+        sx_sy += rx * sy;
+        sy_sy += ry * sy;
+    }
+
+    double det = sxx * syy - sxy * sxy;
+
+    // the points are on a line (or on top of each other)
+    if (fabs(det) <= 1e-9 * (sxx * syy + 1.0)) return false;
+
+    fit->alpha_x = (sx_sx * syy - sy_sx * sxy) / det;
+    fit->beta_x = (sy_sx * sxx - sx_sx * sxy) / det;
+    fit->delta_x = mean_sx - fit->alpha_x * mean_rx - fit->beta_x * mean_ry;
+
+    fit->alpha_y = (sx_sy * syy - sy_sy * sxy) / det;
+    fit->beta_y = (sy_sy * sxx - sx_sy * sxy) / det;
+    fit->delta_y = mean_sy - fit->alpha_y * mean_rx - fit->beta_y * mean_ry;
+
+    return true;
+}
+
+
+double touch_cal_residual(const touch_cal_fit_t *fit, double raw_x, double raw_y, double scr_x, double scr_y)
+{
+    double dx = fit->alpha_x * raw_x + fit->beta_x * raw_y + fit->delta_x - scr_x;
+    double dy = fit->alpha_y * raw_x + fit->beta_y * raw_y + fit->delta_y - scr_y;
+
+    return sqrt(dx * dx + dy * dy);
+}
+
+
+/* Outlier rejection
+ *
+ * A bad point pulls the fit towards itself, with only a few points it pulls
+ * hard enough that its own residual isn't any bigger than the residuals of
+ * the good points. So every point gets checked against a fit that is done
+ * without it. That leave one out error gets scaled by sqrt(1 - h), h being
+ * how much pull the point has on the fit (the ratio of the normal residual
+ * to the leave one out error), and divided by the RMS error of the other
+ * points. The result is how many standard deviations of the noise the point
+ * is off by, the point that is off by the most gets dropped if that is more
+ * than `reject`.
+ *
+ * Each check needs 3 points for the fit and at least 1 more to measure the
+ * noise with, so nothing gets dropped from fewer than 5 points. A point
+ * whose removal leaves the rest on a line can't be checked and is kept.
+ */
+uint8_t touch_cal_solve(const double *raw_x, const double *raw_y, const double *scr_x, const double *scr_y,
+                        size_t n, double reject, bool *used, touch_cal_fit_t *fit, double *rms)
+{
+    if (n < 3) return TOUCH_CAL_TOO_FEW;
+
+    for (size_t i = 0; i < n; i++) used[i] = true;
+
+    if (!touch_cal_fit(raw_x, raw_y, scr_x, scr_y, used, n, fit)) return TOUCH_CAL_COLLINEAR;
+
+    size_t used_count = n;
+
+    while (reject > 0.0 && used_count >= 5) {
+        double worst = 0.0;
+        size_t worst_index = 0;
+        touch_cal_fit_t worst_fit;
+
+        for (size_t i = 0; i < n; i++) {
+            if (!used[i]) continue;
+
+            touch_cal_fit_t loo;
+
+            used[i] = false;
+            bool ok = touch_cal_fit(raw_x, raw_y, scr_x, scr_y, used, n, &loo);
+
+            double sum_sq = 0.0;
+            if (ok) {
+                for (size_t j = 0; j < n; j++) {
+                    if (!used[j]) continue;
+
+                    double residual = touch_cal_residual(&loo, raw_x[j], raw_y[j], scr_x[j], scr_y[j]);
+                    sum_sq += residual * residual;
+                }
+            }
+
+            used[i] = true;
+
+            if (!ok) continue;
+
+            double loo_error = touch_cal_residual(&loo, raw_x[i], raw_y[i], scr_x[i], scr_y[i]);
+
+            // under a pixel of error is as good as it is going to get
+            if (loo_error <= 1.0) continue;
+
+            double error = touch_cal_residual(fit, raw_x[i], raw_y[i], scr_x[i], scr_y[i]);
+
+            // 3 parameters per axis are fit from used_count - 1 points, the
+            // noise floor of half a pixel keeps near perfect points from
+            // making a small error look large
+            double variance = sum_sq / (double)(used_count - 4);
+            if (variance < 0.25) variance = 0.25;
+
+            double score = sqrt(loo_error * error / variance);
+
+            if (score > worst) {
+                worst = score;
+                worst_index = i;
+                worst_fit = loo;
+            }
+        }
+
+        if (worst <= reject) break;
+
+        used[worst_index] = false;
+        *fit = worst_fit;
+        used_count--;
+    }
+
+    double sum_sq = 0.0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!used[i]) continue;
+
+        double residual = touch_cal_residual(fit, raw_x[i], raw_y[i], scr_x[i], scr_y[i]);
+        sum_sq += residual * residual;
+    }
+
+    *rms = sqrt(sum_sq / (double)used_count);
+
+    return TOUCH_CAL_OK;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/touch_cal_solver.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+static void touch_cal_get_points(mp_obj_t points_in, double *xs, double *ys, size_t *n)
+{
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_get_array(points_in, &len, &items);
+
+    if (len > TOUCH_CAL_MAX_POINTS) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("a maximum of %d points is supported"), TOUCH_CAL_MAX_POINTS);
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        mp_obj_t *point;
+        mp_obj_get_array_fixed_n(items[i], 2, &point);
+        xs[i] = (double)mp_obj_get_float(point[0]);
+        ys[i] = (double)mp_obj_get_float(point[1]);
+    }
+
+    *n = len;
+}
+
+
+static mp_obj_t mp_lcd_utils_solve_touch_cal(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_raw_points, ARG_screen_points, ARG_reject };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_raw_points,    MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_screen_points, MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_reject,        MP_ARG_OBJ | MP_ARG_KW_ONLY,  { .u_obj = mp_const_none } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    double raw_x[TOUCH_CAL_MAX_POINTS];
+    double raw_y[TOUCH_CAL_MAX_POINTS];
+    double scr_x[TOUCH_CAL_MAX_POINTS];
+    double scr_y[TOUCH_CAL_MAX_POINTS];
+    bool used[TOUCH_CAL_MAX_POINTS];
+
+    size_t n;
+    size_t scr_n;
+
+    touch_cal_get_points(args[ARG_raw_points].u_obj, raw_x, raw_y, &n);
+    touch_cal_get_points(args[ARG_screen_points].u_obj, scr_x, scr_y, &scr_n);
+
+    if (n != scr_n) {
+        mp_raise_ValueError(MP_ERROR_TEXT("raw_points and screen_points must be the same length"));
+    }
+
+    if (n < 3) {
+        mp_raise_ValueError(MP_ERROR_TEXT("at least 3 points are needed"));
+    }
+
+    // a point that is more than `reject` standard deviations of the noise
+    // away from a fit of the other points gets dropped, see
+    // touch_cal_engine.c. 0 turns it off
+    double reject = 4.0;
+    if (args[ARG_reject].u_obj != mp_const_none) {
+        reject = (double)mp_obj_get_float(args[ARG_reject].u_obj);
+    }
+
+    touch_cal_fit_t fit;
+    double rms;
+
+    if (touch_cal_solve(raw_x, raw_y, scr_x, scr_y, n, reject, used, &fit, &rms) != TOUCH_CAL_OK) {
+        mp_raise_ValueError(MP_ERROR_TEXT("touch points are collinear"));
+    }
+
+    mp_obj_t residuals = mp_obj_new_list(0, NULL);
+    mp_obj_t rejected = mp_obj_new_list(0, NULL);
+
+    for (size_t i = 0; i < n; i++) {
+        double residual = touch_cal_residual(&fit, raw_x[i], raw_y[i], scr_x[i], scr_y[i]);
+        mp_obj_list_append(residuals, mp_obj_new_float((mp_float_t)residual));
+
+        if (!used[i]) mp_obj_list_append(rejected, mp_obj_new_int_from_uint(i));
+    }
+
+    mp_obj_t tuple[9] = {
+        mp_obj_new_float((mp_float_t)fit.alpha_x),
+        mp_obj_new_float((mp_float_t)fit.beta_x),
+        mp_obj_new_float((mp_float_t)fit.delta_x),
+        mp_obj_new_float((mp_float_t)fit.alpha_y),
+        mp_obj_new_float((mp_float_t)fit.beta_y),
+        mp_obj_new_float((mp_float_t)fit.delta_y),
+        mp_obj_new_float((mp_float_t)rms),
+        residuals,
+        rejected,
+    };
+
+    return mp_obj_new_tuple(9, tuple);
+}
+
+MP_DEFINE_CONST_FUN_OBJ_KW(mp_lcd_utils_solve_touch_cal_obj, 2, mp_lcd_utils_solve_touch_cal);
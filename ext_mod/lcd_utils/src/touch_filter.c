@@ -0,0 +1,136 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/touch_filter.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+static mp_obj_t mp_touch_filter_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_margin,
+        ARG_threshold,
+        ARG_trim,
+        ARG_smoothing,
+        ARG_min_raw,
+        ARG_max_raw,
+        ARG_format
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_margin,      MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 50                         } },
+        { MP_QSTR_threshold,   MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0                          } },
+        { MP_QSTR_trim,        MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 1                          } },
+        { MP_QSTR_smoothing,   MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0                          } },
+        { MP_QSTR_min_raw,     MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0                          } },
+        { MP_QSTR_max_raw,     MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0xFFFF                     } },
+        { MP_QSTR_format,      MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = TOUCH_FILTER_FORMAT_XY16   } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    if (args[ARG_format].u_int < TOUCH_FILTER_FORMAT_XY16 ||
+            args[ARG_format].u_int > TOUCH_FILTER_FORMAT_STMPE610) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid sample format"));
+    }
+
+    if (args[ARG_smoothing].u_int < 0 || args[ARG_smoothing].u_int > 255) {
+        mp_raise_ValueError(MP_ERROR_TEXT("smoothing must be 0 - 255"));
+    }
+
+    mp_touch_filter_obj_t *self = m_new_obj(mp_touch_filter_obj_t);
+    self->base.type = &mp_touch_filter_type;
+
+    mp_int_t margin = args[ARG_margin].u_int;
+    if (margin < 0) margin = 0;
+    else if (margin > 0xFFFF) margin = 0xFFFF;
+
+    self->threshold = (uint16_t)args[ARG_threshold].u_int;
+    self->format = (uint8_t)args[ARG_format].u_int;
+
+    self->filter.min_raw = (uint16_t)args[ARG_min_raw].u_int;
+    self->filter.max_raw = (uint16_t)args[ARG_max_raw].u_int;
+    self->filter.trim = (uint8_t)args[ARG_trim].u_int;
+    self->filter.smoothing = (uint8_t)args[ARG_smoothing].u_int;
+    self->filter.margin_sq = (uint32_t)(margin * margin);
+
+    touch_filter_reset(&self->filter);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+static mp_obj_t mp_touch_filter_process(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_samples, ARG_z };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,    MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_samples, MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_z,       MP_ARG_OBJ,                   { .u_obj = mp_const_none } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_touch_filter_obj_t *self = MP_OBJ_TO_PTR(args[ARG_self].u_obj);
+
+    // pressure gate, a lifted stylus also ends the smoothing run
+    if (args[ARG_z].u_obj != mp_const_none &&
+            mp_obj_get_int(args[ARG_z].u_obj) < (mp_int_t)self->threshold) {
+        touch_filter_reset(&self->filter);
+        return mp_const_none;
+    }
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_samples].u_obj, &bufinfo, MP_BUFFER_READ);
+
+    uint16_t xs[TOUCH_FILTER_MAX_SAMPLES];
+    uint16_t ys[TOUCH_FILTER_MAX_SAMPLES];
+    size_t n = touch_filter_decode(self->format, (const uint8_t *)bufinfo.buf, bufinfo.len, xs, ys);
+
+    uint16_t x;
+    uint16_t y;
+
+    if (!touch_filter_run(&self->filter, xs, ys, n, &x, &y)) return mp_const_none;
+
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int_from_uint(x),
+        mp_obj_new_int_from_uint(y),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(mp_touch_filter_process_obj, 2, mp_touch_filter_process);
+
+
+static mp_obj_t mp_touch_filter_reset(mp_obj_t self_in)
+{
+    mp_touch_filter_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    touch_filter_reset(&self->filter);
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_filter_reset_obj, mp_touch_filter_reset);
+
+
+static const mp_rom_map_elem_t mp_touch_filter_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_process),         MP_ROM_PTR(&mp_touch_filter_process_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_reset),           MP_ROM_PTR(&mp_touch_filter_reset_obj)               },
+    { MP_ROM_QSTR(MP_QSTR_FORMAT_XY16),     MP_ROM_INT(TOUCH_FILTER_FORMAT_XY16)                 },
+    { MP_ROM_QSTR(MP_QSTR_FORMAT_XPT2046),  MP_ROM_INT(TOUCH_FILTER_FORMAT_XPT2046)              },
+    { MP_ROM_QSTR(MP_QSTR_FORMAT_STMPE610), MP_ROM_INT(TOUCH_FILTER_FORMAT_STMPE610)             },
+    { MP_ROM_QSTR(MP_QSTR_MAX_SAMPLES),     MP_ROM_INT(TOUCH_FILTER_MAX_SAMPLES)                 },
+};
+
+static MP_DEFINE_CONST_DICT(mp_touch_filter_locals_dict, mp_touch_filter_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_touch_filter_type,
+    MP_QSTR_TouchFilter,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_touch_filter_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_touch_filter_locals_dict
+);
@@ -0,0 +1,150 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/touch_filter_engine.h"
+
+/* Everything in here is done with integer math on the raw ADC values, no
+ * MicroPython objects are used.
+ */
+
+
+static void sort_u16(uint16_t *items, size_t n)
+{
+    // insertion sort, n is never more than TOUCH_FILTER_MAX_SAMPLES
+    for (size_t i = 1; i < n; i++) {
+        uint16_t item = items[i];
+        size_t j = i;
+
+        while (j > 0 && items[j - 1] > item) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = item;
+    }
+}
+
+
+size_t touch_filter_decode(uint8_t format, const uint8_t *buf, size_t len, uint16_t *xs, uint16_t *ys)
+{
+    size_t n;
+
+    switch (format) {
+        case TOUCH_FILTER_FORMAT_XPT2046:
+            n = len / 6;
+            if (n > TOUCH_FILTER_MAX_SAMPLES) n = TOUCH_FILTER_MAX_SAMPLES;
+
+            for (size_t i = 0; i < n; i++) {
+                const uint8_t *frame = buf + (i * 6);
+                xs[i] = (uint16_t)((((uint16_t)frame[1] << 8) | frame[2]) >> 3);
+                ys[i] = (uint16_t)((((uint16_t)frame[4] << 8) | frame[5]) >> 3);
+            }
+            break;
+
+        case TOUCH_FILTER_FORMAT_STMPE610:
+            n = len / 4;
+            if (n > TOUCH_FILTER_MAX_SAMPLES) n = TOUCH_FILTER_MAX_SAMPLES;
+
+            for (size_t i = 0; i < n; i++) {
+                const uint8_t *packet = buf + (i * 4);
+                xs[i] = (uint16_t)(((uint16_t)packet[0] << 4) | (packet[1] >> 4));
+                ys[i] = (uint16_t)((((uint16_t)packet[1] & 0x0F) << 8) | packet[2]);
+            }
+            break;
+
+        default: {
+            const uint16_t *buf16 = (const uint16_t *)buf;
+            n = len / 4;
+            if (n > TOUCH_FILTER_MAX_SAMPLES) n = TOUCH_FILTER_MAX_SAMPLES;
+
+            for (size_t i = 0; i < n; i++) {
+                xs[i] = buf16[i * 2];
+                ys[i] = buf16[(i * 2) + 1];
+            }
+            break;
+        }
+    }
+
+    return n;
+}
+
+
+void touch_filter_reset(touch_filter_t *filter)
+{
+    filter->has_last = false;
+    filter->last_x = 0;
+    filter->last_y = 0;
+}
+
+
+bool touch_filter_run(touch_filter_t *filter, uint16_t *xs, uint16_t *ys, size_t n, uint16_t *x_out, uint16_t *y_out)
+{
+    size_t count = 0;
+
+    // drop the samples that are outside of the usable ADC range
+    for (size_t i = 0; i < n; i++) {
+        if (xs[i] > filter->min_raw && xs[i] < filter->max_raw &&
+                ys[i] > filter->min_raw && ys[i] < filter->max_raw) {
+            xs[count] = xs[i];
+            ys[count] = ys[i];
+            count++;
+        }
+    }
+
+    // a contact that is still settling gives mostly garbage
+    if (count == 0 || count * 2 < n) return false;
+
+    sort_u16(xs, count);
+    sort_u16(ys, count);
+
+    // trimming (count - 1) / 2 from each end leaves the median
+    size_t trim = filter->trim;
+    if (trim * 2 >= count) trim = (count - 1) / 2;
+
+    size_t first = trim;
+    size_t last = count - trim;
+    size_t used = last - first;
+
+    uint32_t sum_x = 0;
+    uint32_t sum_y = 0;
+
+    for (size_t i = first; i < last; i++) {
+        sum_x += xs[i];
+        sum_y += ys[i];
+    }
+
+    int32_t mean_x = (int32_t)((sum_x + used / 2) / used);
+    int32_t mean_y = (int32_t)((sum_y + used / 2) / used);
+
+    // 16 bit samples can be 65535 apart, the square of that alone doesn't
+    // fit in an int32_t
+    uint64_t dev = 0;
+    int64_t diff;
+
+    for (size_t i = first; i < last; i++) {
+        diff = (int64_t)xs[i] - mean_x;
+        dev += (uint64_t)(diff * diff);
+        diff = (int64_t)ys[i] - mean_y;
+        dev += (uint64_t)(diff * diff);
+    }
+
+    if (dev / used > filter->margin_sq) return false;
+
+    // IIR smoothing, the running point is kept in Q4 so slow movement
+    // doesn't get lost to rounding
+    int32_t new_x = mean_x << 4;
+    int32_t new_y = mean_y << 4;
+
+    if (filter->has_last && filter->smoothing) {
+        int32_t weight = (int32_t)filter->smoothing;
+        new_x = (filter->last_x * weight + new_x * (256 - weight)) >> 8;
+        new_y = (filter->last_y * weight + new_y * (256 - weight)) >> 8;
+    }
+
+    filter->last_x = new_x;
+    filter->last_y = new_y;
+    filter->has_last = true;
+
+    *x_out = (uint16_t)((new_x + 8) >> 4);
+    *y_out = (uint16_t)((new_y + 8) >> 4);
+
+    return true;
+}
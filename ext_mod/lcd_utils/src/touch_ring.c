@@ -0,0 +1,232 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/touch_ring.h"
+
+#include "mphalport.h"
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+static mp_obj_t mp_touch_ring_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_callback,
+        ARG_size
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_callback,    MP_ARG_OBJ | MP_ARG_REQUIRED                                 },
+        { MP_QSTR_size,        MP_ARG_INT | MP_ARG_KW_ONLY,  { .u_int = TOUCH_RING_DEFAULT_SIZE } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    mp_int_t size = args[ARG_size].u_int;
+
+    if (size < 2 || size > TOUCH_RING_MAX_SIZE) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("size must be 2 - %d"), TOUCH_RING_MAX_SIZE);
+    }
+
+    // the free running indexes only wrap cleanly with a power of 2
+    uint16_t ring_size = 2;
+    while (ring_size < size) ring_size <<= 1;
+
+    mp_touch_ring_obj_t *self = m_new_obj(mp_touch_ring_obj_t);
+    self->base.type = &mp_touch_ring_type;
+
+    self->callback = args[ARG_callback].u_obj;
+    self->mask = ring_size - 1;
+    self->events = m_new(touch_event_t, ring_size);
+    self->edges = m_new(uint32_t, ring_size);
+    self->head = 0;
+    self->tail = 0;
+    self->edge_head = 0;
+    self->edge_tail = 0;
+    self->scheduled = false;
+    self->dropped = 0;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+/* Pin interrupt handler.
+ * This is safe to register as a hard IRQ, it doesn't allocate. It stamps the
+ * edge and schedules the callback to do the bus read. Any edges that come in
+ * before the callback runs get coalesced into that one read.
+ */
+static mp_obj_t mp_touch_ring_irq(mp_obj_t self_in, mp_obj_t pin_in)
+{
+    (void)pin_in;
+    mp_touch_ring_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    uint32_t ticks = mp_hal_ticks_us();
+
+    if ((uint16_t)(self->edge_head - self->edge_tail) <= self->mask) {
+        self->edges[self->edge_head & self->mask] = ticks;
+        self->edge_head++;
+    }
+
+    if (!self->scheduled && self->callback != mp_const_none) {
+        self->scheduled = mp_sched_schedule(self->callback, MP_OBJ_FROM_PTR(self));
+    }
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_touch_ring_irq_obj, mp_touch_ring_irq);
+
+
+// returns the time stamp of the oldest edge that has not been read yet or
+// None and marks all of the pending edges as handled.
+static mp_obj_t mp_touch_ring_edge(mp_obj_t self_in)
+{
+    mp_touch_ring_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // cleared first so an edge that comes in from here on schedules
+    // another read
+    self->scheduled = false;
+
+    uint16_t edge_head = self->edge_head;
+
+    if (edge_head == self->edge_tail) return mp_const_none;
+
+    uint32_t ticks = self->edges[self->edge_tail & self->mask];
+    self->edge_tail = edge_head;
+
+    return mp_obj_new_int_from_uint(ticks & (MICROPY_PY_TIME_TICKS_PERIOD - 1));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_ring_edge_obj, mp_touch_ring_edge);
+
+
+static mp_obj_t mp_touch_ring_put(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_state, ARG_x, ARG_y, ARG_ticks };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,    MP_ARG_OBJ | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_state,   MP_ARG_INT | MP_ARG_REQUIRED, { .u_int = 0             } },
+        { MP_QSTR_x,       MP_ARG_INT | MP_ARG_REQUIRED, { .u_int = 0             } },
+        { MP_QSTR_y,       MP_ARG_INT | MP_ARG_REQUIRED, { .u_int = 0             } },
+        { MP_QSTR_ticks,   MP_ARG_OBJ,                   { .u_obj = mp_const_none } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_touch_ring_obj_t *self = MP_OBJ_TO_PTR(args[ARG_self].u_obj);
+
+    uint16_t head = self->head;
+
+    // the oldest events are what LVGL needs to see first, a full ring
+    // drops the new one instead
+    if ((uint16_t)(head - self->tail) > self->mask) {
+        self->dropped++;
+        return mp_const_false;
+    }
+
+    touch_event_t *event = &self->events[head & self->mask];
+
+    if (args[ARG_ticks].u_obj == mp_const_none) {
+        event->ticks = mp_hal_ticks_us();
+    } else {
+        event->ticks = (uint32_t)mp_obj_get_int_truncated(args[ARG_ticks].u_obj);
+    }
+
+    event->state = (uint8_t)args[ARG_state].u_int;
+    event->x = (int16_t)args[ARG_x].u_int;
+    event->y = (int16_t)args[ARG_y].u_int;
+
+    self->head = head + 1;
+
+    return mp_const_true;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(mp_touch_ring_put_obj, 4, mp_touch_ring_put);
+
+
+// (state, x, y, ticks) of the oldest event or None if the ring is empty
+static mp_obj_t mp_touch_ring_get(mp_obj_t self_in)
+{
+    mp_touch_ring_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    uint16_t tail = self->tail;
+
+    if (tail == self->head) return mp_const_none;
+
+    touch_event_t *event = &self->events[tail & self->mask];
+
+    mp_obj_t tuple[4] = {
+        mp_obj_new_int_from_uint(event->state),
+        mp_obj_new_int(event->x),
+        mp_obj_new_int(event->y),
+        mp_obj_new_int_from_uint(event->ticks & (MICROPY_PY_TIME_TICKS_PERIOD - 1)),
+    };
+
+    self->tail = tail + 1;
+
+    return mp_obj_new_tuple(4, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_ring_get_obj, mp_touch_ring_get);
+
+
+static mp_obj_t mp_touch_ring_clear(mp_obj_t self_in)
+{
+    mp_touch_ring_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    self->tail = self->head;
+    self->edge_tail = self->edge_head;
+    self->scheduled = false;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_ring_clear_obj, mp_touch_ring_clear);
+
+
+static mp_obj_t mp_touch_ring_dropped(mp_obj_t self_in)
+{
+    mp_touch_ring_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int_from_uint(self->dropped);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_ring_dropped_obj, mp_touch_ring_dropped);
+
+
+static mp_obj_t mp_touch_ring_unary_op(mp_unary_op_t op, mp_obj_t self_in)
+{
+    mp_touch_ring_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint16_t count = (uint16_t)(self->head - self->tail);
+
+    switch (op) {
+        case MP_UNARY_OP_BOOL:
+            return mp_obj_new_bool(count != 0);
+        case MP_UNARY_OP_LEN:
+            return MP_OBJ_NEW_SMALL_INT(count);
+        default:
+            return MP_OBJ_NULL;
+    }
+}
+
+
+static const mp_rom_map_elem_t mp_touch_ring_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_irq),             MP_ROM_PTR(&mp_touch_ring_irq_obj)                   },
+    { MP_ROM_QSTR(MP_QSTR_edge),            MP_ROM_PTR(&mp_touch_ring_edge_obj)                  },
+    { MP_ROM_QSTR(MP_QSTR_put),             MP_ROM_PTR(&mp_touch_ring_put_obj)                   },
+    { MP_ROM_QSTR(MP_QSTR_get),             MP_ROM_PTR(&mp_touch_ring_get_obj)                   },
+    { MP_ROM_QSTR(MP_QSTR_clear),           MP_ROM_PTR(&mp_touch_ring_clear_obj)                 },
+    { MP_ROM_QSTR(MP_QSTR_dropped),         MP_ROM_PTR(&mp_touch_ring_dropped_obj)               },
+};
+
+static MP_DEFINE_CONST_DICT(mp_touch_ring_locals_dict, mp_touch_ring_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_touch_ring_type,
+    MP_QSTR_TouchRing,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_touch_ring_make_new,
+    unary_op, mp_touch_ring_unary_op,
+    locals_dict, (mp_obj_dict_t *)&mp_touch_ring_locals_dict
+);
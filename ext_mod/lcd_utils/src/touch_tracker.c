@@ -0,0 +1,420 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/touch_tracker.h"
+#include "../include/touch_transform.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include <math.h>
+
+
+#define TOUCH_PI  3.14159265358979323846f
+
+// points without a tracking id get matched to the closest contact from
+// the last update if it is closer than this (raw units, squared)
+#define TOUCH_MATCH_DIST_SQ  (80 * 80)
+
+
+typedef struct _touch_point_t {
+    int16_t id;
+    int16_t x;
+    int16_t y;
+} touch_point_t;
+
+
+static void touch_tracker_reset_gesture(mp_touch_tracker_obj_t *self)
+{
+    self->gesture_ids[0] = -1;
+    self->gesture_ids[1] = -1;
+    self->gesture = TOUCH_GESTURE_NONE;
+    self->scale = 1.0f;
+    self->rotation = 0.0f;
+    self->pan_x = 0.0f;
+    self->pan_y = 0.0f;
+}
+
+
+static void touch_tracker_screen_point(mp_touch_tracker_obj_t *self, touch_contact_t *contact, float *x, float *y)
+{
+    int32_t px = contact->x;
+    int32_t py = contact->y;
+
+    if (self->transform != NULL) touch_transform_map(self->transform, &px, &py);
+
+    *x = (float)px;
+    *y = (float)py;
+}
+
+
+static void touch_tracker_update_gesture(mp_touch_tracker_obj_t *self, touch_contact_t *first, touch_contact_t *second)
+{
+    float x1, y1, x2, y2;
+
+    touch_tracker_screen_point(self, first, &x1, &y1);
+    touch_tracker_screen_point(self, second, &x2, &y2);
+
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float distance = sqrtf(dx * dx + dy * dy);
+    float angle = atan2f(dy, dx) * 180.0f / TOUCH_PI;
+    float mid_x = (x1 + x2) / 2.0f;
+    float mid_y = (y1 + y2) / 2.0f;
+
+    if (self->gesture_ids[0] != first->id || self->gesture_ids[1] != second->id) {
+        // a new pair of fingers, this is where the gesture is measured from
+        touch_tracker_reset_gesture(self);
+        self->gesture_ids[0] = first->id;
+        self->gesture_ids[1] = second->id;
+        self->start_distance = distance;
+        self->start_angle = angle;
+        self->start_mid_x = mid_x;
+        self->start_mid_y = mid_y;
+        return;
+    }
+
+    float rotation = angle - self->start_angle;
+    if (rotation > 180.0f) rotation -= 360.0f;
+    else if (rotation < -180.0f) rotation += 360.0f;
+
+    self->scale = (self->start_distance > 0.0f) ? distance / self->start_distance : 1.0f;
+    self->rotation = rotation;
+    self->pan_x = mid_x - self->start_mid_x;
+    self->pan_y = mid_y - self->start_mid_y;
+
+    if (self->gesture != TOUCH_GESTURE_NONE) return;
+
+    // The first threshold that gets crossed decides the gesture, it stays
+    // that way until one of the two fingers is lifted. Each amount is put
+    // in terms of its threshold so they are able to be compared.
+    float pinch = fabsf(self->scale - 1.0f) / self->pinch_threshold;
+    float rotate = fabsf(self->rotation) / self->rotate_threshold;
+    float swipe = sqrtf(self->pan_x * self->pan_x + self->pan_y * self->pan_y) / self->swipe_threshold;
+
+    if (pinch >= 1.0f && pinch >= rotate && pinch >= swipe) {
+        self->gesture = TOUCH_GESTURE_PINCH;
+    } else if (rotate >= 1.0f && rotate >= swipe) {
+        self->gesture = TOUCH_GESTURE_ROTATE;
+    } else if (swipe >= 1.0f) {
+        self->gesture = TOUCH_GESTURE_SWIPE;
+    }
+}
+
+
+static size_t touch_tracker_decode(mp_touch_tracker_obj_t *self, const uint8_t *buf, size_t len, size_t count, touch_point_t *points)
+{
+    size_t n;
+
+    if (self->format == TOUCH_TRACKER_FORMAT_GT911) {
+        n = len / 8;
+        if (count < n) n = count;
+
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t *record = buf + (i * 8);
+            points[i].id = (int16_t)record[0];
+            points[i].x = (int16_t)((uint16_t)record[1] | ((uint16_t)record[2] << 8));
+            points[i].y = (int16_t)((uint16_t)record[3] | ((uint16_t)record[4] << 8));
+        }
+    } else {
+        const int16_t *buf16 = (const int16_t *)buf;
+        n = len / 6;
+        if (count < n) n = count;
+
+        for (size_t i = 0; i < n; i++) {
+            points[i].id = buf16[i * 3];
+            points[i].x = buf16[(i * 3) + 1];
+            points[i].y = buf16[(i * 3) + 2];
+        }
+    }
+
+    return n;
+}
+
+
+static void touch_tracker_assign_ids(mp_touch_tracker_obj_t *self, touch_point_t *points, size_t n)
+{
+    bool taken[TOUCH_TRACKER_MAX_CONTACTS] = { false };
+
+    for (size_t i = 0; i < n; i++) {
+        if (points[i].id >= 0) continue;
+
+        int32_t best_dist = TOUCH_MATCH_DIST_SQ;
+        int best = -1;
+
+        for (uint8_t j = 0; j < self->max_contacts; j++) {
+            touch_contact_t *contact = &self->contacts[j];
+            if (!contact->active || taken[j]) continue;
+
+            int32_t dx = (int32_t)contact->x - points[i].x;
+            int32_t dy = (int32_t)contact->y - points[i].y;
+            int32_t dist = dx * dx + dy * dy;
+
+            if (dist < best_dist) {
+                best_dist = dist;
+                best = j;
+            }
+        }
+
+        if (best >= 0) {
+            taken[best] = true;
+            points[i].id = self->contacts[best].id;
+        } else {
+            // ids that are made up start above anything a controller uses
+            points[i].id = self->next_id;
+            self->next_id = (self->next_id >= 0x7FFF) ? 0x100 : self->next_id + 1;
+        }
+    }
+}
+
+
+static mp_obj_t mp_touch_tracker_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_max_contacts,
+        ARG_format,
+        ARG_transform,
+        ARG_pinch_threshold,
+        ARG_rotate_threshold,
+        ARG_swipe_threshold
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_max_contacts,     MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 5                          } },
+        { MP_QSTR_format,           MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = TOUCH_TRACKER_FORMAT_IXY16 } },
+        { MP_QSTR_transform,        MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none              } },
+        { MP_QSTR_pinch_threshold,  MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none              } },
+        { MP_QSTR_rotate_threshold, MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none              } },
+        { MP_QSTR_swipe_threshold,  MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none              } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    if (args[ARG_max_contacts].u_int < 1 || args[ARG_max_contacts].u_int > TOUCH_TRACKER_MAX_CONTACTS) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("max_contacts must be 1 - %d"), TOUCH_TRACKER_MAX_CONTACTS);
+    }
+
+    if (args[ARG_format].u_int != TOUCH_TRACKER_FORMAT_IXY16 &&
+            args[ARG_format].u_int != TOUCH_TRACKER_FORMAT_GT911) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid point format"));
+    }
+
+    mp_touch_tracker_obj_t *self = m_new_obj(mp_touch_tracker_obj_t);
+    self->base.type = &mp_touch_tracker_type;
+
+    self->max_contacts = (uint8_t)args[ARG_max_contacts].u_int;
+    self->format = (uint8_t)args[ARG_format].u_int;
+
+    if (args[ARG_transform].u_obj == mp_const_none) {
+        self->transform = NULL;
+    } else if (mp_obj_is_type(args[ARG_transform].u_obj, &mp_touch_transform_type)) {
+        self->transform = MP_OBJ_TO_PTR(args[ARG_transform].u_obj);
+    } else {
+        mp_raise_TypeError(MP_ERROR_TEXT("transform must be a TouchTransform"));
+    }
+
+    self->pinch_threshold = (args[ARG_pinch_threshold].u_obj == mp_const_none) ? 0.15f :
+                            mp_obj_get_float_to_f(args[ARG_pinch_threshold].u_obj);
+    self->rotate_threshold = (args[ARG_rotate_threshold].u_obj == mp_const_none) ? 15.0f :
+                             mp_obj_get_float_to_f(args[ARG_rotate_threshold].u_obj);
+    self->swipe_threshold = (args[ARG_swipe_threshold].u_obj == mp_const_none) ? 30.0f :
+                            mp_obj_get_float_to_f(args[ARG_swipe_threshold].u_obj);
+
+    if (self->pinch_threshold <= 0.0f || self->rotate_threshold <= 0.0f || self->swipe_threshold <= 0.0f) {
+        mp_raise_ValueError(MP_ERROR_TEXT("thresholds must be larger than 0"));
+    }
+
+    for (uint8_t i = 0; i < TOUCH_TRACKER_MAX_CONTACTS; i++) {
+        self->contacts[i].active = false;
+    }
+
+    self->order = 0;
+    self->next_id = 0x100;
+
+    touch_tracker_reset_gesture(self);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+// update(points, count) -> (x, y) of the primary contact or None
+static mp_obj_t mp_touch_tracker_update(mp_obj_t self_in, mp_obj_t points_in, mp_obj_t count_in)
+{
+    mp_touch_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(points_in, &bufinfo, MP_BUFFER_READ);
+
+    size_t count = (size_t)mp_obj_get_int(count_in);
+    if (count > self->max_contacts) count = self->max_contacts;
+
+    touch_point_t points[TOUCH_TRACKER_MAX_CONTACTS];
+    size_t n = touch_tracker_decode(self, (const uint8_t *)bufinfo.buf, bufinfo.len, count, points);
+
+    touch_tracker_assign_ids(self, points, n);
+
+    for (uint8_t i = 0; i < self->max_contacts; i++) self->contacts[i].seen = false;
+
+    for (size_t i = 0; i < n; i++) {
+        touch_contact_t *slot = NULL;
+        touch_contact_t *free_slot = NULL;
+
+        for (uint8_t j = 0; j < self->max_contacts; j++) {
+            touch_contact_t *contact = &self->contacts[j];
+
+            if (contact->active && contact->id == points[i].id) {
+                slot = contact;
+                break;
+            } else if (!contact->active && free_slot == NULL) {
+                free_slot = contact;
+            }
+        }
+
+        if (slot == NULL) {
+            if (free_slot == NULL) continue;
+
+            slot = free_slot;
+            slot->active = true;
+            slot->id = points[i].id;
+            slot->order = ++self->order;
+        }
+
+        slot->x = points[i].x;
+        slot->y = points[i].y;
+        slot->seen = true;
+    }
+
+    // anything that wasn't reported has been lifted
+    touch_contact_t *first = NULL;
+    touch_contact_t *second = NULL;
+
+    for (uint8_t i = 0; i < self->max_contacts; i++) {
+        touch_contact_t *contact = &self->contacts[i];
+
+        if (!contact->seen) {
+            contact->active = false;
+            continue;
+        }
+
+        if (first == NULL || contact->order < first->order) {
+            second = first;
+            first = contact;
+        } else if (second == NULL || contact->order < second->order) {
+            second = contact;
+        }
+    }
+
+    if (second != NULL) {
+        touch_tracker_update_gesture(self, first, second);
+    } else {
+        touch_tracker_reset_gesture(self);
+    }
+
+    if (first == NULL) return mp_const_none;
+
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int(first->x),
+        mp_obj_new_int(first->y),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_3(mp_touch_tracker_update_obj, mp_touch_tracker_update);
+
+
+// gesture() -> (gesture, scale, rotation, pan_x, pan_y) or None
+static mp_obj_t mp_touch_tracker_gesture(mp_obj_t self_in)
+{
+    mp_touch_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->gesture == TOUCH_GESTURE_NONE) return mp_const_none;
+
+    mp_obj_t tuple[5] = {
+        mp_obj_new_int_from_uint(self->gesture),
+        mp_obj_new_float_from_f(self->scale),
+        mp_obj_new_float_from_f(self->rotation),
+        mp_obj_new_int((mp_int_t)self->pan_x),
+        mp_obj_new_int((mp_int_t)self->pan_y),
+    };
+    return mp_obj_new_tuple(5, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_tracker_gesture_obj, mp_touch_tracker_gesture);
+
+
+// contacts() -> tuple of (id, x, y) for every active contact, primary first
+static mp_obj_t mp_touch_tracker_contacts(mp_obj_t self_in)
+{
+    mp_touch_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    mp_obj_t items[TOUCH_TRACKER_MAX_CONTACTS];
+    size_t n = 0;
+    uint32_t last_order = 0;
+
+    // selection by order, there are never more than a handful of contacts
+    while (true) {
+        touch_contact_t *next = NULL;
+
+        for (uint8_t i = 0; i < self->max_contacts; i++) {
+            touch_contact_t *contact = &self->contacts[i];
+            if (!contact->active || contact->order <= last_order) continue;
+            if (next == NULL || contact->order < next->order) next = contact;
+        }
+
+        if (next == NULL) break;
+
+        mp_obj_t point[3] = {
+            mp_obj_new_int(next->id),
+            mp_obj_new_int(next->x),
+            mp_obj_new_int(next->y),
+        };
+        items[n++] = mp_obj_new_tuple(3, point);
+        last_order = next->order;
+    }
+
+    return mp_obj_new_tuple(n, items);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_tracker_contacts_obj, mp_touch_tracker_contacts);
+
+
+static mp_obj_t mp_touch_tracker_reset(mp_obj_t self_in)
+{
+    mp_touch_tracker_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    for (uint8_t i = 0; i < TOUCH_TRACKER_MAX_CONTACTS; i++) {
+        self->contacts[i].active = false;
+    }
+
+    touch_tracker_reset_gesture(self);
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_tracker_reset_obj, mp_touch_tracker_reset);
+
+
+static const mp_rom_map_elem_t mp_touch_tracker_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_update),         MP_ROM_PTR(&mp_touch_tracker_update_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_gesture),        MP_ROM_PTR(&mp_touch_tracker_gesture_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_contacts),       MP_ROM_PTR(&mp_touch_tracker_contacts_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset),          MP_ROM_PTR(&mp_touch_tracker_reset_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_FORMAT_IXY16),   MP_ROM_INT(TOUCH_TRACKER_FORMAT_IXY16)     },
+    { MP_ROM_QSTR(MP_QSTR_FORMAT_GT911),   MP_ROM_INT(TOUCH_TRACKER_FORMAT_GT911)     },
+    { MP_ROM_QSTR(MP_QSTR_GESTURE_NONE),   MP_ROM_INT(TOUCH_GESTURE_NONE)             },
+    { MP_ROM_QSTR(MP_QSTR_GESTURE_PINCH),  MP_ROM_INT(TOUCH_GESTURE_PINCH)            },
+    { MP_ROM_QSTR(MP_QSTR_GESTURE_ROTATE), MP_ROM_INT(TOUCH_GESTURE_ROTATE)           },
+    { MP_ROM_QSTR(MP_QSTR_GESTURE_SWIPE),  MP_ROM_INT(TOUCH_GESTURE_SWIPE)            },
+    { MP_ROM_QSTR(MP_QSTR_MAX_CONTACTS),   MP_ROM_INT(TOUCH_TRACKER_MAX_CONTACTS)     },
+};
+
+static MP_DEFINE_CONST_DICT(mp_touch_tracker_locals_dict, mp_touch_tracker_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_touch_tracker_type,
+    MP_QSTR_TouchTracker,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_touch_tracker_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_touch_tracker_locals_dict
+);
@@ -0,0 +1,205 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/touch_transform.h"
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+#define TOUCH_ROTATION_0    (0)
+#define TOUCH_ROTATION_90   (1)
+#define TOUCH_ROTATION_180  (2)
+#define TOUCH_ROTATION_270  (3)
+
+#define TO_Q16(value) ((int64_t)((value) * 65536.0f + (((value) < 0.0f) ? -0.5f : 0.5f)))
+
+
+void touch_transform_map(mp_touch_transform_obj_t *self, int32_t *x, int32_t *y)
+{
+    int32_t raw_x = *x;
+    int32_t raw_y = *y;
+
+    if (self->calibrated) {
+        int32_t new_x = (int32_t)((self->alpha_x * raw_x + self->beta_x * raw_y + self->delta_x + 0x8000) >> 16);
+        int32_t new_y = (int32_t)((self->alpha_y * raw_x + self->beta_y * raw_y + self->delta_y + 0x8000) >> 16);
+
+        if (self->mirror_x) new_x = self->width - new_x - 1;
+        if (self->mirror_y) new_y = self->height - new_y - 1;
+
+        *x = new_x;
+        *y = new_y;
+        return;
+    }
+
+    if (self->rotation == TOUCH_ROTATION_180 || self->rotation == TOUCH_ROTATION_270) {
+        raw_x = self->width - raw_x - 1;
+        raw_y = self->height - raw_y - 1;
+    }
+
+    if (self->rotation == TOUCH_ROTATION_90 || self->rotation == TOUCH_ROTATION_270) {
+        *x = self->height - raw_y - 1;
+        *y = raw_x;
+    } else {
+        *x = raw_x;
+        *y = raw_y;
+    }
+}
+
+
+static mp_obj_t mp_touch_transform_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_width,
+        ARG_height,
+        ARG_rotation
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_width,       MP_ARG_INT | MP_ARG_REQUIRED                               },
+        { MP_QSTR_height,      MP_ARG_INT | MP_ARG_REQUIRED                               },
+        { MP_QSTR_rotation,    MP_ARG_INT,                   { .u_int = TOUCH_ROTATION_0  } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    mp_touch_transform_obj_t *self = m_new_obj(mp_touch_transform_obj_t);
+    self->base.type = &mp_touch_transform_type;
+
+    self->width = (int32_t)args[ARG_width].u_int;
+    self->height = (int32_t)args[ARG_height].u_int;
+    self->rotation = (uint8_t)(args[ARG_rotation].u_int & 0x3);
+    self->calibrated = false;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+static mp_obj_t mp_touch_transform_set_calibration(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum { ARG_self, ARG_alphaX, ARG_betaX, ARG_deltaX, ARG_alphaY, ARG_betaY, ARG_deltaY, ARG_mirrorX, ARG_mirrorY };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_self,    MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_alphaX,  MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_betaX,   MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_deltaX,  MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_alphaY,  MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_betaY,   MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_deltaY,  MP_ARG_OBJ  | MP_ARG_REQUIRED, { .u_obj = mp_const_none } },
+        { MP_QSTR_mirrorX, MP_ARG_BOOL,                   { .u_bool = false        } },
+        { MP_QSTR_mirrorY, MP_ARG_BOOL,                   { .u_bool = false        } },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_touch_transform_obj_t *self = MP_OBJ_TO_PTR(args[ARG_self].u_obj);
+
+    self->alpha_x = TO_Q16(mp_obj_get_float_to_f(args[ARG_alphaX].u_obj));
+    self->beta_x = TO_Q16(mp_obj_get_float_to_f(args[ARG_betaX].u_obj));
+    self->delta_x = TO_Q16(mp_obj_get_float_to_f(args[ARG_deltaX].u_obj));
+    self->alpha_y = TO_Q16(mp_obj_get_float_to_f(args[ARG_alphaY].u_obj));
+    self->beta_y = TO_Q16(mp_obj_get_float_to_f(args[ARG_betaY].u_obj));
+    self->delta_y = TO_Q16(mp_obj_get_float_to_f(args[ARG_deltaY].u_obj));
+    self->mirror_x = args[ARG_mirrorX].u_bool;
+    self->mirror_y = args[ARG_mirrorY].u_bool;
+    self->calibrated = true;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(mp_touch_transform_set_calibration_obj, 7, mp_touch_transform_set_calibration);
+
+
+static mp_obj_t mp_touch_transform_clear_calibration(mp_obj_t self_in)
+{
+    mp_touch_transform_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->calibrated = false;
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_transform_clear_calibration_obj, mp_touch_transform_clear_calibration);
+
+
+static mp_obj_t mp_touch_transform_map(mp_obj_t self_in, mp_obj_t x_in, mp_obj_t y_in)
+{
+    mp_touch_transform_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    int32_t x = (int32_t)mp_obj_get_int(x_in);
+    int32_t y = (int32_t)mp_obj_get_int(y_in);
+
+    touch_transform_map(self, &x, &y);
+
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int(x),
+        mp_obj_new_int(y),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_3(mp_touch_transform_map_obj, mp_touch_transform_map);
+
+
+// maps a buffer of int16 (x, y) pairs in place, used for multi-touch
+// controllers that report all of the points at once
+static mp_obj_t mp_touch_transform_map_into(size_t n_args, const mp_obj_t *args)
+{
+    mp_touch_transform_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_RW);
+
+    size_t count = bufinfo.len / 4;
+
+    if (n_args == 3) {
+        size_t max_count = (size_t)mp_obj_get_int(args[2]);
+        if (max_count < count) count = max_count;
+    }
+
+    int16_t *points = (int16_t *)bufinfo.buf;
+    int32_t x;
+    int32_t y;
+
+    for (size_t i = 0; i < count; i++) {
+        x = points[i * 2];
+        y = points[(i * 2) + 1];
+
+        touch_transform_map(self, &x, &y);
+
+        points[i * 2] = (int16_t)x;
+        points[(i * 2) + 1] = (int16_t)y;
+    }
+
+    return mp_obj_new_int_from_uint(count);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_touch_transform_map_into_obj, 2, 3, mp_touch_transform_map_into);
+
+
+static mp_obj_t mp_touch_transform_is_calibrated(mp_obj_t self_in)
+{
+    mp_touch_transform_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(self->calibrated);
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_touch_transform_is_calibrated_obj, mp_touch_transform_is_calibrated);
+
+
+static const mp_rom_map_elem_t mp_touch_transform_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_set_calibration),    MP_ROM_PTR(&mp_touch_transform_set_calibration_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_clear_calibration),  MP_ROM_PTR(&mp_touch_transform_clear_calibration_obj) },
+    { MP_ROM_QSTR(MP_QSTR_is_calibrated),      MP_ROM_PTR(&mp_touch_transform_is_calibrated_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_map),                MP_ROM_PTR(&mp_touch_transform_map_obj)               },
+    { MP_ROM_QSTR(MP_QSTR_map_into),           MP_ROM_PTR(&mp_touch_transform_map_into_obj)          },
+};
+
+static MP_DEFINE_CONST_DICT(mp_touch_transform_locals_dict, mp_touch_transform_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_touch_transform_type,
+    MP_QSTR_TouchTransform,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_touch_transform_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_touch_transform_locals_dict
+);
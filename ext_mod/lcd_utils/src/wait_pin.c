@@ -0,0 +1,132 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/wait_pin.h"
+
+#include "mphalport.h"
+#include "py/obj.h"
+#include "py/runtime.h"
+
+
+static inline bool wait_pin_is_ready(mp_wait_pin_obj_t *self)
+{
+    return mp_obj_is_true(mp_call_function_0(self->value)) == (bool)self->state;
+}
+
+
+static bool wait_pin_io_is_ready(void *arg)
+{
+    return wait_pin_is_ready((mp_wait_pin_obj_t *)arg);
+}
+
+
+static uint32_t wait_pin_io_ticks_ms(void)
+{
+    return (uint32_t)mp_hal_ticks_ms();
+}
+
+
+static void wait_pin_io_sleep_ms(uint32_t ms)
+{
+    mp_event_wait_ms(ms);
+}
+
+
+static mp_obj_t mp_wait_pin_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum {
+        ARG_pin,
+        ARG_state
+    };
+
+    const mp_arg_t make_new_args[] = {
+        { MP_QSTR_pin,   MP_ARG_OBJ | MP_ARG_REQUIRED                 },
+        { MP_QSTR_state, MP_ARG_INT,                  { .u_int = 1 } },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(make_new_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args,
+                    MP_ARRAY_SIZE(make_new_args), make_new_args, args);
+
+    mp_wait_pin_obj_t *self = m_new_obj(mp_wait_pin_obj_t);
+    self->base.type = &mp_wait_pin_type;
+
+    // the bound method gets made here so the checks don't allocate
+    self->value = mp_load_attr(args[ARG_pin].u_obj, MP_QSTR_value);
+    self->state = args[ARG_state].u_int ? 1 : 0;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+
+/* irq(pin)
+ * Handler for the wait pin's interrupt, safe to use as a hard IRQ. It doesn't
+ * do anything, the interrupt itself is what wakes up wait() so it doesn't sit
+ * out the rest of its sleep. Nothing gets scheduled from here, wait() is
+ * mostly called from inside of lv.task_handler which is already running from
+ * the scheduler.
+ */
+static mp_obj_t mp_wait_pin_irq(mp_obj_t self_in, mp_obj_t pin_in)
+{
+    (void)self_in;
+    (void)pin_in;
+
+    return mp_const_none;
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_2(mp_wait_pin_irq_obj, mp_wait_pin_irq);
+
+
+static mp_obj_t mp_wait_pin_ready(mp_obj_t self_in)
+{
+    mp_wait_pin_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(wait_pin_is_ready(self));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_1(mp_wait_pin_ready_obj, mp_wait_pin_ready);
+
+
+/* wait(timeout=100)
+ * Blocks until the controller is ready or timeout milliseconds have gone by,
+ * a negative timeout waits forever. In between the checks the scheduler and
+ * pending callbacks get run and the port is allowed to sleep until the next
+ * event, so an interrupt on the wait pin ends the wait right away.
+ *
+ * Returns False if it timed out.
+ */
+static mp_obj_t mp_wait_pin_wait(size_t n_args, const mp_obj_t *args)
+{
+    mp_wait_pin_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t timeout = n_args == 2 ? mp_obj_get_int(args[1]) : 100;
+
+    if (timeout < 0) timeout = -1;
+    else if (timeout > INT32_MAX) timeout = INT32_MAX;
+
+    const wait_pin_io_t io = {
+        .is_ready = wait_pin_io_is_ready,
+        .ticks_ms = wait_pin_io_ticks_ms,
+        .sleep_ms = wait_pin_io_sleep_ms,
+        .arg = self,
+    };
+
+    return mp_obj_new_bool(wait_pin_run(&io, (int32_t)timeout));
+}
+
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_wait_pin_wait_obj, 1, 2, mp_wait_pin_wait);
+
+
+static const mp_rom_map_elem_t mp_wait_pin_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_irq),   MP_ROM_PTR(&mp_wait_pin_irq_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_ready), MP_ROM_PTR(&mp_wait_pin_ready_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait),  MP_ROM_PTR(&mp_wait_pin_wait_obj)  },
+};
+
+static MP_DEFINE_CONST_DICT(mp_wait_pin_locals_dict, mp_wait_pin_locals_dict_table);
+
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_wait_pin_type,
+    MP_QSTR_WaitPin,
+    MP_TYPE_FLAG_NONE,
+    make_new, mp_wait_pin_make_new,
+    locals_dict, (mp_obj_dict_t *)&mp_wait_pin_locals_dict
+);
@@ -0,0 +1,20 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+#include "../include/wait_pin_engine.h"
+
+
+/* The pin gets checked before anything else so a controller that is already
+ * ready costs a single read. After that the loop sleeps 1 millisecond at a
+ * time, the sleep is where an interrupt on the wait pin cuts in.
+ */
+bool wait_pin_run(const wait_pin_io_t *io, int32_t timeout)
+{
+    uint32_t start = io->ticks_ms();
+
+    while (!io->is_ready(io->arg)) {
+        if (timeout >= 0 && (io->ticks_ms() - start) >= (uint32_t)timeout) return false;
+        io->sleep_ms(1);
+    }
+
+    return true;
+}
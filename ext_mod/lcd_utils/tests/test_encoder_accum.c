@@ -0,0 +1,238 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host tests for the encoder accumulator, run with "make -C ext_mod/lcd_utils/tests"
+
+#include <math.h>
+#include <stdio.h>
+
+#include "../include/encoder_accum_engine.h"
+
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(value, expected, tolerance) CHECK(fabs((double)(value) - (double)(expected)) <= (tolerance))
+
+
+// Gray code order of (A << 1) | B for a positive count, A leads B
+static const uint8_t fwd[4] = { 0x00, 0x02, 0x03, 0x01 };
+
+
+static void turn(encoder_accum_t *enc, int32_t edges)
+{
+    // where in the cycle the pins are now
+    uint8_t pos = 0;
+    while (fwd[pos] != enc->last_ab) pos++;
+
+    for (; edges > 0; edges--) {
+        pos = (pos + 1) & 0x03;
+        encoder_accum_step(enc, fwd[pos]);
+    }
+
+    for (; edges < 0; edges++) {
+        pos = (pos + 3) & 0x03;
+        encoder_accum_step(enc, fwd[pos]);
+    }
+}
+
+
+static void test_quadrature(void)
+{
+    encoder_accum_t enc;
+
+    // every valid transition is one edge in the right direction
+    for (uint8_t i = 0; i < 4; i++) {
+        encoder_accum_init(&enc, 4, fwd[i], 0);
+        encoder_accum_step(&enc, fwd[(i + 1) & 0x03]);
+        CHECK(enc.count == 1);
+
+        encoder_accum_init(&enc, 4, fwd[i], 0);
+        encoder_accum_step(&enc, fwd[(i + 3) & 0x03]);
+        CHECK(enc.count == -1);
+
+        // no change
+        encoder_accum_init(&enc, 4, fwd[i], 0);
+        encoder_accum_step(&enc, fwd[i]);
+        CHECK(enc.count == 0);
+
+        // both pins changed, an edge was missed and the direction can't be
+        // told, it doesn't count but the new level is kept
+        encoder_accum_init(&enc, 4, fwd[i], 0);
+        encoder_accum_step(&enc, fwd[(i + 2) & 0x03]);
+        CHECK(enc.count == 0);
+        CHECK(enc.last_ab == fwd[(i + 2) & 0x03]);
+    }
+
+    // contact bounce on one pin goes back and forth and adds up to nothing
+    encoder_accum_init(&enc, 4, 0x00, 0);
+    for (uint8_t i = 0; i < 5; i++) {
+        encoder_accum_step(&enc, 0x02);
+        encoder_accum_step(&enc, 0x00);
+    }
+    CHECK(enc.count == 0);
+
+    encoder_accum_init(&enc, 4, 0x00, 0);
+    turn(&enc, 10);
+    turn(&enc, -3);
+    CHECK(enc.count == 7);
+}
+
+
+static void test_detent_carry(void)
+{
+    encoder_accum_t enc;
+    encoder_accum_init(&enc, 4, 0x00, 0);
+
+    // 3 edges are not a detent yet, they stay for the next read
+    turn(&enc, 3);
+    CHECK(encoder_accum_read(&enc, 10) == 0);
+
+    turn(&enc, 1);
+    CHECK(encoder_accum_read(&enc, 20) == 1);
+
+    // 9 edges are 2 detents and 1 edge left over
+    turn(&enc, 9);
+    CHECK(encoder_accum_read(&enc, 30) == 2);
+    turn(&enc, 3);
+    CHECK(encoder_accum_read(&enc, 40) == 1);
+
+    // the same going the other way
+    turn(&enc, -6);
+    CHECK(encoder_accum_read(&enc, 50) == -1);
+    turn(&enc, -2);
+    CHECK(encoder_accum_read(&enc, 60) == -1);
+
+    // edges from a hardware counter
+    encoder_accum_add(&enc, 8);
+    CHECK(encoder_accum_read(&enc, 70) == 2);
+
+    // reset drops the part of a detent that was left over
+    turn(&enc, 3);
+    encoder_accum_reset(&enc, 80);
+    turn(&enc, 1);
+    CHECK(encoder_accum_read(&enc, 90) == 0);
+
+    // 1 edge per detent
+    encoder_accum_init(&enc, 1, 0x00, 0);
+    turn(&enc, -5);
+    CHECK(encoder_accum_read(&enc, 10) == -5);
+}
+
+
+static void test_curve(void)
+{
+    encoder_accum_t enc;
+    encoder_accum_init(&enc, 1, 0x00, 0);
+
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 100.0f), 1.0f, 1e-6);
+
+    const encoder_curve_point_t curve[3] = {
+        { 10.0f, 1.0f },
+        { 20.0f, 3.0f },
+        { 40.0f, 5.0f },
+    };
+
+    CHECK(encoder_accum_set_curve(&enc, curve, 3) == ENCODER_CURVE_OK);
+
+    // flat past both ends, linear in between
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 0.0f), 1.0f, 1e-6);
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 10.0f), 1.0f, 1e-6);
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 15.0f), 2.0f, 1e-6);
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 20.0f), 3.0f, 1e-6);
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 35.0f), 4.5f, 1e-6);
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 40.0f), 5.0f, 1e-6);
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 400.0f), 5.0f, 1e-6);
+
+    // 3 detents in 100 ms is 30 per second, x4
+    turn(&enc, 3);
+    CHECK(encoder_accum_read(&enc, 100) == 12);
+
+    // a slow turn never goes under 1 step per detent
+    turn(&enc, 1);
+    CHECK(encoder_accum_read(&enc, 1100) == 1);
+
+    const encoder_curve_point_t bad[2] = {
+        { 20.0f, 1.0f },
+        { 20.0f, 3.0f },
+    };
+
+    CHECK(encoder_accum_set_curve(&enc, bad, 2) == ENCODER_CURVE_NOT_ASCENDING);
+    CHECK(encoder_accum_set_curve(&enc, curve, ENCODER_CURVE_MAX_POINTS + 1) == ENCODER_CURVE_TOO_LONG);
+
+    // the curve that was set before is kept
+    CHECK(enc.curve_len == 3);
+    CHECK_NEAR(encoder_accum_multiplier(&enc, 15.0f), 2.0f, 1e-6);
+
+    CHECK(encoder_accum_set_curve(&enc, NULL, 0) == ENCODER_CURVE_OK);
+    turn(&enc, 3);
+    CHECK(encoder_accum_read(&enc, 1200) == 3);
+}
+
+
+static void test_remainder(void)
+{
+    encoder_accum_t enc;
+    encoder_accum_init(&enc, 1, 0x00, 0);
+
+    const encoder_curve_point_t curve[1] = {
+        { 0.0f, 1.5f },
+    };
+
+    CHECK(encoder_accum_set_curve(&enc, curve, 1) == ENCODER_CURVE_OK);
+
+    // 1.5 per detent, the half steps add up over the reads
+    turn(&enc, 1);
+    CHECK(encoder_accum_read(&enc, 100) == 1);
+    CHECK_NEAR(enc.remainder, 0.5f, 1e-6);
+
+    turn(&enc, 1);
+    CHECK(encoder_accum_read(&enc, 200) == 2);
+    CHECK_NEAR(enc.remainder, 0.0f, 1e-6);
+
+    turn(&enc, 1);
+    CHECK(encoder_accum_read(&enc, 300) == 1);
+
+    // turning back drops what was left over instead of taking it off of
+    // the first step the other way
+    turn(&enc, -1);
+    CHECK(encoder_accum_read(&enc, 400) == -1);
+    CHECK_NEAR(enc.remainder, -0.5f, 1e-6);
+
+    turn(&enc, -1);
+    CHECK(encoder_accum_read(&enc, 500) == -2);
+
+    turn(&enc, -1);
+    CHECK(encoder_accum_read(&enc, 600) == -1);
+    CHECK_NEAR(enc.remainder, -0.5f, 1e-6);
+
+    turn(&enc, 1);
+    CHECK(encoder_accum_read(&enc, 700) == 1);
+    CHECK_NEAR(enc.remainder, 0.5f, 1e-6);
+
+    // reset clears it
+    encoder_accum_reset(&enc, 800);
+    CHECK_NEAR(enc.remainder, 0.0f, 1e-6);
+}
+
+
+int main(void)
+{
+    test_quadrature();
+    test_detent_carry();
+    test_curve();
+    test_remainder();
+
+    if (failures) {
+        printf("test_encoder_accum: %d failed\n", failures);
+        return 1;
+    }
+
+    printf("test_encoder_accum: ok\n");
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host tests for the key matrix engine, run with "make -C ext_mod/lcd_utils/tests"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/key_matrix_engine.h"
+
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+
+#define ROWS  (4)
+#define COLS  (4)
+
+static uint32_t codes[ROWS * COLS];
+
+
+static void make_matrix(key_matrix_t *km, uint32_t debounce_ms, bool ghost, uint32_t repeat_delay, uint32_t repeat_period)
+{
+    memset(km, 0, sizeof(key_matrix_t));
+
+    // 'a' is row 0 column 0, 'b' row 0 column 1 and so on
+    for (uint8_t i = 0; i < ROWS * COLS; i++) codes[i] = 'a' + i;
+
+    km->rows = ROWS;
+    km->cols = COLS;
+    km->codes = codes;
+    km->ghost = ghost;
+    km->debounce_ms = debounce_ms;
+    km->repeat_key = -1;
+    km->repeat_delay = repeat_delay;
+    km->repeat_period = repeat_period;
+}
+
+
+static void scan(key_matrix_t *km, uint32_t row0, uint32_t row1, uint32_t row2, uint32_t row3, uint32_t now_ms)
+{
+    uint32_t keys[ROWS] = { row0, row1, row2, row3 };
+    key_matrix_update(km, keys, now_ms);
+}
+
+
+static bool pop(key_matrix_t *km, uint8_t state, uint32_t code)
+{
+    key_matrix_event_t event;
+
+    if (!key_matrix_pop(km, &event)) return false;
+
+    return event.state == state && event.code == code;
+}
+
+
+static void test_debounce(void)
+{
+    key_matrix_t km;
+    make_matrix(&km, 20, false, 0, 100);
+
+    // bouncing contacts, every change starts the debounce time over
+    scan(&km, 0x1, 0, 0, 0, 0);
+    scan(&km, 0x0, 0, 0, 0, 5);
+    scan(&km, 0x1, 0, 0, 0, 10);
+    scan(&km, 0x1, 0, 0, 0, 25);
+    CHECK(key_matrix_queued(&km) == 0);
+
+    scan(&km, 0x1, 0, 0, 0, 30);
+    CHECK(key_matrix_queued(&km) == 1);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'a'));
+
+    // still held, nothing new
+    scan(&km, 0x1, 0, 0, 0, 100);
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // a glitch shorter than the debounce time is ignored
+    scan(&km, 0x0, 0, 0, 0, 110);
+    scan(&km, 0x1, 0, 0, 0, 115);
+    scan(&km, 0x1, 0, 0, 0, 200);
+    CHECK(key_matrix_queued(&km) == 0);
+
+    scan(&km, 0x0, 0, 0, 0, 300);
+    scan(&km, 0x0, 0, 0, 0, 320);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'a'));
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // rows are debounced on their own
+    scan(&km, 0x2, 0, 0, 0, 400);
+    scan(&km, 0x2, 0, 0, 0x4, 410);
+    scan(&km, 0x2, 0, 0, 0x4, 420);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'b'));
+    CHECK(key_matrix_queued(&km) == 0);
+    scan(&km, 0x2, 0, 0, 0x4, 430);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'o'));
+}
+
+
+static void test_ghost(void)
+{
+    key_matrix_t km;
+    make_matrix(&km, 0, true, 0, 100);
+
+    // 'a' and 'b' on row 0 and 'e' on row 1. 'f' (row 1, column 1) reads
+    // as pressed as well
+    scan(&km, 0x3, 0, 0, 0, 0);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'a'));
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'b'));
+
+    scan(&km, 0x3, 0x3, 0, 0, 10);
+    CHECK(key_matrix_queued(&km) == 0);
+    CHECK(km.stable[1] == 0);
+
+    // 'f' let go, it was a ghost after all and row 1 goes through
+    scan(&km, 0x3, 0x1, 0, 0, 20);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'e'));
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // 'b' let go and 'f' pressed, row 1 has 'e' and 'f' down and shares
+    // them both with row 0 until that scan shows 'b' is up
+    scan(&km, 0x3, 0x3, 0, 0, 30);
+    CHECK(key_matrix_queued(&km) == 0);
+
+    scan(&km, 0x1, 0x3, 0, 0, 40);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'b'));
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'f'));
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // 2 keys in one column don't ghost
+    scan(&km, 0x1, 0x3, 0x1, 0, 50);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'i'));
+
+    // a matrix with diodes takes the rectangle as it is
+    make_matrix(&km, 0, false, 0, 100);
+    scan(&km, 0x3, 0x3, 0, 0, 0);
+    CHECK(key_matrix_queued(&km) == 4);
+}
+
+
+static void test_release_before_press(void)
+{
+    key_matrix_t km;
+    make_matrix(&km, 0, false, 0, 100);
+
+    scan(&km, 0x8, 0, 0, 0, 0);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'd'));
+
+    // a roll over from 'd' to 'a' in one scan, the release of 'd' comes
+    // first even though 'a' is the lower column
+    scan(&km, 0x1, 0, 0, 0, 10);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'd'));
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'a'));
+
+    // across rows each row keeps that order
+    scan(&km, 0x2, 0x1, 0, 0, 20);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'a'));
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'b'));
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'e'));
+
+    // a full queue drops the oldest events
+    make_matrix(&km, 0, false, 0, 100);
+    for (uint32_t i = 0; i < KEY_MATRIX_QUEUE_LEN; i++) {
+        scan(&km, 0x1, 0, 0, 0, i * 2);
+        scan(&km, 0x0, 0, 0, 0, i * 2 + 1);
+    }
+    scan(&km, 0x2, 0, 0, 0, 1000);
+
+    CHECK(key_matrix_queued(&km) == KEY_MATRIX_QUEUE_LEN);
+
+    key_matrix_event_t event;
+    for (uint32_t i = 0; i < KEY_MATRIX_QUEUE_LEN - 1; i++) key_matrix_pop(&km, &event);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'b'));
+    CHECK(!key_matrix_pop(&km, &event));
+}
+
+
+static void test_repeat(void)
+{
+    key_matrix_t km;
+    make_matrix(&km, 0, false, 500, 100);
+
+    scan(&km, 0x1, 0, 0, 0, 0);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'a'));
+
+    scan(&km, 0x1, 0, 0, 0, 499);
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // a repeat is a release and a press
+    scan(&km, 0x1, 0, 0, 0, 500);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'a'));
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'a'));
+
+    scan(&km, 0x1, 0, 0, 0, 550);
+    CHECK(key_matrix_queued(&km) == 0);
+    scan(&km, 0x1, 0, 0, 0, 600);
+    CHECK(key_matrix_queued(&km) == 2);
+    key_matrix_clear(&km);
+
+    // clear() stops it
+    scan(&km, 0x1, 0, 0, 0, 1000);
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // the last key pressed is the one that repeats
+    scan(&km, 0x0, 0, 0, 0, 1100);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'a'));
+    scan(&km, 0x1, 0, 0, 0, 1200);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'a'));
+    scan(&km, 0x1, 0x2, 0, 0, 1300);
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'f'));
+
+    scan(&km, 0x1, 0x2, 0, 0, 1799);
+    CHECK(key_matrix_queued(&km) == 0);
+    scan(&km, 0x1, 0x2, 0, 0, 1800);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'f'));
+    CHECK(pop(&km, KEY_MATRIX_PRESSED, 'f'));
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // releasing it stops the repeat even with another key still down
+    scan(&km, 0x1, 0x0, 0, 0, 2050);
+    CHECK(pop(&km, KEY_MATRIX_RELEASED, 'f'));
+    scan(&km, 0x1, 0x0, 0, 0, 3000);
+    CHECK(key_matrix_queued(&km) == 0);
+
+    // repeat_delay 0 turns it off
+    make_matrix(&km, 0, false, 0, 100);
+    scan(&km, 0x1, 0, 0, 0, 0);
+    scan(&km, 0x1, 0, 0, 0, 10000);
+    CHECK(key_matrix_queued(&km) == 1);
+}
+
+
+int main(void)
+{
+    test_debounce();
+    test_ghost();
+    test_release_before_press();
+    test_repeat();
+
+    if (failures) {
+        printf("test_key_matrix: %d failed\n", failures);
+        return 1;
+    }
+
+    printf("test_key_matrix: ok\n");
+    return 0;
+}
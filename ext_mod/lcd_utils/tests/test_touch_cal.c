@@ -0,0 +1,234 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host tests for the touch calibration solver, run with "make -C ext_mod/lcd_utils/tests"
+
+#include <math.h>
+#include <stdio.h>
+
+#include "../include/touch_cal_engine.h"
+
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(value, expected, tolerance) CHECK(fabs((double)(value) - (double)(expected)) <= (tolerance))
+
+
+static uint32_t noise_state = 1;
+
+static double noise(double amplitude)
+{
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return ((double)(noise_state >> 8) / 8388608.0 - 1.0) * amplitude;
+}
+
+
+// a 320 x 240 display with swapped and mirrored axes on a 12 bit controller
+static const touch_cal_fit_t panel = {
+    .alpha_x = 0.0,
+    .beta_x = -1.0 / 11.5,
+    .delta_x = 3900.0 / 11.5,
+    .alpha_y = 1.0 / 15.0,
+    .beta_y = 0.0,
+    .delta_y = -200.0 / 15.0,
+};
+
+
+// raw point the panel above reports for a screen point
+static void to_raw(double scr_x, double scr_y, double *raw_x, double *raw_y)
+{
+    *raw_x = 200.0 + scr_y * 15.0;
+    *raw_y = 3900.0 - scr_x * 11.5;
+}
+
+
+// the 3 x 3 grid touch_calibrate.py collects
+static size_t make_grid(double *raw_x, double *raw_y, double *scr_x, double *scr_y, double jitter)
+{
+    static const double xs[3] = { 30.0, 160.0, 290.0 };
+    static const double ys[3] = { 30.0, 120.0, 210.0 };
+    size_t n = 0;
+
+    for (uint8_t j = 0; j < 3; j++) {
+        for (uint8_t i = 0; i < 3; i++) {
+            scr_x[n] = xs[i];
+            scr_y[n] = ys[j];
+            to_raw(xs[i], ys[j], &raw_x[n], &raw_y[n]);
+            raw_x[n] += noise(jitter);
+            raw_y[n] += noise(jitter);
+            n++;
+        }
+    }
+
+    return n;
+}
+
+
+static void check_fit(const touch_cal_fit_t *fit, double tolerance)
+{
+    // compared where it matters, on the screen
+    for (double x = 0.0; x <= 320.0; x += 80.0) {
+        for (double y = 0.0; y <= 240.0; y += 60.0) {
+            double raw_x;
+            double raw_y;
+
+            to_raw(x, y, &raw_x, &raw_y);
+            CHECK(touch_cal_residual(fit, raw_x, raw_y, x, y) <= tolerance);
+        }
+    }
+}
+
+
+static void test_exact_3_points(void)
+{
+    double scr_x[3] = { 30.0, 290.0, 30.0 };
+    double scr_y[3] = { 30.0, 30.0, 210.0 };
+    double raw_x[3];
+    double raw_y[3];
+    bool used[3];
+    touch_cal_fit_t fit;
+    double rms;
+
+    for (uint8_t i = 0; i < 3; i++) to_raw(scr_x[i], scr_y[i], &raw_x[i], &raw_y[i]);
+
+    CHECK(touch_cal_solve(raw_x, raw_y, scr_x, scr_y, 3, 4.0, used, &fit, &rms) == TOUCH_CAL_OK);
+    CHECK_NEAR(fit.alpha_x, panel.alpha_x, 1e-9);
+    CHECK_NEAR(fit.beta_x, panel.beta_x, 1e-9);
+    CHECK_NEAR(fit.delta_x, panel.delta_x, 1e-6);
+    CHECK_NEAR(fit.alpha_y, panel.alpha_y, 1e-9);
+    CHECK_NEAR(fit.beta_y, panel.beta_y, 1e-9);
+    CHECK_NEAR(fit.delta_y, panel.delta_y, 1e-6);
+    CHECK_NEAR(rms, 0.0, 1e-6);
+    CHECK(used[0] && used[1] && used[2]);
+}
+
+
+static void test_noisy_grid(void)
+{
+    double raw_x[9];
+    double raw_y[9];
+    double scr_x[9];
+    double scr_y[9];
+    bool used[9];
+    touch_cal_fit_t fit;
+    double rms;
+
+    // +-40 raw counts is about 3 pixels
+    size_t n = make_grid(raw_x, raw_y, scr_x, scr_y, 40.0);
+
+    CHECK(touch_cal_solve(raw_x, raw_y, scr_x, scr_y, n, 4.0, used, &fit, &rms) == TOUCH_CAL_OK);
+    CHECK(rms > 0.5 && rms < 4.0);
+    check_fit(&fit, 4.0);
+
+    for (size_t i = 0; i < n; i++) CHECK(used[i]);
+}
+
+
+static void test_outlier(void)
+{
+    double raw_x[9];
+    double raw_y[9];
+    double scr_x[9];
+    double scr_y[9];
+    bool used[9];
+    touch_cal_fit_t fit;
+    double rms;
+
+    // every point of the grid gets to be the bad one, corners, edges and
+    // the center have different pull on the fit
+    for (size_t bad = 0; bad < 9; bad++) {
+        size_t n = make_grid(raw_x, raw_y, scr_x, scr_y, 15.0);
+
+        raw_x[bad] += 400.0;
+        raw_y[bad] -= 300.0;
+
+        CHECK(touch_cal_solve(raw_x, raw_y, scr_x, scr_y, n, 4.0, used, &fit, &rms) == TOUCH_CAL_OK);
+
+        for (size_t i = 0; i < n; i++) CHECK(used[i] == (i != bad));
+
+        CHECK(rms < 2.0);
+        check_fit(&fit, 2.0);
+
+        // without rejection the bad point stays in and drags the fit
+        CHECK(touch_cal_solve(raw_x, raw_y, scr_x, scr_y, n, 0.0, used, &fit, &rms) == TOUCH_CAL_OK);
+        for (size_t i = 0; i < n; i++) CHECK(used[i]);
+        CHECK(rms > 5.0);
+    }
+}
+
+
+static void test_collinear(void)
+{
+    double raw_x[4] = { 100.0, 200.0, 300.0, 400.0 };
+    double raw_y[4] = { 500.0, 600.0, 700.0, 800.0 };
+    double scr_x[4] = { 10.0, 20.0, 30.0, 40.0 };
+    double scr_y[4] = { 10.0, 20.0, 30.0, 40.0 };
+    bool used[4];
+    touch_cal_fit_t fit;
+    double rms;
+
+    CHECK(touch_cal_solve(raw_x, raw_y, scr_x, scr_y, 4, 4.0, used, &fit, &rms) == TOUCH_CAL_COLLINEAR);
+
+    // all on top of each other
+    double same[3] = { 100.0, 100.0, 100.0 };
+    CHECK(touch_cal_solve(same, same, scr_x, scr_y, 3, 4.0, used, &fit, &rms) == TOUCH_CAL_COLLINEAR);
+
+    CHECK(touch_cal_solve(raw_x, raw_y, scr_x, scr_y, 2, 4.0, used, &fit, &rms) == TOUCH_CAL_TOO_FEW);
+}
+
+
+static void test_degenerate_after_drop(void)
+{
+    // 4 points on the diagonal and the 2 other corners, both of them bad.
+    // Once one of the corners is dropped the other one is all that keeps
+    // the points off of a line. It can't be checked, it has to stay and
+    // the fit still has to come out.
+    double scr_x[6] = { 30.0, 95.0, 160.0, 290.0, 290.0, 30.0 };
+    double scr_y[6] = { 30.0, 75.0, 120.0, 210.0, 30.0, 210.0 };
+    double raw_x[6];
+    double raw_y[6];
+    bool used[6];
+    touch_cal_fit_t fit;
+    double rms;
+
+    for (uint8_t i = 0; i < 6; i++) {
+        to_raw(scr_x[i], scr_y[i], &raw_x[i], &raw_y[i]);
+        raw_x[i] += noise(15.0);
+        raw_y[i] += noise(15.0);
+    }
+
+    raw_x[4] += 400.0;
+    raw_y[4] -= 300.0;
+    raw_x[5] -= 300.0;
+    raw_y[5] += 400.0;
+
+    CHECK(touch_cal_solve(raw_x, raw_y, scr_x, scr_y, 6, 4.0, used, &fit, &rms) == TOUCH_CAL_OK);
+    CHECK(used[0] && used[1] && used[2] && used[3]);
+    CHECK(used[4] != used[5]);
+    CHECK(isfinite(fit.alpha_x) && isfinite(fit.beta_x) && isfinite(fit.delta_x));
+    CHECK(isfinite(fit.alpha_y) && isfinite(fit.beta_y) && isfinite(fit.delta_y));
+}
+
+
+int main(void)
+{
+    test_exact_3_points();
+    test_noisy_grid();
+    test_outlier();
+    test_collinear();
+    test_degenerate_after_drop();
+
+    if (failures) {
+        printf("test_touch_cal: %d failed\n", failures);
+        return 1;
+    }
+
+    printf("test_touch_cal: ok\n");
+    return 0;
+}
@@ -0,0 +1,238 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host tests for the touch filter engine, run with "make -C ext_mod/lcd_utils/tests"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/touch_filter_engine.h"
+
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+
+static touch_filter_t make_filter(uint8_t trim, uint32_t margin, uint8_t smoothing)
+{
+    touch_filter_t filter;
+
+    filter.min_raw = 0;
+    filter.max_raw = 0xFFFF;
+    filter.trim = trim;
+    filter.smoothing = smoothing;
+    filter.margin_sq = margin * margin;
+    touch_filter_reset(&filter);
+
+    return filter;
+}
+
+
+static void test_trimmed_mean(void)
+{
+    touch_filter_t filter = make_filter(1, 50, 0);
+    uint16_t xs[] = { 1000, 1010, 990, 1005, 995 };
+    uint16_t ys[] = { 2000, 2002, 1998, 2001, 1999 };
+    uint16_t x, y;
+
+    CHECK(touch_filter_run(&filter, xs, ys, 5, &x, &y));
+    CHECK(x == 1000);
+    CHECK(y == 2000);
+}
+
+
+static void test_median(void)
+{
+    // a large trim leaves the median, one wild sample doesn't move it
+    touch_filter_t filter = make_filter(255, 0xFFFF, 0);
+    uint16_t xs[] = { 500, 501, 4000, 502, 499 };
+    uint16_t ys[] = { 600, 601, 602, 50, 599 };
+    uint16_t x, y;
+
+    CHECK(touch_filter_run(&filter, xs, ys, 5, &x, &y));
+    CHECK(x == 501);
+    CHECK(y == 600);
+}
+
+
+static void test_range_gate(void)
+{
+    touch_filter_t filter = make_filter(0, 50, 0);
+    uint16_t xs[] = { 0, 0, 0, 1000 };
+    uint16_t ys[] = { 1000, 1000, 1000, 1000 };
+    uint16_t x, y;
+
+    filter.min_raw = 100;
+    filter.max_raw = 4000;
+
+    // less than half of the samples are in range
+    CHECK(!touch_filter_run(&filter, xs, ys, 4, &x, &y));
+
+    uint16_t xs2[] = { 0, 1000, 1002, 998 };
+    uint16_t ys2[] = { 1000, 1000, 1000, 1000 };
+
+    CHECK(touch_filter_run(&filter, xs2, ys2, 4, &x, &y));
+    CHECK(x == 1000);
+}
+
+
+static void test_deviation_reject(void)
+{
+    touch_filter_t filter = make_filter(0, 20, 0);
+    uint16_t xs[] = { 1000, 1100, 900, 1000 };
+    uint16_t ys[] = { 1000, 1000, 1000, 1000 };
+    uint16_t x, y;
+
+    CHECK(!touch_filter_run(&filter, xs, ys, 4, &x, &y));
+
+    uint16_t xs2[] = { 1000, 1010, 990, 1000 };
+    uint16_t ys2[] = { 1000, 1000, 1000, 1000 };
+
+    CHECK(touch_filter_run(&filter, xs2, ys2, 4, &x, &y));
+}
+
+
+static void test_deviation_wide_spread(void)
+{
+    // 32 samples 8192 either side of the mean on both axes add up to exactly
+    // 2^32, in 32 bits that wraps around to 0 and the spread would pass. It
+    // has to be rejected
+    touch_filter_t filter = make_filter(0, 1000, 0);
+    uint16_t xs[TOUCH_FILTER_MAX_SAMPLES];
+    uint16_t ys[TOUCH_FILTER_MAX_SAMPLES];
+    uint16_t x, y;
+
+    for (size_t i = 0; i < TOUCH_FILTER_MAX_SAMPLES; i++) {
+        xs[i] = (i & 1) ? 32768 + 8192 : 32768 - 8192;
+        ys[i] = (i & 1) ? 32768 - 8192 : 32768 + 8192;
+    }
+
+    CHECK(!touch_filter_run(&filter, xs, ys, TOUCH_FILTER_MAX_SAMPLES, &x, &y));
+
+    // samples at both ends of the 16 bit range with the margin opened all
+    // the way, the mean still has to come out right
+    filter.margin_sq = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < TOUCH_FILTER_MAX_SAMPLES; i++) {
+        xs[i] = (i & 1) ? 0xFFFE : 1;
+        ys[i] = (i & 1) ? 1 : 0xFFFE;
+    }
+
+    CHECK(touch_filter_run(&filter, xs, ys, TOUCH_FILTER_MAX_SAMPLES, &x, &y));
+    CHECK(x == 0x8000);
+    CHECK(y == 0x8000);
+}
+
+
+static void test_smoothing(void)
+{
+    touch_filter_t filter = make_filter(0, 50, 128);
+    uint16_t x, y;
+
+    uint16_t xs[] = { 1000, 1000 };
+    uint16_t ys[] = { 1000, 1000 };
+    CHECK(touch_filter_run(&filter, xs, ys, 2, &x, &y));
+    CHECK(x == 1000);  // nothing to smooth against yet
+
+    uint16_t xs2[] = { 1100, 1100 };
+    uint16_t ys2[] = { 1000, 1000 };
+    CHECK(touch_filter_run(&filter, xs2, ys2, 2, &x, &y));
+    CHECK(x == 1050);
+    CHECK(y == 1000);
+
+    touch_filter_reset(&filter);
+
+    uint16_t xs3[] = { 1100, 1100 };
+    uint16_t ys3[] = { 1000, 1000 };
+    CHECK(touch_filter_run(&filter, xs3, ys3, 2, &x, &y));
+    CHECK(x == 1100);
+}
+
+
+static void test_decode_xpt2046(void)
+{
+    // 12 bit results are in bits 14 - 3 of the 2 bytes after the command
+    uint8_t buf[12] = {
+        0x90, (uint8_t)((1234 << 3) >> 8), (uint8_t)(1234 << 3),
+        0xD0, (uint8_t)((3210 << 3) >> 8), (uint8_t)(3210 << 3),
+        0x90, (uint8_t)((4095 << 3) >> 8), (uint8_t)(4095 << 3),
+        0xD0, 0x00, 0x08
+    };
+    uint16_t xs[TOUCH_FILTER_MAX_SAMPLES];
+    uint16_t ys[TOUCH_FILTER_MAX_SAMPLES];
+
+    CHECK(touch_filter_decode(TOUCH_FILTER_FORMAT_XPT2046, buf, sizeof(buf), xs, ys) == 2);
+    CHECK(xs[0] == 1234);
+    CHECK(ys[0] == 3210);
+    CHECK(xs[1] == 4095);
+    CHECK(ys[1] == 1);
+}
+
+
+static void test_decode_stmpe610(void)
+{
+    // 12 bit x, 12 bit y, 8 bit z
+    uint8_t buf[8] = { 0xAB, 0xCD, 0xEF, 0x10, 0x01, 0x20, 0x03, 0x40 };
+    uint16_t xs[TOUCH_FILTER_MAX_SAMPLES];
+    uint16_t ys[TOUCH_FILTER_MAX_SAMPLES];
+
+    CHECK(touch_filter_decode(TOUCH_FILTER_FORMAT_STMPE610, buf, sizeof(buf), xs, ys) == 2);
+    CHECK(xs[0] == 0xABC);
+    CHECK(ys[0] == 0xDEF);
+    CHECK(xs[1] == 0x012);
+    CHECK(ys[1] == 0x003);
+}
+
+
+static void test_decode_xy16(void)
+{
+    uint16_t samples[4] = { 100, 200, 300, 400 };
+    uint16_t xs[TOUCH_FILTER_MAX_SAMPLES];
+    uint16_t ys[TOUCH_FILTER_MAX_SAMPLES];
+
+    // a trailing partial sample gets ignored
+    CHECK(touch_filter_decode(TOUCH_FILTER_FORMAT_XY16, (const uint8_t *)samples, sizeof(samples) - 1, xs, ys) == 1);
+    CHECK(touch_filter_decode(TOUCH_FILTER_FORMAT_XY16, (const uint8_t *)samples, sizeof(samples), xs, ys) == 2);
+    CHECK(xs[1] == 300);
+    CHECK(ys[1] == 400);
+}
+
+
+static void test_decode_limit(void)
+{
+    uint8_t buf[(TOUCH_FILTER_MAX_SAMPLES + 4) * 4];
+    uint16_t xs[TOUCH_FILTER_MAX_SAMPLES];
+    uint16_t ys[TOUCH_FILTER_MAX_SAMPLES];
+
+    memset(buf, 0, sizeof(buf));
+
+    CHECK(touch_filter_decode(TOUCH_FILTER_FORMAT_STMPE610, buf, sizeof(buf), xs, ys) == TOUCH_FILTER_MAX_SAMPLES);
+}
+
+
+int main(void)
+{
+    test_trimmed_mean();
+    test_median();
+    test_range_gate();
+    test_deviation_reject();
+    test_deviation_wide_spread();
+    test_smoothing();
+    test_decode_xpt2046();
+    test_decode_stmpe610();
+    test_decode_xy16();
+    test_decode_limit();
+
+    if (failures) {
+        printf("test_touch_filter: %d failed\n", failures);
+        return 1;
+    }
+
+    printf("test_touch_filter: ok\n");
+    return 0;
+}
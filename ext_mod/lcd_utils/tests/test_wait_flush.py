@@ -0,0 +1,259 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+# Host tests for how the RA8876 and LT7381 drivers use lcd_utils.WaitPin to
+# hold back a flush, run with "make -C ext_mod/lcd_utils/tests"
+#
+# The drivers get imported with stand ins for the firmware modules. WaitPin,
+# the bus and LVGL's display are replaced by fakes that share a simulated
+# clock, the controller is busy for a while after every block of pixel data.
+
+import os
+import signal
+import sys
+import types
+
+
+# keeps __pycache__ out of the driver directories
+sys.dont_write_bytecode = True
+
+# a flush that never finishes spins forever in _flush_wait_cb
+signal.alarm(10)
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..')
+DISPLAY = os.path.join(ROOT, 'api_drivers', 'common_api_drivers', 'display')
+
+
+class _StubModule(types.ModuleType):
+
+    def __getattr__(self, name):
+        return 0
+
+
+for _name in ('lvgl', 'lcd_bus', 'lcd_utils', 'machine', 'time'):
+    sys.modules[_name] = _StubModule(_name)
+
+sys.modules['micropython'] = _StubModule('micropython')
+sys.modules['micropython'].const = lambda x: x
+
+
+class _DisplayDriver(object):
+    pass
+
+
+sys.modules['display_driver_framework'] = _StubModule('display_driver_framework')
+sys.modules['display_driver_framework'].DisplayDriver = _DisplayDriver
+sys.modules['lvgl'].color_format_get_size = lambda _: 2
+
+sys.path.insert(0, os.path.join(DISPLAY, 'ra8876'))
+sys.path.insert(0, os.path.join(DISPLAY, 'lt7381'))
+
+import ra8876  # NOQA
+import lt7381  # NOQA
+
+
+failures = 0
+
+
+def check(cond, what):
+    global failures
+
+    if not cond:
+        print('test_wait_flush: {0} failed'.format(what))
+        failures += 1
+
+
+class Clock(object):
+
+    def __init__(self):
+        self.now = 0
+        self.ready_at = 0  # the controller is busy until then
+
+
+class FakeWaitPin(object):
+
+    def __init__(self, clock):
+        self.clock = clock
+        self.waits = []
+
+    def ready(self):
+        return self.clock.now >= self.clock.ready_at
+
+    def wait(self, timeout):
+        # the edge wakes the wait up, otherwise it runs out
+        clock = self.clock
+        start = clock.now
+
+        if clock.ready_at <= start:
+            self.waits.append(0)
+            return True
+
+        if clock.ready_at - start <= timeout:
+            clock.now = clock.ready_at
+            self.waits.append(clock.now - start)
+            return True
+
+        clock.now = start + timeout
+        self.waits.append(timeout)
+        return False
+
+
+class FakeBus(object):
+    BUSY = 5  # ms the controller needs for a block
+
+    def __init__(self, clock):
+        self.clock = clock
+        self.driver = None
+        self.sent = []
+
+    def tx_color(self, cmd, data, x1, y1, x2, y2, rotation, last):
+        self.sent.append((self.clock.now, x1, last))
+        self.clock.ready_at = self.clock.now + self.BUSY
+        # the transfer is done before the controller is, same as DMA
+        self.driver._flush_ready_cb()
+
+
+class FakeDisp(object):
+
+    def __init__(self):
+        self.last = False
+        self.ready_calls = 0
+
+    def flush_is_last(self):
+        return self.last
+
+    def flush_ready(self):
+        self.ready_calls += 1
+
+
+class Area(object):
+
+    def __init__(self, x):
+        self.x1 = x
+        self.x2 = x + 9
+        self.y1 = 0
+        self.y2 = 9
+
+
+class ColorP(object):
+
+    def __dereference__(self, size):
+        return bytearray(size)
+
+
+def make_driver(cls, wait_irq):
+    clock = Clock()
+
+    driver = cls.__new__(cls)
+    driver._waiter = FakeWaitPin(clock)
+    driver._wait_irq = wait_irq
+    driver._pending_flush = None
+    driver._flushing = False
+    driver._offset_x = 0
+    driver._offset_y = 0
+    driver._rotation = 0
+    driver._color_space = 0
+    driver._set_memory_location = lambda *_: 0x04
+    driver._disp_drv = FakeDisp()
+    driver._data_bus = FakeBus(clock)
+    driver._data_bus.driver = driver
+
+    return driver, clock
+
+
+def test_ready(cls):
+    # nothing to wait for, the data goes out from the flush callback
+    driver, clock = make_driver(cls, True)
+    clock.now = 100
+
+    driver._flush_cb(None, Area(0), ColorP())
+
+    check(driver._data_bus.sent == [(100, 0, False)], cls.__name__ + ' ready send')
+    check(driver._pending_flush is None, cls.__name__ + ' ready nothing held')
+    check(not driver._flushing, cls.__name__ + ' ready flushing')
+    check(driver._disp_drv.ready_calls == 1, cls.__name__ + ' ready flush_ready')
+
+    # the flush wait has nothing to do
+    driver._flush_wait_cb(None)
+    check(len(driver._data_bus.sent) == 1, cls.__name__ + ' ready no second send')
+
+
+def test_held_back(cls):
+    driver, clock = make_driver(cls, True)
+
+    driver._flush_cb(None, Area(0), ColorP())
+    check(clock.ready_at == 5, cls.__name__ + ' held back busy')
+
+    # the controller is still busy, the flush callback returns right away
+    # and the data is held back
+    clock.now = 1
+    driver._flush_cb(None, Area(10), ColorP())
+
+    check(clock.now == 1, cls.__name__ + ' held back no wait')
+    check(len(driver._data_bus.sent) == 1, cls.__name__ + ' held back not sent')
+    check(driver._pending_flush is not None, cls.__name__ + ' held back pending')
+    check(driver._flushing, cls.__name__ + ' held back flushing')
+
+    # LVGL renders the next area, then waits on the flush
+    clock.now = 3
+    driver._flush_wait_cb(None)
+
+    check(driver._data_bus.sent[1] == (5, 10, False), cls.__name__ + ' held back sent at the edge')
+    check(driver._pending_flush is None, cls.__name__ + ' held back cleared')
+    check(not driver._flushing, cls.__name__ + ' held back done')
+    check(driver._disp_drv.ready_calls == 2, cls.__name__ + ' held back flush_ready')
+
+
+def test_last_area(cls):
+    # the last area of a refresh is never held back
+    driver, clock = make_driver(cls, True)
+
+    driver._flush_cb(None, Area(0), ColorP())
+    clock.now = 2
+    driver._disp_drv.last = True
+    driver._flush_cb(None, Area(10), ColorP())
+
+    check(driver._pending_flush is None, cls.__name__ + ' last not held')
+    check(driver._data_bus.sent[1] == (5, 10, True), cls.__name__ + ' last sent after the wait')
+    check(driver._waiter.waits == [0, 3], cls.__name__ + ' last waits')
+
+
+def test_no_irq(cls):
+    # without wait_irq the flush callback always waits
+    driver, clock = make_driver(cls, False)
+
+    driver._flush_cb(None, Area(0), ColorP())
+    clock.now = 1
+    driver._flush_cb(None, Area(10), ColorP())
+
+    check(driver._pending_flush is None, cls.__name__ + ' no irq not held')
+    check(driver._data_bus.sent[1] == (5, 10, False), cls.__name__ + ' no irq sent after the wait')
+
+
+def test_timeout(cls):
+    # a controller that never comes back doesn't hang the flush
+    driver, clock = make_driver(cls, True)
+
+    driver._flush_cb(None, Area(0), ColorP())
+    clock.ready_at = 10000
+    clock.now = 1
+    driver._flush_cb(None, Area(10), ColorP())
+    driver._flush_wait_cb(None)
+
+    check(driver._waiter.waits[-1] == cls.WAIT_TIMEOUT, cls.__name__ + ' timeout waited')
+    check(driver._data_bus.sent[1] == (1 + cls.WAIT_TIMEOUT, 10, False), cls.__name__ + ' timeout sent')
+    check(not driver._flushing, cls.__name__ + ' timeout done')
+
+
+for _cls in (ra8876.RA8876, lt7381.LT7381):
+    test_ready(_cls)
+    test_held_back(_cls)
+    test_last_area(_cls)
+    test_no_irq(_cls)
+    test_timeout(_cls)
+
+
+if failures:
+    print('test_wait_flush: {0} failed'.format(failures))
+    sys.exit(1)
+
+print('test_wait_flush: ok')
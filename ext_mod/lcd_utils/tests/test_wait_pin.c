@@ -0,0 +1,180 @@
+// Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+// Host tests for the wait pin loop, run with "make -C ext_mod/lcd_utils/tests"
+//
+// The clock is simulated. sleep_ms() moves it forward and stops early at the
+// time an edge on the wait pin is set to happen, the same as an interrupt
+// waking mp_event_wait_ms up.
+
+#include <stdio.h>
+
+#include "../include/wait_pin_engine.h"
+
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+
+typedef struct _timeline_t {
+    uint32_t ready_at;      // the controller is ready from this tick on
+    bool never_ready;
+    uint32_t checks;        // is_ready calls
+    uint32_t sleeps;        // sleep_ms calls
+} timeline_t;
+
+static uint32_t now;
+
+
+static bool sim_is_ready(void *arg)
+{
+    timeline_t *timeline = (timeline_t *)arg;
+
+    timeline->checks++;
+    return !timeline->never_ready && (int32_t)(now - timeline->ready_at) >= 0;
+}
+
+
+static uint32_t sim_ticks_ms(void)
+{
+    return now;
+}
+
+
+static timeline_t *sim_timeline;
+
+static void sim_sleep_ms(uint32_t ms)
+{
+    sim_timeline->sleeps++;
+
+    uint32_t wake = now + ms;
+
+    // the edge wakes the sleep up
+    if (!sim_timeline->never_ready && (int32_t)(sim_timeline->ready_at - now) > 0 &&
+            (int32_t)(sim_timeline->ready_at - wake) < 0) {
+        wake = sim_timeline->ready_at;
+    }
+
+    now = wake;
+}
+
+
+static bool run(timeline_t *timeline, int32_t timeout)
+{
+    const wait_pin_io_t io = {
+        .is_ready = sim_is_ready,
+        .ticks_ms = sim_ticks_ms,
+        .sleep_ms = sim_sleep_ms,
+        .arg = timeline,
+    };
+
+    sim_timeline = timeline;
+    return wait_pin_run(&io, timeout);
+}
+
+
+static void test_already_ready(void)
+{
+    timeline_t timeline = { .ready_at = 1000 };
+    now = 1000;
+
+    CHECK(run(&timeline, 100));
+    CHECK(now == 1000);
+    CHECK(timeline.checks == 1);
+    CHECK(timeline.sleeps == 0);
+
+    // a timeout of 0 still gets the one check
+    timeline.checks = 0;
+    CHECK(run(&timeline, 0));
+    CHECK(timeline.checks == 1);
+}
+
+
+static void test_timeout(void)
+{
+    timeline_t timeline = { .never_ready = true };
+    now = 5000;
+
+    CHECK(!run(&timeline, 100));
+    CHECK(now == 5100);
+    CHECK(timeline.sleeps == 100);
+
+    timeline.sleeps = 0;
+    CHECK(!run(&timeline, 0));
+    CHECK(now == 5100);
+    CHECK(timeline.sleeps == 0);
+}
+
+
+static void test_edge_during_wait(void)
+{
+    timeline_t timeline = { .ready_at = 237 };
+    now = 200;
+
+    // returns at the edge, not at the timeout
+    CHECK(run(&timeline, 100));
+    CHECK(now == 237);
+    CHECK(timeline.sleeps == 37);
+
+    // the edge right at the timeout still counts
+    timeline = (timeline_t){ .ready_at = 400 };
+    now = 300;
+    CHECK(run(&timeline, 100));
+    CHECK(now == 400);
+
+    // and one tick after it doesn't
+    timeline = (timeline_t){ .ready_at = 501 };
+    now = 400;
+    CHECK(!run(&timeline, 100));
+    CHECK(now == 500);
+}
+
+
+static void test_forever(void)
+{
+    timeline_t timeline = { .ready_at = 60000 };
+    now = 0;
+
+    CHECK(run(&timeline, -1));
+    CHECK(now == 60000);
+}
+
+
+static void test_tick_wrap(void)
+{
+    // ticks_ms wraps in the middle of the wait
+    timeline_t timeline = { .never_ready = true };
+    now = 0xFFFFFFF0u;
+
+    CHECK(!run(&timeline, 50));
+    CHECK(now == 0x22u);
+
+    timeline = (timeline_t){ .ready_at = 0x10u };
+    now = 0xFFFFFFF0u;
+
+    CHECK(run(&timeline, 50));
+    CHECK(now == 0x10u);
+}
+
+
+int main(void)
+{
+    test_already_ready();
+    test_timeout();
+    test_edge_during_wait();
+    test_forever();
+    test_tick_wrap();
+
+    if (failures) {
+        printf("test_wait_pin: %d failed\n", failures);
+        return 1;
+    }
+
+    printf("test_wait_pin: ok\n");
+    return 0;
+}
@@ -34,7 +34,11 @@ SRC_USERMOD_LIB_C += $(shell find $(LVGL_DIR)/src -type f -name "*.c")
 SRC_USERMOD_LIB_C += $(CURRENT_DIR)/mem_core.c
 SRC_USERMOD_C += $(LVGL_MPY)
 
-$(LVGL_MPY): $(ALL_LVGL_SRC) $(LVGL_BINDING_DIR)/gen/$(GEN_SCRIPT)_api_gen_mpy.py
+# LV_USAGE_FILE is written by make.py on every build, it has the names the
+# firmware uses (LV_USAGE=...) or null for the full API. It only changes when
+# that does which is what makes switching LV_USAGE on or off regenerate the
+# bindings.
+$(LVGL_MPY): $(ALL_LVGL_SRC) $(LVGL_BINDING_DIR)/gen/$(GEN_SCRIPT)_api_gen_mpy.py $(LV_USAGE_FILE)
 	$(ECHO) "LVGL-GEN $@"
 	$(Q)mkdir -p $(dir $@)
 
@@ -40,10 +40,7 @@ pycparser_monkeypatch.get_macro_docs = dummy_doc
 pycparser_monkeypatch.get_macros = dummy_list
 
 
-def run(lvgl_config_path, target_header, filter_private):
-
-    pycparser_monkeypatch.FILTER_PRIVATE = filter_private
-
+def preprocess(lvgl_config_path, target_header):
     lvgl_path = project_path
     lvgl_src_path = os.path.join(lvgl_path, 'src')
     temp_lvgl = os.path.join(temp_directory, 'lvgl')
@@ -131,9 +128,20 @@ def run(lvgl_config_path, target_header, filter_private):
     with open(pp_file, 'r') as f:
         pp_data = f.read()
 
+    shutil.rmtree(temp_directory)
+
+    return pp_data
+
+
+def parse(pp_data, target_header, filter_private):
+    pycparser_monkeypatch.FILTER_PRIVATE = filter_private
+
     cparser = pycparser.CParser()
     ast = cparser.parse(pp_data, target_header)
 
-    shutil.rmtree(temp_directory)
-
     return ast
+
+
+def run(lvgl_config_path, target_header, filter_private):
+    pp_data = preprocess(lvgl_config_path, target_header)
+    return parse(pp_data, target_header, filter_private)
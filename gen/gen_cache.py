@@ -0,0 +1,194 @@
+# Copyright (c) 2024 - 2025 Kevin G. Schlosser
+
+# Build directory cache for the binding generator.
+#
+# Every entry is a single slot that holds the key it was made with. A board
+# matrix build uses a build directory per board so keeping more than the last
+# result per directory only eats disk space.
+#
+# slots
+#   pp_ast:     pickled pycparser AST of the preprocessed lvgl.h
+#   lvgl_json:  the LVGL API JSON (fixed_gen_json)
+#   output:     every file the generator wrote
+#
+# Setting LV_GEN_CACHE=0 in the environment turns the cache off.
+
+import os
+import sys
+import json
+import pickle
+import shutil
+import hashlib
+
+
+ENABLED = os.environ.get('LV_GEN_CACHE', '1') != '0'
+
+cache_path = None
+
+
+def init(path):
+    global cache_path
+
+    cache_path = path
+
+    if ENABLED and not os.path.exists(cache_path):
+        os.makedirs(cache_path)
+
+
+def make_key(*parts):
+    hasher = hashlib.sha256()
+
+    for part in parts:
+        if part is None:
+            part = b'\x00'
+        elif isinstance(part, str):
+            part = part.encode('utf-8')
+
+        hasher.update(str(len(part)).encode('utf-8') + b':')
+        hasher.update(part)
+
+    return hasher.hexdigest()
+
+
+def file_key(*paths):
+    parts = []
+    for path in paths:
+        if path is not None and os.path.exists(path):
+            with open(path, 'rb') as f:
+                parts.append(f.read())
+        else:
+            parts.append(None)
+
+    return make_key(*parts)
+
+
+def _slot_path(slot):
+    return os.path.join(cache_path, slot)
+
+
+def _read_key(slot):
+    key_file = os.path.join(_slot_path(slot), 'key')
+
+    if not os.path.exists(key_file):
+        return None
+
+    with open(key_file, 'r') as f:
+        return f.read().strip()
+
+
+def _new_slot(slot):
+    path = _slot_path(slot)
+    if os.path.exists(path):
+        shutil.rmtree(path)
+
+    os.makedirs(path)
+    return path
+
+
+def _finish_slot(slot, key):
+    # the key gets written last, a slot without one is incomplete
+    with open(os.path.join(_slot_path(slot), 'key'), 'w') as f:
+        f.write(key)
+
+
+def load_pickle(slot, key):
+    if not ENABLED or _read_key(slot) != key:
+        return None
+
+    try:
+        with open(os.path.join(_slot_path(slot), 'data.pickle'), 'rb') as f:
+            return pickle.load(f)
+    except Exception as err:  # NOQA
+        sys.stderr.write(f'generator cache: unable to load {slot} ({err})\n')
+        return None
+
+
+def save_pickle(slot, key, data):
+    if not ENABLED:
+        return
+
+    path = _new_slot(slot)
+
+    recursion_limit = sys.getrecursionlimit()
+    sys.setrecursionlimit(max(recursion_limit, 20000))
+
+    try:
+        with open(os.path.join(path, 'data.pickle'), 'wb') as f:
+            pickle.dump(data, f, protocol=pickle.HIGHEST_PROTOCOL)
+    except Exception as err:  # NOQA
+        sys.stderr.write(f'generator cache: unable to save {slot} ({err})\n')
+        shutil.rmtree(path)
+        return
+    finally:
+        sys.setrecursionlimit(recursion_limit)
+
+    _finish_slot(slot, key)
+
+
+def load_json(slot, key):
+    if not ENABLED or _read_key(slot) != key:
+        return None
+
+    with open(os.path.join(_slot_path(slot), 'data.json'), 'r') as f:
+        return json.load(f)
+
+
+def save_json(slot, key, data):
+    if not ENABLED:
+        return
+
+    path = _new_slot(slot)
+
+    with open(os.path.join(path, 'data.json'), 'w') as f:
+        json.dump(data, f)
+
+    _finish_slot(slot, key)
+
+
+def restore_files(slot, key):
+    """
+    Copies the cached files back to where they were written from.
+    Returns False if there is nothing cached for `key`.
+    """
+    if not ENABLED or _read_key(slot) != key:
+        return False
+
+    path = _slot_path(slot)
+
+    with open(os.path.join(path, 'files.json'), 'r') as f:
+        files = json.load(f)
+
+    for cache_name in files.values():
+        if not os.path.exists(os.path.join(path, cache_name)):
+            return False
+
+    for dst, cache_name in files.items():
+        dst_dir = os.path.dirname(dst)
+        if dst_dir and not os.path.exists(dst_dir):
+            os.makedirs(dst_dir)
+
+        shutil.copyfile(os.path.join(path, cache_name), dst)
+
+    return True
+
+
+def save_files(slot, key, file_paths):
+    if not ENABLED:
+        return
+
+    path = _new_slot(slot)
+    files = {}
+
+    for i, file_path in enumerate(file_paths):
+        if not os.path.exists(file_path):
+            continue
+
+        file_path = os.path.abspath(file_path)
+        cache_name = f'{i}_{os.path.basename(file_path)}'
+        shutil.copyfile(file_path, os.path.join(path, cache_name))
+        files[file_path] = cache_name
+
+    with open(os.path.join(path, 'files.json'), 'w') as f:
+        json.dump(files, f, indent=4)
+
+    _finish_slot(slot, key)
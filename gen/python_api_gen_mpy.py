@@ -118,6 +118,19 @@ module_prefix = args.module_prefix if args.module_prefix else args.module_name
 input_header = args.header
 DEBUG = args.debug
 
+# Names used from Python, written by make.py. When LV_USAGE is given the
+# bindings are only generated for the parts of the API that are used, the
+# names are null when it isn't.
+lv_usage_file = os.environ.get('LV_USAGE_FILE', None)
+lv_usage = None
+
+if lv_usage_file and os.path.exists(lv_usage_file):
+    with open(lv_usage_file, 'r') as f:
+        lv_usage_names = json.load(f)['names']
+
+    if lv_usage_names is not None:
+        lv_usage = frozenset(lv_usage_names)
+
 lvgl_path = os.path.dirname(input_header)
 private_header = os.path.join(lvgl_path, 'src', 'lvgl_private.h')
 
@@ -126,30 +139,6 @@ gen_json_path = os.path.join(lvgl_path, 'scripts/gen_json')
 
 sys.path.insert(0, gen_json_path)
 
-original_nodes = {}
-
-
-for key, value in c_ast.__dict__.items():
-    if inspect.isclass(value):
-        original_nodes[key] = value
-
-
-import fixed_gen_json  # NOQA
-
-
-json_ast = fixed_gen_json.run(lv_config_path, os.path.join(project_path, 'build', 'lvgl_header.h'), False)
-
-lvgl_json = json_ast.to_dict()
-
-
-for key, value in original_nodes.items():
-    setattr(c_ast, key, value)
-
-
-c_ast._repr = _repr
-setattr(c_ast.Node, '__repr__', Node__repr__)
-
-
 pp_file = args.output.rsplit('.', 1)[0] + '.pp'
 
 if DEBUG:
@@ -313,6 +302,10 @@ cpp_cmd.extend(unknownargs)
 
 cpp_cmd = ' '.join(cpp_cmd)
 
+# the preprocessor output gets appended to the file
+if os.path.exists(pp_file):
+    os.remove(pp_file)
+
 p = subprocess.Popen(
     cpp_cmd,
     stdout=subprocess.PIPE,
@@ -333,6 +326,71 @@ if not os.path.exists(pp_file):
     raise RuntimeError('Unknown Failure')
 
 
+with open(pp_file, 'r') as f:
+    pp_data = f.read()
+
+
+original_nodes = {}
+
+
+for key, value in c_ast.__dict__.items():
+    if inspect.isclass(value):
+        original_nodes[key] = value
+
+
+import fixed_gen_json  # NOQA
+import gen_cache  # NOQA
+
+
+# Generation cache
+#
+# Running the preprocessor is cheap, parsing its output with pycparser and
+# generating the bindings is not. The preprocessed output, lv_conf.h, the
+# command line, the LV_USAGE names and the generator sources make up the key
+# for the generated files. If only the generator or its options changed the
+# parsed ASTs are still reused.
+
+gen_cache.init(os.path.join(os.path.dirname(os.path.abspath(args.output)), 'lv_mp_cache'))
+
+lvgl_header_path = os.path.join(project_path, 'build', 'lvgl_header.h')
+json_pp_data = fixed_gen_json.preprocess(lv_config_path, lvgl_header_path)
+
+pp_ast_key = gen_cache.make_key(pp_data, input_header, pycparser.__version__)
+lvgl_json_key = gen_cache.make_key(json_pp_data, gen_cache.file_key(fixed_gen_json.__file__), pycparser.__version__)
+output_key = gen_cache.make_key(
+    pp_data,
+    json_pp_data,
+    json.dumps(sys.argv[1:]),
+    pycparser.__version__,
+    gen_cache.file_key(lv_config_path, lv_usage_file),
+    gen_cache.file_key(
+        os.path.abspath(__file__),
+        fixed_gen_json.__file__,
+        gen_cache.__file__,
+        os.path.join(script_path, 'stub_gen.py')
+    )
+)
+
+if gen_cache.restore_files('output', output_key):
+    eprint('{0} bindings are up to date, using the cached output'.format(module_name))
+    sys.exit(0)
+
+lvgl_json = gen_cache.load_json('lvgl_json', lvgl_json_key)
+
+if lvgl_json is None:
+    json_ast = fixed_gen_json.parse(json_pp_data, lvgl_header_path, False)
+    lvgl_json = json_ast.to_dict()
+    gen_cache.save_json('lvgl_json', lvgl_json_key, lvgl_json)
+
+
+for key, value in original_nodes.items():
+    setattr(c_ast, key, value)
+
+
+c_ast._repr = _repr
+setattr(c_ast.Node, '__repr__', Node__repr__)
+
+
 #
 # AST parsing helper functions
 #
@@ -665,11 +723,13 @@ func_prototypes = {}
 parser = c_parser.CParser()
 gen = c_generator.CGenerator()
 
-with open(pp_file, 'r') as f:
-    pp_data = f.read()
+ast = gen_cache.load_pickle('pp_ast', pp_ast_key)
 
-cparser = pycparser.CParser()
-ast = cparser.parse(pp_data, input_header)
+if ast is None:
+    cparser = pycparser.CParser()
+    ast = cparser.parse(pp_data, input_header)
+    # stored before anything below changes it
+    gen_cache.save_pickle('pp_ast', pp_ast_key, ast)
 
 forward_struct_decls = {}
 
@@ -756,6 +816,9 @@ class STDOut:
 
 stdout = STDOut()
 
+# every file written, these are what get cached
+generated_files = [args.output]
+
 _old_excepthook = sys.excepthook
 
 
@@ -956,6 +1019,97 @@ def get_enum_member_name(enum_member):
 def get_enum_value(obj_name, enum_member):
     return enums[obj_name][enum_member]
 
+
+# Enum values are evaluated here so members that cannot be a small int are
+# known when the tables get written. Every enum and int constant table is a
+# const (ROM) dict, a value that does not fit into a small int gets a const
+# int object instead of being truncated by MP_ROM_INT. Nothing is allocated
+# when the module gets imported.
+#
+# The small int range differs between object representations, values outside
+# the smallest one (REPR_B, 30 bits) or values that cannot be evaluated get
+# the const int object and the C compiler picks which one gets used.
+
+ROM_SMALL_INT_MIN = -(1 << 29)
+ROM_SMALL_INT_MAX = (1 << 29) - 1
+
+enum_member_values = {}
+
+
+def eval_enum_expr(expr):
+    if expr is None:
+        return None
+
+    if isinstance(expr, c_ast.Constant):
+        if expr.type not in ('int', 'unsigned int', 'long int', 'unsigned long int', 'long long int', 'unsigned long long int'):
+            return None
+        value = expr.value.rstrip('uUlL')
+        try:
+            if len(value) > 1 and value[0] == '0' and value[1].isdigit():
+                return int(value, 8)
+            return int(value, 0)
+        except ValueError:
+            return None
+
+    if isinstance(expr, c_ast.ID):
+        return enum_member_values.get(expr.name, None)
+
+    if isinstance(expr, c_ast.Cast):
+        return eval_enum_expr(expr.expr)
+
+    if isinstance(expr, c_ast.UnaryOp):
+        value = eval_enum_expr(expr.expr)
+        if value is None:
+            return None
+        return {'-': lambda v: -v, '+': lambda v: v, '~': lambda v: ~v, '!': lambda v: int(not v)}.get(expr.op, lambda v: None)(value)
+
+    if isinstance(expr, c_ast.BinaryOp):
+        left = eval_enum_expr(expr.left)
+        right = eval_enum_expr(expr.right)
+        if left is None or right is None:
+            return None
+        ops = {
+            '+': lambda l, r: l + r,
+            '-': lambda l, r: l - r,
+            '*': lambda l, r: l * r,
+            '|': lambda l, r: l | r,
+            '&': lambda l, r: l & r,
+            '^': lambda l, r: l ^ r,
+            '<<': lambda l, r: l << r,
+            '>>': lambda l, r: l >> r,
+        }
+        return ops[expr.op](left, right) if expr.op in ops else None
+
+    return None
+
+
+for enum_def in enum_defs:
+    if not enum_def.type.values:
+        continue
+
+    next_value = 0
+    for member in enum_def.type.values.enumerators:
+        value = eval_enum_expr(member.value) if member.value is not None else next_value
+        enum_member_values[member.name] = value
+        next_value = None if value is None else value + 1
+
+
+rom_big_ints = collections.OrderedDict()
+rom_big_ints_written = False
+
+
+def rom_int(c_name):
+    value = enum_member_values.get(c_name, None)
+    if value is not None and ROM_SMALL_INT_MIN <= value <= ROM_SMALL_INT_MAX:
+        return 'MP_ROM_INT(%s)' % c_name
+
+    if c_name not in rom_big_ints:
+        if rom_big_ints_written:
+            raise RuntimeError('const int object for "%s" requested after they were written' % c_name)
+        rom_big_ints[c_name] = value
+
+    return 'MP_LV_ROM_BIG_INT(mp_lv_int_{name}, {name})'.format(name=c_name)
+
 # eprint(enums)
 
 # parse function pointers
@@ -971,6 +1125,58 @@ blobs = collections.OrderedDict((decl.name, decl.type.type) for decl in ast.ext
 
 blobs['_nesting'] = parser.parse('extern int _nesting;').ext[0].type.type
 
+
+# Usage based tree shaking
+#
+# A C name is used when any of its "_" separated tails is in the usage names.
+# "lv_obj_set_width" matches "lv_obj_set_width", "obj_set_width", "set_width"
+# and "width". This errs on the side of keeping too much, something that is
+# not used costs flash, something that is missing is an AttributeError.
+
+lv_usage_totals = collections.OrderedDict()
+lv_usage_dropped = collections.OrderedDict()
+
+
+def is_used(c_name):
+    if lv_usage is None:
+        return True
+
+    parts = c_name.split('_')
+    for i in range(len(parts)):
+        candidate = '_'.join(parts[i:])
+        if candidate == 'del':
+            candidate = 'delete'  # see method_name_from_func_name
+        if candidate in lv_usage or sanitize(candidate) in lv_usage:
+            return True
+
+    return False
+
+
+def shake(category, items, keep):
+    kept = []
+    dropped = []
+    for item in items:
+        (kept if keep(item) else dropped).append(item)
+
+    lv_usage_totals[category] = len(items)
+    lv_usage_dropped[category] = dropped
+    return kept
+
+
+if lv_usage is not None:
+    # the base object is always needed, everything else inherits from it.
+    obj_names = shake('objects', obj_names, lambda obj_name: obj_name == base_obj_name or is_used(obj_name))
+    obj_ctors = [ctor for ctor in obj_ctors if create_obj_pattern.match(ctor.name).group(1) in obj_names]
+    parent_obj_names = {obj_name: parent for obj_name, parent in parent_obj_names.items() if obj_name in obj_names}
+
+    dropped_obj_names = lv_usage_dropped['objects']
+    funcs = [func for func in funcs if not any(is_method_of(func.name, obj_name) for obj_name in dropped_obj_names)]
+    funcs = shake('functions', funcs, lambda func: is_used(func.name))
+    lv_usage_dropped['functions'] = [func.name for func in lv_usage_dropped['functions']]
+
+    blob_names = shake('globals', list(blobs.keys()), lambda blob_name: blob_name == '_nesting' or is_used(blob_name))
+    blobs = collections.OrderedDict((blob_name, blobs[blob_name]) for blob_name in blob_names)
+
 int_constants = []
 
 
@@ -1287,6 +1493,7 @@ print ("""
 #include <string.h>
 #include "py/obj.h"
 #include "py/objint.h"
+#include "py/smallint.h"
 #include "py/objstr.h"
 #include "py/runtime.h"
 #include "py/binary.h"
@@ -2240,6 +2447,44 @@ MP_ARRAY_CONVERTOR(i64ptr, 8, true)
 
 """)
 
+#
+# Emit fast-path converters
+#
+# These are used by the type specialized thunks that get generated for the
+# most common call shapes (see get_fast_path_shape). A native LVGL object
+# gets its lv_obj_t pointer loaded directly and small ints get unboxed
+# inline. Anything else falls back to the generic converters so the
+# behavior is the same as the generic wrapper. Setting MP_LV_FAST_PATH to 0
+# in LV_CFLAGS compiles the generic wrappers instead.
+#
+print("""
+/*
+ * Fast-path converters
+ */
+
+#ifndef MP_LV_FAST_PATH
+#define MP_LV_FAST_PATH 1
+#endif
+
+#if MP_LV_FAST_PATH && defined(LV_OBJ_T)
+
+static inline LV_OBJ_T *mp_lv_fast_to_obj(mp_obj_t mp_obj)
+{
+    if (MP_OBJ_IS_OBJ(mp_obj) &&
+        MP_OBJ_TYPE_GET_SLOT_OR_NULL(((mp_obj_base_t *)MP_OBJ_TO_PTR(mp_obj))->type, buffer) == mp_lv_obj_get_buffer) {
+        LV_OBJ_T *lv_obj = ((mp_lv_obj_t *)MP_OBJ_TO_PTR(mp_obj))->lv_obj;
+        if (lv_obj != NULL) return lv_obj;
+    }
+    // subclasses, None and deleted objects
+    return mp_to_lv(mp_obj);
+}
+
+#define MP_LV_FAST_INT(c_type, mp_obj) \\
+    (MP_OBJ_IS_SMALL_INT(mp_obj) ? (c_type)MP_OBJ_SMALL_INT_VALUE(mp_obj) : (c_type)mp_obj_get_int(mp_obj))
+
+#endif // MP_LV_FAST_PATH && defined(LV_OBJ_T)
+""")
+
 #
 # Add regular enums with integer values
 #
@@ -2263,7 +2508,7 @@ for enum_def in enum_defs:
         if member_name[0].isdigit():
             member_name = '_' + member_name
         if len(enum_name) > 0 and get_enum_name(enum_name) != 'ENUM':
-            enum[member_name] = 'MP_ROM_INT(%s)' % member.name
+            enum[member_name] = rom_int(member.name)
         else:
             int_constants.append(member.name)
     if len(enum) > 0:
@@ -2282,6 +2527,61 @@ for enum in [enum for enum in enums if len(enums[enum]) == 1 and enum.startswith
     del enums[enum]
 
 
+for int_constant in int_constants:
+    rom_int(int_constant)
+
+print('''
+/*
+ * LVGL integer constants that might not fit into a small int
+ */
+
+// The range check is done in 64 bits before anything gets narrowed to a
+// small int, casting to mp_int_t first turns an unsigned 0xFFFFFFFF into -1
+// on 32 bit ports and that would pass the check.
+#define MP_LV_ROM_INT_FITS(v) ((v) < 0 ? \\
+    (int64_t)(v) >= (int64_t)MP_SMALL_INT_MIN : \\
+    (uint64_t)(v) <= (uint64_t)MP_SMALL_INT_MAX)
+
+#if MICROPY_LONGINT_IMPL == MICROPY_LONGINT_IMPL_MPZ
+
+#define MP_LV_MPZ_ABS(v) ((v) < 0 ? (uint64_t)(-(int64_t)(v)) : (uint64_t)(v))
+#define MP_LV_MPZ_SHR(v, n) ((n) * MPZ_DIG_SIZE < 64 ? MP_LV_MPZ_ABS(v) >> (((n) * MPZ_DIG_SIZE) % 64) : 0)
+#define MP_LV_MPZ_DIG(v, n) ((mpz_dig_t)(MP_LV_MPZ_SHR(v, n) & ((((uint64_t)1) << MPZ_DIG_SIZE) - 1)))
+#define MP_LV_MPZ_LEN(v) (1 + (MP_LV_MPZ_SHR(v, 1) != 0) + (MP_LV_MPZ_SHR(v, 2) != 0) + (MP_LV_MPZ_SHR(v, 3) != 0) + \\
+    (MP_LV_MPZ_SHR(v, 4) != 0) + (MP_LV_MPZ_SHR(v, 5) != 0) + (MP_LV_MPZ_SHR(v, 6) != 0) + (MP_LV_MPZ_SHR(v, 7) != 0))
+
+#define MP_LV_DEFINE_ROM_BIG_INT(name, v) \\
+    GENMPY_UNUSED static const mpz_dig_t name##_dig[] = { \\
+        MP_LV_MPZ_DIG(v, 0), MP_LV_MPZ_DIG(v, 1), MP_LV_MPZ_DIG(v, 2), MP_LV_MPZ_DIG(v, 3), \\
+        MP_LV_MPZ_DIG(v, 4), MP_LV_MPZ_DIG(v, 5), MP_LV_MPZ_DIG(v, 6), MP_LV_MPZ_DIG(v, 7) \\
+    }; \\
+    GENMPY_UNUSED static const mp_obj_int_t name = { \\
+        { &mp_type_int }, \\
+        { .neg = (v) < 0, .fixed_dig = 1, .alloc = 8, .len = MP_LV_MPZ_LEN(v), .dig = (mpz_dig_t *)name##_dig } \\
+    }
+
+#define MP_LV_ROM_BIG_INT(name, v) (MP_LV_ROM_INT_FITS(v) ? MP_ROM_INT(v) : MP_ROM_PTR(&name))
+
+#elif MICROPY_LONGINT_IMPL == MICROPY_LONGINT_IMPL_LONGLONG
+
+#define MP_LV_DEFINE_ROM_BIG_INT(name, v) GENMPY_UNUSED static const mp_obj_int_t name = { { &mp_type_int }, (v) }
+#define MP_LV_ROM_BIG_INT(name, v) (MP_LV_ROM_INT_FITS(v) ? MP_ROM_INT(v) : MP_ROM_PTR(&name))
+
+#else
+
+// No long int support, values that do not fit get truncated to a small int.
+#define MP_LV_DEFINE_ROM_BIG_INT(name, v)
+#define MP_LV_ROM_BIG_INT(name, v) MP_ROM_INT(v)
+
+#endif
+''')
+
+for c_name in rom_big_ints:
+    print('MP_LV_DEFINE_ROM_BIG_INT(mp_lv_int_{name}, {name});'.format(name=c_name))
+
+rom_big_ints_written = True
+
+
 # Add special string enums
 print ('''
 /*
@@ -2309,6 +2609,11 @@ for enum_def in enum_defs:
                 enums[enum_name] = enum
 
 
+if lv_usage is not None:
+    enum_names = shake('enums', list(enums.keys()), is_used)
+    enums = collections.OrderedDict((enum_name, enums[enum_name]) for enum_name in enum_names)
+    int_constants = shake('int_constants', int_constants, is_used)
+
 # eprint('--> enums: \n%s' % enums)
 
 
@@ -3104,6 +3409,83 @@ static {builtin_macro}(mp_{func_obj_name}_mpobj, {param_count}, mp_{func_name},
             builtin_macro='MP_DEFINE_CONST_LV_FUN_OBJ_STATIC_VAR' if is_static else 'MP_DEFINE_CONST_LV_FUN_OBJ_VAR'))
 
 
+#
+# Fast-path thunks
+#
+# Functions with one of these shapes get a thunk that calls the LVGL function
+# directly and uses the inline converters instead of going through the
+# function pointer stored in the function object:
+#
+#   void f(lv_obj_t *obj)
+#   void f(lv_obj_t *obj, <int> value)
+#   void f(lv_obj_t *obj, <int> value, lv_style_selector_t selector)
+#
+# <int> is any type whose generic conversion is mp_obj_get_int (int32_t,
+# lv_opa_t, enums...). Because the thunk is bound to a single LVGL function
+# it is never shared with other functions that have the same prototype.
+#
+FAST_PATH_OBJ = 'obj'
+FAST_PATH_OBJ_INT = 'obj_int'
+FAST_PATH_OBJ_INT_SELECTOR = 'obj_int_selector'
+
+fast_path_funcs = collections.OrderedDict()
+
+
+def _is_fast_path_int(arg):
+    if not hasattr(arg, 'type') or isinstance(arg, c_ast.EllipsisParam):
+        return False
+    arg_type = get_type(arg.type, remove_quals=True)
+    if arg_type not in mp_to_lv or not mp_to_lv[arg_type]:
+        try:
+            try_generate_type(arg.type)
+        except MissingConversionException:
+            return False
+    convertor = mp_to_lv.get(arg_type, None)
+    return convertor is not None and convertor.endswith(')mp_obj_get_int')
+
+
+def get_fast_path_shape(func, args):
+    if len(obj_names) == 0 or not args or decl_to_callback(args[0]):
+        return None
+    if get_type(func.type.type, remove_quals=True) != 'void':
+        return None
+    if get_first_arg_type(func) != '%s *' % base_obj_type:
+        return None
+    if any(decl_to_callback(arg) for arg in args[1:]):
+        return None
+
+    if len(args) == 1:
+        return FAST_PATH_OBJ
+    if len(args) == 2 and _is_fast_path_int(args[1]):
+        return FAST_PATH_OBJ_INT
+    if (
+        len(args) == 3 and
+        _is_fast_path_int(args[1]) and
+        get_type(args[2].type, remove_quals=True) == '%s_style_selector_t' % module_prefix and
+        _is_fast_path_int(args[2])
+    ):
+        return FAST_PATH_OBJ_INT_SELECTOR
+
+    return None
+
+
+def gen_fast_path_body(func, args):
+    lines = []
+    send_args = []
+    for i, arg in enumerate(args):
+        arg_name = 'arg%d' % i
+        if i == 0:
+            lines.append('%s *%s = mp_lv_fast_to_obj(mp_args[0]);' % (base_obj_type, arg_name))
+        else:
+            c_type = get_type(arg.type, remove_quals=True)
+            lines.append('{c_type} {name} = MP_LV_FAST_INT({c_type}, mp_args[{i}]);'.format(
+                c_type=c_type, name=arg_name, i=i))
+        send_args.append(arg_name)
+
+    lines.append('%s(%s);' % (func.name, ', '.join(send_args)))
+    return '\n    '.join(lines)
+
+
 def gen_mp_func(func, obj_name):
     # print('/* gen_mp_func: %s : %s */' % (obj_name, func))
     if func.name in generated_funcs:
@@ -3135,9 +3517,12 @@ def gen_mp_func(func, obj_name):
     else:
         param_count = len(args)
 
+    fast_path_shape = get_fast_path_shape(func, args)
+
     # If func prototype matches an already generated func, reuse it and only emit func obj that points to it.
+    # Fast-path thunks call their LVGL function directly so they can neither reuse nor be reused.
     prototype_str = gen.visit(function_prototype(func))
-    if prototype_str in func_prototypes:
+    if fast_path_shape is None and prototype_str in func_prototypes:
         original_func = func_prototypes[prototype_str]
         if generated_funcs[original_func.name] == True:
             print("/* Reusing %s for %s */" % (original_func.name, func.name))
@@ -3150,7 +3535,8 @@ def gen_mp_func(func, obj_name):
             generated_funcs[func.name] = True # completed generating the function
             func_metadata[func.name] = func_md
             return
-    func_prototypes[prototype_str] = func
+    if fast_path_shape is None:
+        func_prototypes[prototype_str] = func
 
     # user_data argument must be handled first, if it exists
     try:
@@ -3197,7 +3583,8 @@ def gen_mp_func(func, obj_name):
             build_args.append(ba)
             func_md['args'].append(arg_metadata)
 
-    print("""
+    if fast_path_shape is None:
+        print("""
 /*
  * {module_name} extension definition for:
  * {print_func}
@@ -3211,14 +3598,43 @@ static mp_obj_t mp_{func}(size_t mp_n_args, const mp_obj_t *mp_args, void *lv_fu
 }}
 
  """.format(
-        module_name = module_name,
-        func=func.name,
-        func_ptr=prototype_str,
-        print_func=gen.visit(func),
-        build_args="\n    ".join(build_args), # Handle the case of 'void' param which should be ignored
-        send_args=", ".join([(arg.name if (hasattr(arg, 'name') and arg.name) else ("arg%d" % i)) for i,arg in enumerate(args)]),
-        build_result=build_result,
-        build_return_value=build_return_value))
+            module_name = module_name,
+            func=func.name,
+            func_ptr=prototype_str,
+            print_func=gen.visit(func),
+            build_args="\n    ".join(build_args), # Handle the case of 'void' param which should be ignored
+            send_args=", ".join([(arg.name if (hasattr(arg, 'name') and arg.name) else ("arg%d" % i)) for i,arg in enumerate(args)]),
+            build_result=build_result,
+            build_return_value=build_return_value))
+    else:
+        print("""
+/*
+ * {module_name} fast-path extension definition for:
+ * {print_func}
+ */
+
+static mp_obj_t mp_{func}(size_t mp_n_args, const mp_obj_t *mp_args, void *lv_func_ptr)
+{{
+#if MP_LV_FAST_PATH
+    (void)lv_func_ptr;
+    {fast_body}
+#else
+    {build_args}
+    (({func_ptr})lv_func_ptr)({send_args});
+#endif
+    return mp_const_none;
+}}
+
+ """.format(
+            module_name = module_name,
+            func=func.name,
+            func_ptr=prototype_str,
+            print_func=gen.visit(func),
+            fast_body=gen_fast_path_body(func, args),
+            build_args="\n    ".join(build_args),
+            send_args=", ".join([(arg.name if (hasattr(arg, 'name') and arg.name) else ("arg%d" % i)) for i,arg in enumerate(args)])))
+
+        fast_path_funcs[func.name] = (obj_name, fast_path_shape)
 
     emit_func_obj(func.name, func.name, param_count, func.name, is_static_member(func, base_obj_type))
     generated_funcs[func.name] = True # completed generating the function
@@ -3656,8 +4072,8 @@ static const mp_rom_map_elem_t {module_name}_globals_table[] = {{
             format(struct_name = sanitize(struct_name), alias_name = sanitize(simplify_identifier(struct_aliases[struct_name]))) for struct_name in struct_aliases.keys()]),
         blobs = ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{name}), MP_ROM_PTR(&mp_{global_name}) }},\n    '.
             format(name = sanitize(simplify_identifier(global_name)), global_name = global_name) for global_name in generated_globals]),
-        int_constants = ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{name}), MP_ROM_PTR(MP_ROM_INT({value})) }},\n    '.
-            format(name = sanitize(get_enum_name(int_constant)), value = int_constant) for int_constant in int_constants])))
+        int_constants = ''.join(['{{ MP_ROM_QSTR(MP_QSTR_{name}), MP_ROM_PTR({value}) }},\n    '.
+            format(name = sanitize(get_enum_name(int_constant)), value = rom_int(int_constant)) for int_constant in int_constants])))
 
 
 print("""
@@ -3687,6 +4103,278 @@ static const mp_lv_obj_type_t *mp_lv_obj_types[] = {{
 }};
     '''.format(obj_types = ',\n    '.join(['&mp_lv_%s_type' % obj_name for obj_name in obj_names])))
 
+
+#
+# Emit the fast-path microbenchmark
+#
+# Writes lv_mp_bench.py next to the generated C file. It times the first 50
+# fast-path setters of the base object (plain setters first, then the style
+# setters) and prints calls/s for each one. It is meant to be run with the
+# unix port, "lvgl_micropy_unix lv_mp_bench.py". Build once with
+# LV_CFLAGS="-DMP_LV_FAST_PATH=0" to get the numbers for the generic path.
+#
+BENCH_SETTER_COUNT = 50
+
+bench_template = '''\
+# Auto-Generated file, DO NOT EDIT!
+#
+# {module_name} binding call-rate microbenchmark for the fast-path setters.
+
+import time
+import {module_name} as lv
+
+ITERATIONS = 2000
+
+lv.init()
+
+_disp = lv.display_create(320, 240)
+_buf = bytearray(320 * 10 * 4)
+_disp.set_buffers(_buf, None, len(_buf), lv.DISPLAY_RENDER_MODE.PARTIAL)
+_disp.set_flush_cb(lambda disp, area, px_map: disp.flush_ready())
+
+{bench_funcs}
+
+BENCHMARKS = (
+    {bench_table}
+)
+
+
+def run(iterations=ITERATIONS):
+    obj = lv.obj(lv.screen_active())
+    total = 0
+
+    for name, func in BENCHMARKS:
+        start = time.ticks_us()
+        func(obj, iterations)
+        elapsed = max(time.ticks_diff(time.ticks_us(), start), 1)
+        total += elapsed
+        print('{{:<40}} {{:>10}} calls/s'.format(name, iterations * 1000000 // elapsed))
+
+    total = max(total, 1)
+    print('{{:<40}} {{:>10}} calls/s'.format(
+        'average', iterations * len(BENCHMARKS) * 1000000 // total))
+
+    obj.delete()
+
+
+run()
+'''
+
+bench_func_template = '''\
+def _{name}(obj, iterations):
+    for _ in range(iterations):
+        obj.{name}({bench_args})
+'''
+
+
+def get_bench_setters():
+    shape_order = (FAST_PATH_OBJ_INT, FAST_PATH_OBJ_INT_SELECTOR)
+    setters = []
+    for shape in shape_order:
+        for func_name, (scope, func_shape) in fast_path_funcs.items():
+            if func_shape != shape or scope != base_obj_name:
+                continue
+            method_name = method_name_from_func_name(func_name)
+            if method_name.startswith('set_'):
+                setters.append((sanitize(method_name), func_shape))
+
+    return setters[:BENCH_SETTER_COUNT]
+
+
+bench_setters = get_bench_setters()
+
+# the benchmark needs parts of the API that may have been shaken out
+if bench_setters and lv_usage is None:
+    bench_args = {
+        FAST_PATH_OBJ_INT: '1',
+        FAST_PATH_OBJ_INT_SELECTOR: '1, 0',
+    }
+
+    bench_path = os.path.join(os.path.dirname(os.path.abspath(args.output)), 'lv_mp_bench.py')
+    generated_files.append(bench_path)
+
+    with open(bench_path, 'w') as bench_file:
+        bench_file.write(bench_template.format(
+            module_name=module_name,
+            bench_funcs='\n\n'.join(
+                bench_func_template.format(name=name, bench_args=bench_args[shape])
+                for name, shape in bench_setters
+            ),
+            bench_table='\n    '.join("('{0}', _{0}),".format(name) for name, _ in bench_setters)
+        ))
+
+# ROM/RAM report
+#
+# Sizes assume 32 bit words: a const dict entry is 2 words, a const mpz int
+# object is the object (4 words) plus 8 digits. Everything counted here comes
+# from the tables that were just generated.
+#
+# What "import lvgl" costs in RAM is the static data and the root pointers in
+# the generated C plus anything the import allocates. Those get picked out of
+# the C that was written so a change to the templates shows up in the report.
+
+RAM_TYPE_SIZES = {
+    'bool': 1, 'char': 1, 'int8_t': 1, 'uint8_t': 1,
+    'int16_t': 2, 'uint16_t': 2,
+    'int': 4, 'unsigned': 4, 'size_t': 4, 'float': 4, 'int32_t': 4, 'uint32_t': 4,
+    'mp_int_t': 4, 'mp_uint_t': 4, 'mp_obj_t': 4,
+    'double': 8, 'int64_t': 8, 'uint64_t': 8,
+}
+
+# a definition of non const data, at file scope or static inside a function
+ram_data_pattern = re.compile(
+    r'^(?:static\s+|(?=\S))(?:volatile\s+)?'
+    r'(?P<type>[A-Za-z_]\w*(?:\s+[A-Za-z_]\w*)*?\s*\**)\s*'
+    r'(?P<name>[A-Za-z_]\w*)(?:\[(?P<count>\d+)\])?\s*(?:=[^;(]*)?;\s*$'
+)
+ram_root_pointer_pattern = re.compile(r'^MP_REGISTER_ROOT_POINTER\((?P<decl>.+)\);\s*$')
+
+
+def get_ram_items(c_source):
+    data = []
+    root_pointers = []
+
+    for line in c_source.split('\n'):
+        match = ram_root_pointer_pattern.match(line)
+        if match:
+            root_pointers.append(match.group('decl'))
+            continue
+
+        stripped = line.strip()
+
+        # locals that aren't static are on the stack
+        if line != stripped and not stripped.startswith('static '):
+            continue
+
+        match = ram_data_pattern.match(stripped)
+        if not match:
+            continue
+
+        c_type = match.group('type').strip()
+        if set(c_type.replace('*', ' ').split()) & {'const', 'extern', 'typedef', 'return', 'goto'}:
+            continue
+
+        if '*' in c_type:
+            size = 4
+        else:
+            size = RAM_TYPE_SIZES.get(c_type, None)
+
+        if size is not None and match.group('count'):
+            size *= int(match.group('count'))
+
+        data.append((c_type, match.group('name'), size))
+
+    return data, root_pointers
+
+rom_enum_members = sum(len(enums[enum_name]) for enum_name in enums)
+rom_globals_entries = (
+    len(obj_names) + len(module_funcs) + len([enum_name for enum_name in enums if enum_name not in enum_referenced]) +
+    len([struct_name for struct_name in generated_structs if generated_structs[struct_name]]) +
+    len(struct_aliases) + len(generated_globals) + len(int_constants)
+)
+rom_used_big_ints = [
+    c_name for c_name in rom_big_ints
+    if c_name in int_constants or any(rom_int(c_name) in enums[enum_name].values() for enum_name in enums)
+]
+rom_unevaluated = [c_name for c_name in rom_used_big_ints if rom_big_ints[c_name] is None]
+
+rom_report = [
+    '{0} ROM/RAM report'.format(module_name),
+    '',
+    'ROM (const) tables',
+    '    module globals entries        {0:>6}  ({1} bytes)'.format(rom_globals_entries, rom_globals_entries * 8),
+    '    enum types                    {0:>6}'.format(len(enums)),
+    '    enum members                  {0:>6}  ({1} bytes)'.format(rom_enum_members, rom_enum_members * 8),
+    '    int constants                 {0:>6}'.format(len(int_constants)),
+    '    const int objects             {0:>6}  ({1} bytes max)'.format(len(rom_used_big_ints), len(rom_used_big_ints) * (16 + 8 * 4)),
+]
+
+stdout.flush()
+
+with open(args.output, 'r') as c_file:
+    c_source = c_file.read()
+
+ram_data, ram_root_pointers = get_ram_items(c_source)
+ram_data_bytes = sum(size for _, _, size in ram_data if size is not None)
+ram_unsized = [name for _, name, size in ram_data if size is None]
+
+# the module globals are a const dict, the import only allocates if the
+# module has an __init__ that runs when it gets imported
+ram_import_init = 'MP_QSTR___init__' in c_source
+
+rom_report.extend([
+    '',
+    'RAM',
+    '    static data                   {0:>6}  ({1} bytes{2})'.format(
+        len(ram_data), ram_data_bytes, ', {0} not sized'.format(len(ram_unsized)) if ram_unsized else ''),
+])
+rom_report.extend(
+    '        {0:<30} {1}'.format(name + ' (' + c_type + ')', '?' if size is None else size)
+    for c_type, name, size in ram_data
+)
+rom_report.append('    root pointers                 {0:>6}  ({1} bytes)'.format(len(ram_root_pointers), len(ram_root_pointers) * 4))
+rom_report.extend('        {0}'.format(decl) for decl in ram_root_pointers)
+rom_report.append(
+    '    heap allocated by import      {0:>6}'.format('__init__' if ram_import_init else '0 bytes')
+)
+
+if 'm_new0(lv_global_t' in c_source:
+    rom_report.append('')
+    rom_report.append('lv_global_t is allocated on the heap by mp_lv_init_gc() when LVGL gets initialized, not on import')
+
+if rom_used_big_ints:
+    rom_report.append('')
+    rom_report.append('values that might not fit into a small int:')
+    rom_report.extend('    {0} = {1}'.format(c_name, 'unknown' if rom_big_ints[c_name] is None else hex(rom_big_ints[c_name])) for c_name in rom_used_big_ints)
+
+rom_report_path = os.path.join(os.path.dirname(os.path.abspath(args.output)), 'lv_mp_rom_report.txt')
+generated_files.append(rom_report_path)
+
+with open(rom_report_path, 'w') as report_file:
+    report_file.write('\n'.join(rom_report) + '\n')
+
+eprint('{0}: {1} ROM globals, {2} enum members, {3} const int objects ({4} not evaluated), '
+       '{5} bytes static RAM, {6} root pointers, {7} heap on import'.format(
+           module_name, rom_globals_entries, rom_enum_members, len(rom_used_big_ints), len(rom_unevaluated),
+           ram_data_bytes, len(ram_root_pointers), '__init__' if ram_import_init else '0 bytes'))
+
+
+# Usage report
+#
+# The qstr estimate is the interned string (length + hash + nul) plus the
+# globals/locals dict entry (2 words) for every name that is no longer emitted.
+# It does not include the code of the dropped thunks so the real saving is
+# larger, the firmware map file has the actual numbers.
+
+if lv_usage is not None:
+    dropped_names = set()
+    for category, items in lv_usage_dropped.items():
+        for item in items:
+            dropped_names.add(sanitize(get_enum_name(item) if category in ('enums', 'int_constants') else simplify_identifier(item)))
+
+    qstr_bytes = sum(len(name) + 4 + 8 for name in dropped_names)
+
+    report = ['LVGL binding usage report', '']
+    for category, total in lv_usage_totals.items():
+        dropped = len(lv_usage_dropped[category])
+        report.append('{0:<16} {1:>6} kept {2:>6} dropped'.format(category, total - dropped, dropped))
+
+    report.append('')
+    report.append('estimated qstr/dict bytes saved: %d' % qstr_bytes)
+
+    for category, items in lv_usage_dropped.items():
+        report.append('')
+        report.append('dropped %s:' % category)
+        report.extend('    ' + item for item in items)
+
+    usage_report_path = os.path.join(os.path.dirname(os.path.abspath(args.output)), 'lv_mp_usage_report.txt')
+    generated_files.append(usage_report_path)
+
+    with open(usage_report_path, 'w') as report_file:
+        report_file.write('\n'.join(report) + '\n')
+
+    eprint('\n'.join(report[:len(lv_usage_totals) + 3]))
+
 # Save Metadata File, if specified.
 
 
@@ -3768,5 +4456,9 @@ if args.metadata:
 
     stub_gen.run(args.metadata, api_json_path)
 
+    generated_files.extend([args.metadata, api_json_path, stub_gen.OUPUT_FILE])
+
 stdout.close()
 
+gen_cache.save_files('output', output_key, generated_files)
+
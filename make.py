@@ -174,6 +174,19 @@ argParser.add_argument(
     default=[]
 )
 
+argParser.add_argument(
+    'LV_USAGE',
+    dest='lv_usage',
+    help=(
+        'only generate bindings for the LVGL names the firmware uses. '
+        'Comma separated list of "scan" (scan the frozen Python files), '
+        'paths to Python files to scan, paths to allow list files '
+        '(one name per line) and LVGL names'
+    ),
+    action='store',
+    default=None
+)
+
 argParser.add_argument(
     '--no-scrub',
     dest='no_scrub',
@@ -192,6 +205,7 @@ displays = args2.displays
 indevs = args2.indevs
 expanders = args2.expanders
 imus = args2.imus
+lv_usage = args2.lv_usage
 builder.DO_NOT_SCRUB_BUILD_FOLDER = args2.no_scrub
 
 if imus:
@@ -324,6 +338,8 @@ if __name__ == '__main__':
         indevs, expanders, imus, frozen_manifest
     )
 
+    builder.generate_lv_usage(lv_usage)
+
     create_lvgl_header()
 
     print('Compiling....')
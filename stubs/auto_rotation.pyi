@@ -1,11 +1,14 @@
 # Copyright (c) 2024 - 2025 Kevin G. Schlosser
 
 import lvgl as lv
+import fusion
 import imu_sensor_framework
 
 
 class AutoRotation:
     _device: imu_sensor_framework.IMUSensorFramework
+    _disp: lv.display_t
+    _tracker: fusion.OrientationTracker
     _timer = lv.timer_t
     _lock_rotation: bool
     _last_rotation: int
@@ -14,7 +17,8 @@ class AutoRotation:
 
 
     def __init__(self, device: imu_sensor_framework.IMUSensorFramework,
-                 delay: int, lock_rotation: bool = False, adjustment: float = 0.0):
+                 delay: int, lock_rotation: bool = False, adjustment: float = 0.0,
+                 hysteresis: float = 15.0, dwell: int = 300):
         ...
 
     @property
@@ -36,5 +40,8 @@ class AutoRotation:
     def __del__(self) -> None:
         ...
 
+    def _on_rotation(self, rotation: int) -> None:
+        ...
+
     def _timer_cb(self, _) -> None:
         ...
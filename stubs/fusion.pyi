@@ -15,3 +15,23 @@ class Fusion:
         mag: Tuple[float, float, float] | None = None
     ) -> Tuple[float, float, float]:
         ...
+
+
+class OrientationTracker:
+
+    def __init__(self, *, callback: Callable[[int], None] | None = None,
+                 hysteresis: float = 15.0, dwell: int = 300,
+                 adjustment: float = 0.0, rotation: int = 0):
+        ...
+
+    def update(self, angle: float | Fusion, /) -> int | None:
+        ...
+
+    def set_rotation(self, rotation: int, /) -> None:
+        ...
+
+    def get_rotation(self) -> int:
+        ...
+
+    def set_adjustment(self, adjustment: float, /) -> None:
+        ...
@@ -81,7 +81,7 @@ class Pin(object):
         ...
 
     @classmethod
-    def set_int_pin(cls, pin_num: int, pull: int = -1):
+    def set_int_pin(cls, pin_num: int, pull: int = -1, debounce: int = 0, timer_id: int = 1):
         ...
 
     @classmethod
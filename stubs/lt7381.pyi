@@ -52,7 +52,8 @@ class LT7381(display_driver_framework.DisplayDriver):
         color_space: int = lv.COLOR_FORMAT.RGB888,  # NOQA
         rgb565_byte_swap: bool = False,  # NOQA
         wait_pin=None,
-        wait_state: int = STATE_HIGH
+        wait_state: int = STATE_HIGH,
+        wait_irq: bool = False
     ):
         ...
 
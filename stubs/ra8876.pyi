@@ -47,7 +47,8 @@ class RA8876(display_driver_framework.DisplayDriver):
         color_byte_order: int = BYTE_ORDER_RGB,
         rgb565_byte_swap: bool = False,
         wait_pin=None,
-        wait_state: int = STATE_HIGH
+        wait_state: int = STATE_HIGH,
+        wait_irq: bool = False
     ):
         ...
 